@@ -1,48 +1,114 @@
 #include "fixedincomelib/Date/basics.h"
-#include <regex>
+#include "fixedincomelib/Date/serial.h"
 #include <string>
 #include <string_view>
 
 namespace fixedincomelib {
-    // Regex check to make sure input string format is '%d-%m-%Y' 
-    inline bool is_dd_mm_yyyy(std::string_view s) {
-        // dd-mm-YYYY with leading zeros
-        static const std::regex re(R"(^(0[1-9]|[12]\d|3[01])-(0[1-9]|1[0-2])-(\d{4})$)");
-    
-        // std::regex works on std::string / iterators; easiest is to copy
-        return std::regex_match(std::string(s), re);
-    }
+    namespace {
+        // Every field is scanned as unsigned digit values, anything that isn't '0'-'9' ends up > 9
+        inline unsigned digit(char c) {
+            return static_cast<unsigned>(static_cast<unsigned char>(c)) - '0';
+        }
 
-    // We perform a further check to ensure the day doesnt exceed the number of days of the month
-    void Date::validate_dd_mm_yyyy(std::string_view s) {
-        if (!is_dd_mm_yyyy(s)) {
-            throw std::invalid_argument("Expected date format dd-mm-YYYY");
+        // Branch-free scan of one 10 char record into a QuantLib serial, returns 1 if the record is invalid
+        // Used by the column parsers, where we'd rather compute a throwaway serial than branch per row
+        inline std::size_t scan_record(const char* p, QuantLib::Date::serial_type& out) {
+            const unsigned d0 = digit(p[0]), d1 = digit(p[1]);
+            const unsigned m0 = digit(p[3]), m1 = digit(p[4]);
+            const unsigned y0 = digit(p[6]), y1 = digit(p[7]), y2 = digit(p[8]), y3 = digit(p[9]);
+
+            unsigned bad = (d0 > 9) | (d1 > 9) | (m0 > 9) | (m1 > 9) | (y0 > 9) | (y1 > 9) | (y2 > 9) | (y3 > 9);
+            bad |= (p[2] != '-') | (p[5] != '-');
+
+            const int d = static_cast<int>(d0 * 10 + d1);
+            const int m = static_cast<int>(m0 * 10 + m1);
+            const int y = static_cast<int>(y0 * 1000 + y1 * 100 + y2 * 10 + y3);
+
+            bad |= (m < 1) | (m > 12) | (d < 1);
+            bad |= (y < min_serial_year) | (y > max_serial_year);
+            // Clamp before the month length lookup so garbage rows stay in range, the result is masked anyway
+            const int mm = bad ? 1 : m;
+            bad |= d > days_in_month(y, mm);
+
+            out = bad ? 0 : serial_from_ymd(bad ? min_serial_year : y, mm, bad ? 1 : d);
+            return bad;
+        }
+
+        // Same error messages the regex based check used to throw
+        void throw_if_invalid(DateParseStatus status) {
+            switch (status) {
+                case DateParseStatus::BadFormat:
+                    throw std::invalid_argument("Expected date format dd-mm-YYYY");
+                case DateParseStatus::BadDay:
+                    throw std::invalid_argument("Invalid calendar date (day exceeds month length)");
+                case DateParseStatus::Ok:
+                    break;
+            }
         }
-    
-        int d = std::stoi(std::string(s.substr(0,2)));
-        int m = std::stoi(std::string(s.substr(3,2)));
-        int y = std::stoi(std::string(s.substr(6,4)));
-    
-        // Basic month/day bounds already enforced by regex, now check real calendar.
-        auto is_leap = [](int yy){
-            return (yy % 4 == 0 && yy % 100 != 0) || (yy % 400 == 0);
+    }
+
+    // Check the input string format is '%d-%m-%Y' and pull out the fields in a single pass
+    // This used to be a std::regex_match on a copied std::string followed by std::stoi on each field
+    DateParseStatus scan_dd_mm_yyyy(std::string_view s, int& d, int& m, int& y) noexcept {
+        // dd-mm-YYYY with leading zeros, so exactly 10 chars with dashes at 2 and 5
+        if (s.size() != 10 || s[2] != '-' || s[5] != '-')
+            return DateParseStatus::BadFormat;
+
+        const unsigned fields[8] = {
+            digit(s[0]), digit(s[1]), digit(s[3]), digit(s[4]),
+            digit(s[6]), digit(s[7]), digit(s[8]), digit(s[9])
         };
-        int mdays[] = {0,31,28,31,30,31,30,31,31,30,31,30,31};
-        if (m == 2 && is_leap(y)) mdays[2] = 29;
-    
-        if (d > mdays[m]) {
-            throw std::invalid_argument("Invalid calendar date (day exceeds month length)");
+        for (unsigned f : fields)
+            if (f > 9) return DateParseStatus::BadFormat;
+
+        d = static_cast<int>(fields[0] * 10 + fields[1]);
+        m = static_cast<int>(fields[2] * 10 + fields[3]);
+        y = static_cast<int>(fields[4] * 1000 + fields[5] * 100 + fields[6] * 10 + fields[7]);
+
+        // Same bounds the regex enforced: day 01-31 and month 01-12
+        if (d < 1 || d > 31 || m < 1 || m > 12)
+            return DateParseStatus::BadFormat;
+
+        // We perform a further check to ensure the day doesnt exceed the number of days of the month
+        if (d > days_in_month(y, m))
+            return DateParseStatus::BadDay;
+
+        return DateParseStatus::Ok;
+    }
+
+    std::size_t parse_date_column(std::span<const std::string_view> in,
+                                  std::span<QuantLib::Date::serial_type> out) noexcept {
+        std::size_t invalid = 0;
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            // Anything that isn't exactly 10 chars can't be a date, scan a dummy record so the loop body is uniform
+            static constexpr char dummy[10] = {'x'};
+            const bool sized = in[i].size() == 10;
+            invalid += scan_record(sized ? in[i].data() : dummy, out[i]);
         }
+        return invalid;
     }
+
+    std::size_t parse_date_column(const char* data,
+                                  std::size_t n,
+                                  std::size_t stride,
+                                  std::span<QuantLib::Date::serial_type> out) noexcept {
+        std::size_t invalid = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            invalid += scan_record(data + i * stride, out[i]);
+        return invalid;
+    }
+
+    void Date::validate_dd_mm_yyyy(std::string_view s) {
+        int d = 0, m = 0, y = 0;
+        throw_if_invalid(scan_dd_mm_yyyy(s, d, m, y));
+    }
+
     QuantLib::Date Date::date_from_iso(std::string_view iso) {
         // In c++ of Quantlib, we need to give the day, month then year to the Date constructor 
-        // We only allow the DD-MM-YYYY format for now 
-        validate_dd_mm_yyyy(iso); 
+        // We only allow the DD-MM-YYYY format for now, the scan validates and extracts the fields in one go
+        int d = 0, m = 0, y = 0;
+        throw_if_invalid(scan_dd_mm_yyyy(iso, d, m, y));
 
-        int d = std::stoi(std::string(iso.substr(0,2)));
-        int m = std::stoi(std::string(iso.substr(3,2)));
-        int y = std::stoi(std::string(iso.substr(6,4)));
-        
         return QuantLib::Date(d, QuantLib::Month(m), y); // Month is a strongly typed enum hence the need to do this
     }
 
@@ -4,15 +4,40 @@
 #include <ql/time/period.hpp>
 #include <ql/utilities/dataparsers.hpp>
 
+#include "fixedincomelib/Date/format.h"
+
 #include <variant>
-#include <sstream>   // std::ostringstream
-#include <iomanip>   // std::setw, std::setfill
+#include <span>
 #include <string>
 #include <string_view>
 #include <stdexcept>
 #include <cctype>
 
 namespace fixedincomelib {
+    // Outcome of scanning a 'DD-MM-YYYY' string, split so callers can report the same errors the regex check did
+    enum class DateParseStatus {
+        Ok,
+        BadFormat, // not dd-mm-YYYY with leading zeros, day in 01-31, month in 01-12
+        BadDay     // well formed but the day exceeds the length of the month
+    };
+
+    // Hand-written replacement for the old regex check: no allocation, no exceptions, one pass over 10 chars
+    DateParseStatus scan_dd_mm_yyyy(std::string_view s, int& d, int& m, int& y) noexcept;
+
+    // Bulk parse of a column of 'DD-MM-YYYY' strings into QuantLib serial numbers
+    // Invalid rows (bad format, bad day, or year outside QuantLib's 1901-2199 range) are written as 0, which is the
+    // serial of QuantLib's null Date, and the number of invalid rows is returned. out must be at least in.size() long.
+    std::size_t parse_date_column(std::span<const std::string_view> in,
+                                  std::span<QuantLib::Date::serial_type> out) noexcept;
+
+    // Same as above for fixed-width records, e.g. a CSV column or a memory-mapped file
+    // Record i starts at data + i * stride and its first 10 chars are the date, so stride is 10 for a packed buffer
+    // and 11 for newline/comma separated dates. The loop is branch-free so the compiler can vectorize it.
+    std::size_t parse_date_column(const char* data,
+                                  std::size_t n,
+                                  std::size_t stride,
+                                  std::span<QuantLib::Date::serial_type> out) noexcept;
+
     // Extension of Quantlib's date class 
     class Date { 
         public: 
@@ -31,12 +56,10 @@ namespace fixedincomelib {
 
             //Accesor
             QuantLib::Date get_date() const {return d_;}
+            // 'DD-MM-YYYY', formatted into a stack buffer (Date/format.h) rather than through a stream
             std::string get_date_str() const {
-                std::ostringstream oss;
-                oss << std::setw(2) << std::setfill('0') << d_.dayOfMonth() << "-"
-                    << std::setw(2) << std::setfill('0') << static_cast<int>(d_.month()) << "-"
-                    << d_.year();
-                return oss.str();
+                char buf[dd_mm_yyyy_size];
+                return std::string(buf, format_dd_mm_yyyy(d_, buf));
             }
         private: 
             QuantLib::Date d_;
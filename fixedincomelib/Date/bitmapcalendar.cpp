@@ -0,0 +1,231 @@
+#include "fixedincomelib/Date/bitmapcalendar.h"
+
+#include <ql/shared_ptr.hpp>
+#include <ql/time/calendars/jointcalendar.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+
+    // QuantLib::Calendar whose rule evaluation is a lookup in a BitmapCalendar's bitset
+    // Calendar::Impl is protected in QuantLib, so the impl has to be nested in a class deriving from Calendar
+    class BitmapBackedCalendar : public QuantLib::Calendar {
+        private:
+            class Impl : public QuantLib::Calendar::Impl {
+                public:
+                    explicit Impl(std::shared_ptr<const BitmapCalendar::Data> data): data_(std::move(data)) {}
+
+                    std::string name() const override { return data_->source.name(); }
+
+                    bool isBusinessDay(const QuantLib::Date& d) const override {
+                        const serial_type s = d.serialNumber();
+                        if (s < data_->first || s > data_->last)
+                            return data_->source.isBusinessDay(d);
+                        const auto i = static_cast<std::size_t>(s - data_->first);
+                        return (data_->bits[i >> 6] >> (i & 63)) & 1;
+                    }
+
+                    bool isWeekend(QuantLib::Weekday w) const override { return data_->source.isWeekend(w); }
+
+                private:
+                    std::shared_ptr<const BitmapCalendar::Data> data_;
+            };
+
+        public:
+            explicit BitmapBackedCalendar(std::shared_ptr<const BitmapCalendar::Data> data) {
+                // impl_ is a QuantLib::ext::shared_ptr, which is boost's unless QuantLib is built to use std's
+                impl_ = QuantLib::ext::make_shared<Impl>(std::move(data));
+            }
+    };
+
+    void BitmapCalendar::Data::index() {
+        ranks.assign(bits.size() + 1, 0);
+        business_days.clear();
+        for (std::size_t w = 0; w < bits.size(); ++w) {
+            ranks[w + 1] = ranks[w] + std::popcount(bits[w]);
+            // Walk the set bits of the word, lowest first
+            for (std::uint64_t word = bits[w]; word != 0; word &= word - 1) {
+                const auto offset = static_cast<serial_type>(w * 64) + std::countr_zero(word);
+                business_days.push_back(static_cast<std::int32_t>(first + offset));
+            }
+        }
+    }
+
+    BitmapCalendar::BitmapCalendar(const QuantLib::Calendar& cal,
+                                   const QuantLib::Date& first,
+                                   const QuantLib::Date& last) {
+        if (last < first)
+            throw std::invalid_argument("BitmapCalendar: last date is before first date");
+
+        auto data = std::make_shared<Data>();
+        data->first = first.serialNumber();
+        data->last = last.serialNumber();
+        data->source = cal;
+
+        // This is the only place the (virtual) holiday rules get evaluated
+        const auto n = static_cast<std::size_t>(data->last - data->first + 1);
+        data->bits.assign(n / 64 + 1, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (cal.isBusinessDay(QuantLib::Date(data->first + static_cast<serial_type>(i))))
+                data->bits[i >> 6] |= std::uint64_t(1) << (i & 63);
+        }
+        data->index();
+
+        data_ = std::move(data);
+        calendar_ = BitmapBackedCalendar(data_);
+    }
+
+    BitmapCalendar::BitmapCalendar(std::shared_ptr<const Data> data)
+        : data_(std::move(data)), calendar_(BitmapBackedCalendar(data_)) {}
+
+    BitmapCalendar BitmapCalendar::join(const BitmapCalendar& a, const BitmapCalendar& b, bool business_days_in_both) {
+        if (a.data_->first != b.data_->first || a.data_->last != b.data_->last)
+            throw std::invalid_argument("BitmapCalendar: joined calendars must cover the same date range");
+
+        auto data = std::make_shared<Data>();
+        data->first = a.data_->first;
+        data->last = a.data_->last;
+        data->bits.resize(a.data_->bits.size());
+        for (std::size_t w = 0; w < data->bits.size(); ++w)
+            data->bits[w] = business_days_in_both ? (a.data_->bits[w] & b.data_->bits[w])
+                                                  : (a.data_->bits[w] | b.data_->bits[w]);
+        // Outside the range we still need the equivalent QuantLib joint calendar
+        data->source = QuantLib::JointCalendar(a.data_->source, b.data_->source,
+                                               business_days_in_both ? QuantLib::JointCalendarRule::JoinHolidays
+                                                                     : QuantLib::JointCalendarRule::JoinBusinessDays);
+        data->index();
+        return BitmapCalendar(std::move(data));
+    }
+
+    BitmapCalendar BitmapCalendar::join_holidays(const BitmapCalendar& a, const BitmapCalendar& b) {
+        return join(a, b, true);
+    }
+
+    BitmapCalendar BitmapCalendar::join_business_days(const BitmapCalendar& a, const BitmapCalendar& b) {
+        return join(a, b, false);
+    }
+
+    serial_type BitmapCalendar::following(serial_type s) const {
+        if (!covers(s)) return 0;
+        const serial_type k = rank(s);
+        return k < business_day_count() ? select(k) : 0;
+    }
+
+    serial_type BitmapCalendar::preceding(serial_type s) const {
+        if (!covers(s)) return 0;
+        const serial_type k = rank(s + 1);
+        return k > 0 ? select(k - 1) : 0;
+    }
+
+    bool BitmapCalendar::is_business_day(const QuantLib::Date& d) const {
+        const serial_type s = d.serialNumber();
+        if (!covers(s)) return data_->source.isBusinessDay(d);
+        const auto i = static_cast<std::size_t>(s - data_->first);
+        return (data_->bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    // Mirrors QuantLib::Calendar::adjust, with the day-by-day walks replaced by rank/select
+    QuantLib::Date BitmapCalendar::adjust(const QuantLib::Date& d, QuantLib::BusinessDayConvention c) const {
+        if (c == QuantLib::Unadjusted)
+            return d;
+
+        const serial_type s = d.serialNumber();
+        switch (c) {
+            case QuantLib::Following:
+            case QuantLib::ModifiedFollowing:
+            case QuantLib::HalfMonthModifiedFollowing: {
+                const serial_type f = following(s);
+                if (f == 0) break;
+                const QuantLib::Date d1(f);
+                if (c == QuantLib::Following)
+                    return d1;
+                if (d1.month() != d.month() ||
+                    (c == QuantLib::HalfMonthModifiedFollowing && d.dayOfMonth() <= 15 && d1.dayOfMonth() > 15)) {
+                    const serial_type p = preceding(s);
+                    if (p == 0) break;
+                    return QuantLib::Date(p);
+                }
+                return d1;
+            }
+            case QuantLib::Preceding:
+            case QuantLib::ModifiedPreceding: {
+                const serial_type p = preceding(s);
+                if (p == 0) break;
+                const QuantLib::Date d1(p);
+                if (c == QuantLib::ModifiedPreceding && d1.month() != d.month()) {
+                    const serial_type f = following(s);
+                    if (f == 0) break;
+                    return QuantLib::Date(f);
+                }
+                return d1;
+            }
+            case QuantLib::Nearest: {
+                // QuantLib walks both ways at once and prefers the later date on a tie
+                const serial_type f = following(s), p = preceding(s);
+                if (f == 0 || p == 0) break;
+                return QuantLib::Date(f - s <= s - p ? f : p);
+            }
+            default:
+                break;
+        }
+        // Outside the bitmap (or an unknown convention), let QuantLib do it
+        return data_->source.adjust(d, c);
+    }
+
+    // Mirrors QuantLib::Calendar::advance
+    QuantLib::Date BitmapCalendar::advance(const QuantLib::Date& d,
+                                           QuantLib::Integer n,
+                                           QuantLib::TimeUnit unit,
+                                           QuantLib::BusinessDayConvention c,
+                                           bool end_of_month) const {
+        if (n == 0)
+            return adjust(d, c);
+
+        const serial_type s = d.serialNumber();
+        if (unit == QuantLib::Days) {
+            // The n-th business day strictly after (or before) d, the start date itself is not adjusted
+            if (covers(s)) {
+                const serial_type k = n > 0 ? rank(s + 1) + n - 1 : rank(s) + n;
+                if (k >= 0 && k < business_day_count())
+                    return QuantLib::Date(select(k));
+            }
+        } else if (unit == QuantLib::Weeks) {
+            return adjust(d + QuantLib::Period(n, unit), c);
+        } else if (unit == QuantLib::Months || unit == QuantLib::Years) {
+            const QuantLib::Date d1 = d + QuantLib::Period(n, unit);
+            if (end_of_month) {
+                if (c == QuantLib::Unadjusted && QuantLib::Date::isEndOfMonth(d))
+                    return QuantLib::Date::endOfMonth(d1);
+                if (is_end_of_month(d))
+                    return this->end_of_month(d1);
+            }
+            return adjust(d1, c);
+        }
+        return data_->source.advance(d, n, unit, c, end_of_month);
+    }
+
+    QuantLib::Date BitmapCalendar::advance(const QuantLib::Date& d,
+                                           const QuantLib::Period& p,
+                                           QuantLib::BusinessDayConvention c,
+                                           bool end_of_month) const {
+        return advance(d, p.length(), p.units(), c, end_of_month);
+    }
+
+    bool BitmapCalendar::is_end_of_month(const QuantLib::Date& d) const {
+        return d.month() != adjust(d + 1).month();
+    }
+
+    QuantLib::Date BitmapCalendar::end_of_month(const QuantLib::Date& d) const {
+        return adjust(QuantLib::Date::endOfMonth(d), QuantLib::Preceding);
+    }
+
+    serial_type BitmapCalendar::business_days_between(const QuantLib::Date& from, const QuantLib::Date& to) const {
+        const serial_type a = from.serialNumber(), b = to.serialNumber();
+        // rank is defined up to last + 1, so both ends must be within [first, last + 1]
+        if (a >= data_->first && b >= data_->first && a <= data_->last + 1 && b <= data_->last + 1)
+            return rank(b) - rank(a);
+        return a <= b ? data_->source.businessDaysBetween(from, to)
+                      : -data_->source.businessDaysBetween(to, from);
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+
+#include <ql/time/calendar.hpp>
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+#include <ql/time/businessdayconvention.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fixedincomelib {
+
+    class BitmapBackedCalendar;
+
+    // Precomputed form of a QuantLib calendar over a fixed serial range
+    // QuantLib evaluates holiday rules through a virtual call every time it asks whether a day is a business day, and
+    // adjust/advance walk one day at a time. Here we evaluate the rules once per day up front and keep
+    //   - a dense bitset with one bit per day (set = business day)
+    //   - the number of business days before each 64-bit word (rank)
+    //   - the serial of every business day in order (select)
+    // so a business day check is one bit test, and Following/Preceding/"advance n business days" are a rank followed
+    // by a select, each constant time. Dates outside the range fall back to the QuantLib calendar it was built from.
+    //
+    // The bitmap is a snapshot: holidays added to the source calendar afterwards are not seen, rebuild it instead
+    // (ConventionRegistry::add_holiday does that for the registry's bitmap calendars).
+    class BitmapCalendar {
+        public:
+            // Covers 01-01-1950 to 31-12-2150 unless told otherwise, about 220KB per calendar (mostly the select table)
+            explicit BitmapCalendar(const QuantLib::Calendar& cal,
+                                    const QuantLib::Date& first = QuantLib::Date(1, QuantLib::January, 1950),
+                                    const QuantLib::Date& last = QuantLib::Date(31, QuantLib::December, 2150));
+
+            // Joint calendars straight from the bitmaps, both inputs must cover the same range
+            // join_holidays: business day only if it is one in both (AND), like JointCalendarRule::JoinHolidays
+            // join_business_days: business day if it is one in either (OR), like JointCalendarRule::JoinBusinessDays
+            static BitmapCalendar join_holidays(const BitmapCalendar& a, const BitmapCalendar& b);
+            static BitmapCalendar join_business_days(const BitmapCalendar& a, const BitmapCalendar& b);
+
+            // Range covered by the bitmap (inclusive)
+            QuantLib::Date first() const { return QuantLib::Date(data_->first); }
+            QuantLib::Date last() const { return QuantLib::Date(data_->last); }
+            bool covers(serial_type s) const { return s >= data_->first && s <= data_->last; }
+
+            // Same semantics as the QuantLib::Calendar member functions of the same name
+            bool is_business_day(const QuantLib::Date& d) const;
+            bool is_holiday(const QuantLib::Date& d) const { return !is_business_day(d); }
+            bool is_end_of_month(const QuantLib::Date& d) const;
+            QuantLib::Date end_of_month(const QuantLib::Date& d) const;
+            QuantLib::Date adjust(const QuantLib::Date& d,
+                                  QuantLib::BusinessDayConvention c = QuantLib::Following) const;
+            QuantLib::Date advance(const QuantLib::Date& d,
+                                   QuantLib::Integer n,
+                                   QuantLib::TimeUnit unit,
+                                   QuantLib::BusinessDayConvention c = QuantLib::Following,
+                                   bool end_of_month = false) const;
+            QuantLib::Date advance(const QuantLib::Date& d,
+                                   const QuantLib::Period& p,
+                                   QuantLib::BusinessDayConvention c = QuantLib::Following,
+                                   bool end_of_month = false) const;
+
+            // Number of business days in [from, to), negative if to < from
+            serial_type business_days_between(const QuantLib::Date& from, const QuantLib::Date& to) const;
+
+            // Rank/select on serials, both require covers(s) (or s == last + 1 for rank)
+            // rank(s): number of business days in [first, s)
+            // select(k): serial of the k-th business day (0 based), k < business_day_count()
+            serial_type rank(serial_type s) const {
+                const auto i = static_cast<std::size_t>(s - data_->first);
+                const std::uint64_t below = data_->bits[i >> 6] & ((std::uint64_t(1) << (i & 63)) - 1);
+                return data_->ranks[i >> 6] + static_cast<serial_type>(std::popcount(below));
+            }
+            serial_type select(serial_type k) const { return data_->business_days[static_cast<std::size_t>(k)]; }
+            serial_type business_day_count() const { return static_cast<serial_type>(data_->business_days.size()); }
+
+            // Drop-in QuantLib::Calendar whose isBusinessDay is a bit test, e.g. for make_schedule or QuantLib::Schedule
+            // It has the same name as the source calendar, so it compares equal to it
+            const QuantLib::Calendar& calendar() const { return calendar_; }
+
+            // The calendar the bitmap was built from, used outside the covered range
+            const QuantLib::Calendar& source() const { return data_->source; }
+
+        private:
+            friend class BitmapBackedCalendar;
+
+            struct Data {
+                serial_type first = 0;
+                serial_type last = 0;
+                std::vector<std::uint64_t> bits;          // one extra zero word so rank(last + 1) never reads past the end
+                std::vector<std::int32_t> ranks;          // business days before word w
+                std::vector<std::int32_t> business_days;  // select table, serials fit in 32 bits
+                QuantLib::Calendar source;
+
+                // Fills ranks and business_days from bits
+                void index();
+            };
+
+            explicit BitmapCalendar(std::shared_ptr<const Data> data);
+            static BitmapCalendar join(const BitmapCalendar& a, const BitmapCalendar& b, bool business_days_in_both);
+
+            // Next business day on or after s / last business day on or before s, outside the bitmap return 0
+            serial_type following(serial_type s) const;
+            serial_type preceding(serial_type s) const;
+
+            std::shared_ptr<const Data> data_;  // shared with the QuantLib::Calendar impl below, so copies are cheap
+            QuantLib::Calendar calendar_;
+    };
+
+}
@@ -0,0 +1,41 @@
+#include "fixedincomelib/Date/business252.h"
+
+#include <ql/shared_ptr.hpp>
+#include <ql/time/calendars/brazil.hpp>
+#include <ql/time/daycounters/business252.hpp>
+
+#include <string>
+
+namespace fixedincomelib {
+
+    // DayCounter::Impl is protected in QuantLib, so the impl is nested in the class deriving from DayCounter
+    class BitmapBusiness252::Impl : public QuantLib::DayCounter::Impl {
+        public:
+            explicit Impl(const BitmapCalendar& cal)
+                : cal_(cal), name_(QuantLib::Business252(cal.source()).name()) {}
+
+            std::string name() const override { return name_; }
+
+            QuantLib::Date::serial_type dayCount(const QuantLib::Date& d1, const QuantLib::Date& d2) const override {
+                return cal_.business_days_between(d1, d2);
+            }
+
+            QuantLib::Time yearFraction(const QuantLib::Date& d1, const QuantLib::Date& d2,
+                                        const QuantLib::Date&, const QuantLib::Date&) const override {
+                return dayCount(d1, d2) / 252.0;
+            }
+
+        private:
+            BitmapCalendar cal_;
+            std::string name_;
+    };
+
+    BitmapBusiness252::BitmapBusiness252(const BitmapCalendar& cal)
+        : QuantLib::DayCounter(QuantLib::ext::make_shared<Impl>(cal)) {}
+
+    BitmapBusiness252::BitmapBusiness252(const QuantLib::Calendar& cal)
+        : BitmapBusiness252(BitmapCalendar(cal)) {}
+
+    BitmapBusiness252::BitmapBusiness252()
+        : BitmapBusiness252(QuantLib::Brazil()) {}
+}
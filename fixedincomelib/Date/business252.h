@@ -0,0 +1,30 @@
+#pragma once
+
+#include "fixedincomelib/Date/bitmapcalendar.h"
+
+#include <ql/time/calendar.hpp>
+#include <ql/time/daycounter.hpp>
+
+namespace fixedincomelib {
+
+    // Business/252 on a BitmapCalendar
+    // QuantLib's Business252 counts business days by walking the calendar, so every accrual costs O(days in period).
+    // Here the count is rank(d2) - rank(d1) on the bitmap's cumulative business-day counts, two lookups whatever the
+    // period length. Day counts and year fractions are the same as QuantLib's (business days in [d1, d2), negated
+    // when d2 < d1, over 252.0), and so is name(), so it compares equal to QuantLib::Business252 on the same calendar.
+    //
+    // Dates outside the bitmap's range are counted on the source calendar, as BitmapCalendar does.
+    class BitmapBusiness252 : public QuantLib::DayCounter {
+        public:
+            explicit BitmapBusiness252(const BitmapCalendar& cal);
+
+            // Builds the bitmap, so construct once and copy (copies share the bitmap)
+            // Defaults to Brazil like QuantLib::Business252
+            explicit BitmapBusiness252(const QuantLib::Calendar& cal);
+            BitmapBusiness252();
+
+        private:
+            class Impl;
+    };
+
+}
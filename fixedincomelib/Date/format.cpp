@@ -0,0 +1,84 @@
+#include "fixedincomelib/Date/format.h"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace fixedincomelib {
+    namespace {
+        // "00" .. "99", so each two-digit field is one copy
+        constexpr char digit_pairs[201] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        inline char* put2(int v, char* out) {
+            std::memcpy(out, digit_pairs + 2 * v, 2);
+            return out + 2;
+        }
+
+        constexpr const char* month_names[12] = {
+            "January", "February", "March", "April", "May", "June",
+            "July", "August", "September", "October", "November", "December"
+        };
+
+        inline char* put(const char* s, char* out) {
+            const std::size_t n = std::strlen(s);
+            std::memcpy(out, s, n);
+            return out + n;
+        }
+    }
+
+    char* format_dd_mm_yyyy(serial_type s, char* out) {
+        int y = 0, m = 0, d = 0;
+        ymd_from_serial(s, y, m, d);
+        out = put2(d, out);
+        *out++ = '-';
+        out = put2(m, out);
+        *out++ = '-';
+        out = put2(y / 100, out);
+        return put2(y % 100, out);
+    }
+
+    char* format_long_date(const QuantLib::Date& d, char* out) {
+        if (d == QuantLib::Date())
+            return put("null date", out);
+
+        int y = 0, m = 0, dd = 0;
+        ymd_from_serial(d.serialNumber(), y, m, dd);
+        out = put(month_names[m - 1], out);
+        *out++ = ' ';
+
+        // Ordinal day as QuantLib::io::ordinal prints it: 1st 2nd 3rd 4th ... 11th 12th 13th ... 21st 22nd 23rd ...
+        if (dd >= 10) *out++ = static_cast<char>('0' + dd / 10);
+        *out++ = static_cast<char>('0' + dd % 10);
+        const char* suffix = "th";
+        if (dd / 10 != 1) {
+            if (dd % 10 == 1) suffix = "st";
+            else if (dd % 10 == 2) suffix = "nd";
+            else if (dd % 10 == 3) suffix = "rd";
+        }
+        out = put(suffix, out);
+
+        *out++ = ',';
+        *out++ = ' ';
+        out = put2(y / 100, out);
+        return put2(y % 100, out);
+    }
+
+    char* format_double(double x, int precision, char* out, char* out_end) {
+        const std::to_chars_result res = precision < 0
+            ? std::to_chars(out, out_end, x)
+            : std::to_chars(out, out_end, x, std::chars_format::fixed, precision);
+        if (res.ec != std::errc())
+            throw std::length_error("format_double: output buffer too small");
+        return res.ptr;
+    }
+}
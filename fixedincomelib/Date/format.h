@@ -0,0 +1,31 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+
+#include <ql/time/date.hpp>
+
+#include <cstddef>
+
+// Allocation-free formatting of dates and numbers into caller buffers
+// Replaces the std::ostringstream per value we used to build; every function writes from `out` and returns one past
+// the last char written, so calls can be chained into a single buffer.
+
+namespace fixedincomelib {
+
+    // 'DD-MM-YYYY', always 10 chars
+    inline constexpr std::size_t dd_mm_yyyy_size = 10;
+    char* format_dd_mm_yyyy(serial_type s, char* out);
+    inline char* format_dd_mm_yyyy(const QuantLib::Date& d, char* out) { return format_dd_mm_yyyy(d.serialNumber(), out); }
+
+    // QuantLib::io::long_date style, e.g. 'January 31st, 2025' (or 'null date'), at most long_date_max_size chars
+    inline constexpr std::size_t long_date_max_size = 20;
+    char* format_long_date(const QuantLib::Date& d, char* out);
+
+    // Fixed notation with `precision` decimals, same digits as std::fixed << std::setprecision(precision)
+    // A negative precision gives the shortest representation that reads back to the same double
+    // format_double_max_size chars are enough for any double with precision <= 17, throws std::length_error if
+    // [out, out_end) is too small
+    inline constexpr std::size_t format_double_max_size = 328;
+    char* format_double(double x, int precision, char* out, char* out_end);
+
+}
@@ -0,0 +1,197 @@
+#include "fixedincomelib/Date/schedulebook.h"
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/market/registry.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace fixedincomelib {
+    namespace {
+        // QuantLib's date range
+        constexpr int min_year = 1901, max_year = 2199;
+
+        // One FNV-1a step per day of the year, so changing any single day always changes the hash
+        std::vector<std::uint64_t> fingerprint(const QuantLib::Calendar& calendar, int first, int last) {
+            std::vector<std::uint64_t> years;
+            years.reserve(static_cast<std::size_t>(last - first + 1));
+            for (int y = first; y <= last; ++y) {
+                std::uint64_t h = 14695981039346656037ULL;
+                const serial_type end = QuantLib::Date(31, QuantLib::December, y).serialNumber();
+                for (serial_type d = QuantLib::Date(1, QuantLib::January, y).serialNumber(); d <= end; ++d)
+                    h = (h ^ (calendar.isBusinessDay(QuantLib::Date(d)) ? 1u : 0u)) * 1099511628211ULL;
+                years.push_back(h);
+            }
+            return years;
+        }
+
+        std::size_t leading_paid(const std::vector<ScheduleRow>& rows, serial_type as_of) {
+            std::size_t n = 0;
+            while (n < rows.size() && rows[n].paymentDate.serialNumber() <= as_of) ++n;
+            return n;
+        }
+
+        std::size_t leading_fixed(const std::vector<ScheduleRow>& rows, std::size_t from, serial_type as_of) {
+            while (from < rows.size() && rows[from].fixingDate.serialNumber() <= as_of) ++from;
+            return from;
+        }
+
+        bool same_rows(const std::vector<ScheduleRow>& a, const std::vector<ScheduleRow>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const ScheduleRow& x, const ScheduleRow& y) {
+                return x.startDate == y.startDate && x.endDate == y.endDate && x.fixingDate == y.fixingDate &&
+                       x.paymentDate == y.paymentDate && x.accrued == y.accrued;
+            });
+        }
+    }
+
+    std::vector<ScheduleRow> ScheduleBook::generate(const ScheduleSpec& s) const {
+        ConventionRegistry& c = conventions();
+        return make_schedule(s.start_date, s.end_date, s.accrual_period, c.calendar(s.holiday_convention),
+                             c.bdc(s.business_day_convention), c.day_counter(s.accrual_basis), s.rule, s.end_of_month,
+                             s.fix_in_arrear, s.fixing_offset, s.payment_offset,
+                             c.bdc(s.payment_business_day_convention), c.calendar(s.payment_holiday_convention));
+    }
+
+    bool ScheduleBook::upsert(const std::string& trade_id, const ScheduleSpec& spec) {
+        ConventionRegistry& c = conventions();
+        const QuantLib::Calendar& calendar = c.calendar(spec.holiday_convention);
+        const QuantLib::Calendar& payment_calendar = c.calendar(spec.payment_holiday_convention);
+        const ScheduleKey key = ScheduleKey::make(
+            spec.start_date, spec.end_date, spec.accrual_period, calendar, c.bdc(spec.business_day_convention),
+            c.day_counter(spec.accrual_basis), spec.rule, spec.end_of_month, spec.fix_in_arrear, spec.fixing_offset,
+            spec.payment_offset, c.bdc(spec.payment_business_day_convention), payment_calendar);
+
+        auto it = index_.find(trade_id);
+        if (it != index_.end() && trades_[it->second].key == key) {
+            // Same schedule, maybe spelt differently
+            trades_[it->second].trade.spec = spec;
+            return false;
+        }
+
+        // Fixing offsets reach back before the start and adjustments and payment offsets past the end
+        const int first = std::max(min_year, spec.start_date.get_date().year() - 1);
+        const int last = std::min(max_year, spec.end_date.get_date().year() + 1);
+        first_year_ = first_year_ == 0 ? first : std::min(first_year_, first);
+        last_year_ = std::max(last_year_, last);
+        calendars_.try_emplace(key.calendar).first->second.calendar = calendar;
+        if (key.payment_length != 0)
+            calendars_.try_emplace(key.payment_calendar).first->second.calendar = payment_calendar;
+
+        if (it == index_.end()) {
+            it = index_.emplace(trade_id, trades_.size()).first;
+            trades_.emplace_back();
+            trades_.back().trade.id = trade_id;
+        }
+        Entry& e = trades_[it->second];
+        e.trade.spec = spec;
+        e.key = key;
+        if (e.pending != Pending::Added) e.pending = Pending::TermsChanged;
+        e.first_year = first;
+        e.last_year = last;
+        return true;
+    }
+
+    bool ScheduleBook::remove(const std::string& trade_id) {
+        const auto it = index_.find(trade_id);
+        if (it == index_.end()) return false;
+        const std::size_t i = it->second;
+        // Nothing downstream has seen a trade that was never rolled
+        if (trades_[i].pending != Pending::Added) removed_.push_back(trade_id);
+        index_.erase(it);
+        if (i + 1 != trades_.size()) {
+            trades_[i] = std::move(trades_.back());
+            index_[trades_[i].trade.id] = i;
+        }
+        trades_.pop_back();
+        return true;
+    }
+
+    const ScheduleBook::Trade& ScheduleBook::trade(const std::string& trade_id) const {
+        const auto it = index_.find(trade_id);
+        if (it == index_.end()) throw std::out_of_range("ScheduleBook: no trade " + trade_id);
+        return trades_[it->second].trade;
+    }
+
+    bool ScheduleBook::calendar_changed(const std::string& name, const Entry& e) const {
+        const CalendarState& state = calendars_.at(name);
+        for (int y : state.changed)
+            if (y >= e.first_year && y <= e.last_year) return true;
+        return false;
+    }
+
+    ScheduleBookChanges ScheduleBook::roll(const QuantLib::Date& as_of) {
+        if (rolled_ && as_of < as_of_)
+            throw std::invalid_argument("ScheduleBook::roll: " + Date(as_of).get_date_str() +
+                                        " is before the last as-of date " + Date(as_of_).get_date_str());
+        ScheduleBookChanges out;
+        out.as_of = as_of;
+
+        // Refingerprint the calendars over the book's years. Years that weren't covered last time can only hold
+        // trades added since, which are regenerated anyway.
+        for (auto& [name, state] : calendars_) {
+            std::vector<std::uint64_t> years = fingerprint(state.calendar, first_year_, last_year_);
+            state.changed.clear();
+            const int last_seen = state.first_year + static_cast<int>(state.years.size()) - 1;
+            for (int y = std::max(first_year_, state.first_year); y <= std::min(last_year_, last_seen); ++y)
+                if (years[y - first_year_] != state.years[y - state.first_year]) state.changed.push_back(y);
+            state.first_year = first_year_;
+            state.years = std::move(years);
+            if (!state.changed.empty()) out.calendars.push_back(name);
+        }
+        std::sort(out.calendars.begin(), out.calendars.end());
+
+        std::sort(removed_.begin(), removed_.end());
+        for (std::string& id : removed_)
+            out.trades.push_back(ScheduleChange{std::move(id), ScheduleChange::Kind::Removed});
+        removed_.clear();
+        const std::size_t first_trade = out.trades.size();
+
+        const serial_type today = as_of.serialNumber();
+        for (Entry& e : trades_) {
+            Trade& t = e.trade;
+            ScheduleChange change{t.id};
+
+            // Roll the held rows first: anything due by today is either paid or fixed
+            if (e.pending != Pending::Added && e.next_event <= today) {
+                const std::size_t paid = leading_paid(t.rows, today);
+                const std::size_t still_fixed = t.fixed - std::min(t.fixed, paid);
+                t.rows.erase(t.rows.begin(), t.rows.begin() + static_cast<std::ptrdiff_t>(paid));
+                t.fixed = leading_fixed(t.rows, still_fixed, today);
+                change.paid = paid;
+                change.newly_fixed = t.fixed - still_fixed;
+            }
+
+            const bool calendar = calendar_changed(e.key.calendar, e) ||
+                                  (e.key.payment_length != 0 && calendar_changed(e.key.payment_calendar, e));
+            if (e.pending != Pending::None || calendar) {
+                ++out.regenerated;
+                std::vector<ScheduleRow> rows = generate(t.spec);
+                rows.erase(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(leading_paid(rows, today)));
+                if (e.pending == Pending::Added || !same_rows(rows, t.rows)) {
+                    change.kind = e.pending == Pending::Added          ? ScheduleChange::Kind::Added
+                                  : e.pending == Pending::TermsChanged ? ScheduleChange::Kind::TermsChanged
+                                                                       : ScheduleChange::Kind::CalendarChanged;
+                    t.rows = std::move(rows);
+                    t.fixed = leading_fixed(t.rows, 0, today);
+                }
+                e.pending = Pending::None;
+            }
+
+            e.next_event = std::numeric_limits<serial_type>::max();
+            if (!t.rows.empty()) e.next_event = t.rows.front().paymentDate.serialNumber();
+            if (t.fixed < t.rows.size())
+                e.next_event = std::min(e.next_event, t.rows[t.fixed].fixingDate.serialNumber());
+
+            if (change.kind != ScheduleChange::Kind::Rolled || change.paid != 0 || change.newly_fixed != 0) {
+                change.live = t.rows.size();
+                out.trades.push_back(std::move(change));
+            }
+        }
+        std::sort(out.trades.begin() + static_cast<std::ptrdiff_t>(first_trade), out.trades.end(),
+                  [](const ScheduleChange& a, const ScheduleChange& b) { return a.trade_id < b.trade_id; });
+
+        as_of_ = as_of;
+        rolled_ = true;
+        return out;
+    }
+}
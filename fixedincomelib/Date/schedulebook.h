@@ -0,0 +1,115 @@
+#pragma once
+
+#include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/schedulecache.h"
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/Date/utilities.h"
+
+#include <ql/time/calendar.hpp>
+#include <ql/time/date.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // What happened to one trade in a roll
+    struct ScheduleChange {
+        enum class Kind {
+            Added,             // first roll since the trade was added, rows are all new
+            Removed,           // the trade was removed since the last roll
+            TermsChanged,      // upsert() changed its terms and the regenerated rows differ from the held ones
+            CalendarChanged,   // a calendar it uses changed and the regenerated rows differ from the held ones
+            Rolled             // same rows, some of them were paid or became fixed
+        };
+
+        std::string trade_id;
+        Kind kind = Kind::Rolled;
+        std::size_t paid = 0;          // rows evicted because they were paid, counted against the rows held before
+        std::size_t newly_fixed = 0;   // rows whose fixing date was reached, likewise
+        std::size_t live = 0;          // rows left after the roll, 0 once the trade has matured
+    };
+
+    struct ScheduleBookChanges {
+        QuantLib::Date as_of;
+        std::vector<ScheduleChange> trades;     // only the trades that changed: removals first, then by trade id
+        std::vector<std::string> calendars;     // name() of the calendars whose holidays changed since the last roll
+        std::size_t regenerated = 0;            // trades rebuilt with make_schedule, whether their rows changed or not
+    };
+
+    // Generated schedules of a book kept from one valuation date to the next
+    // Each morning roll(as_of) brings the book forward instead of regenerating it:
+    //   - rows paid by the as-of date are evicted and rows whose fixing date has been reached are counted as fixed
+    //     (a row is paid once its payment date is on or before the as-of date, fixed once its fixing date is)
+    //   - trades added or whose terms changed through upsert() are regenerated
+    //   - every calendar the book uses is fingerprinted a year at a time over the years its trades span, and trades
+    //     overlapping a year whose business days changed (holidays added or removed) are regenerated
+    // and the returned report lists exactly which trades changed and how, so revaluation can be incremental too. A
+    // regenerated trade whose rows come out the same is not reported as changed.
+    //
+    // Schedules are built with the registry's QuantLib calendars rather than the bitmap ones, which are snapshots
+    // and wouldn't see a holiday update. Rows are assumed to be in date order, as make_schedule produces them, so the
+    // paid and fixed rows are always leading runs.
+    class ScheduleBook {
+        public:
+            // Live rows of a trade as of the last roll
+            struct Trade {
+                std::string id;
+                ScheduleSpec spec;
+                std::vector<ScheduleRow> rows;
+                std::size_t fixed = 0;   // leading rows already fixed
+            };
+
+            // Adds a trade or replaces its terms, taking effect at the next roll; returns false if the terms are the
+            // same as the ones held (nothing to regenerate)
+            // Throws std::invalid_argument for an unknown convention name
+            bool upsert(const std::string& trade_id, const ScheduleSpec& spec);
+            // Returns false for an unknown trade; the removal is reported by the next roll
+            bool remove(const std::string& trade_id);
+
+            // Throws std::invalid_argument if as_of is before the last roll's; rolling to the same date again only
+            // picks up term and calendar changes
+            ScheduleBookChanges roll(const QuantLib::Date& as_of);
+
+            // Throws std::out_of_range for an unknown trade
+            const Trade& trade(const std::string& trade_id) const;
+            bool contains(const std::string& trade_id) const { return index_.count(trade_id) != 0; }
+            std::size_t size() const { return trades_.size(); }
+            QuantLib::Date as_of() const { return as_of_; }
+
+        private:
+            enum class Pending { None, Added, TermsChanged };
+
+            struct Entry {
+                Trade trade;
+                ScheduleKey key;
+                Pending pending = Pending::Added;
+                QuantLib::Date::serial_type next_event = 0;   // earliest unpaid payment or unfixed fixing date
+                int first_year = 0, last_year = 0;            // years the rows can fall in, with a year either side
+            };
+
+            // Business-day fingerprint of a calendar, one hash per year from first_year
+            struct CalendarState {
+                QuantLib::Calendar calendar;
+                int first_year = 0;
+                std::vector<std::uint64_t> years;
+                std::vector<int> changed;   // years that changed in the current roll
+            };
+
+            std::vector<ScheduleRow> generate(const ScheduleSpec& spec) const;
+            bool calendar_changed(const std::string& name, const Entry& e) const;
+
+            std::vector<Entry> trades_;
+            std::unordered_map<std::string, std::size_t> index_;
+            std::vector<std::string> removed_;
+            // By QuantLib name(), as in ScheduleKey, so "usgs" and "USGS" share one
+            std::unordered_map<std::string, CalendarState> calendars_;
+            int first_year_ = 0, last_year_ = 0;
+            QuantLib::Date as_of_;
+            bool rolled_ = false;
+    };
+
+}
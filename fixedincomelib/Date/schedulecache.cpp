@@ -0,0 +1,195 @@
+#include "fixedincomelib/Date/schedulecache.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace fixedincomelib {
+    namespace {
+        // 64-bit mixing step (splitmix64 finaliser), good enough spread for both the shard pick and the buckets
+        constexpr std::uint64_t mix(std::uint64_t h, std::uint64_t v) {
+            h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+            return h ^ (h >> 31);
+        }
+
+        std::uint64_t mix(std::uint64_t h, std::string_view s) {
+            return mix(h, std::hash<std::string_view>{}(s));
+        }
+    }
+
+    ScheduleKey ScheduleKey::make(const Date& start_date,
+                                  const Date& end_date,
+                                  const QuantLib::Period& accrual_period,
+                                  const QuantLib::Calendar& holiday_convention,
+                                  QuantLib::BusinessDayConvention business_day_convention,
+                                  const QuantLib::DayCounter& accrual_basis,
+                                  const std::string& rule,
+                                  bool end_of_month,
+                                  bool fix_in_arrear,
+                                  const QuantLib::Period& fixing_offset,
+                                  const QuantLib::Period& payment_offset,
+                                  QuantLib::BusinessDayConvention payment_business_day_convention,
+                                  const QuantLib::Calendar& payment_holiday_convention) {
+        ScheduleKey k;
+        k.start = start_date.get_date().serialNumber();
+        k.end = end_date.get_date().serialNumber();
+        k.period_length = accrual_period.length();
+        k.period_units = static_cast<int>(accrual_period.units());
+        k.calendar = holiday_convention.name();
+        k.bdc = static_cast<int>(business_day_convention);
+        k.day_counter = accrual_basis.name();
+        k.backward = rule == "BACKWARD";
+        k.end_of_month = end_of_month;
+
+        // make_schedule only looks at the fixing side when there is a fixing offset
+        if (fixing_offset.length() != 0) {
+            k.fix_in_arrear = fix_in_arrear;
+            k.fixing_length = fixing_offset.length();
+            k.fixing_units = static_cast<int>(fixing_offset.units());
+        }
+
+        // ... and only at the payment conventions when there is a payment offset
+        if (payment_offset.length() != 0) {
+            k.payment_length = payment_offset.length();
+            k.payment_units = static_cast<int>(payment_offset.units());
+            k.payment_bdc = static_cast<int>(payment_business_day_convention);
+            k.payment_calendar = payment_holiday_convention.name();
+        }
+        return k;
+    }
+
+    std::uint64_t ScheduleKey::hash() const {
+        std::uint64_t h = 0;
+        h = mix(h, static_cast<std::uint64_t>(start));
+        h = mix(h, static_cast<std::uint64_t>(end));
+        h = mix(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(period_length)) << 8) |
+                   static_cast<std::uint64_t>(period_units));
+        h = mix(h, calendar);
+        h = mix(h, day_counter);
+        h = mix(h, static_cast<std::uint64_t>(bdc) | (static_cast<std::uint64_t>(backward) << 8) |
+                   (static_cast<std::uint64_t>(end_of_month) << 9) | (static_cast<std::uint64_t>(fix_in_arrear) << 10));
+        h = mix(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(fixing_length)) << 8) |
+                   static_cast<std::uint64_t>(fixing_units));
+        h = mix(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(payment_length)) << 8) |
+                   static_cast<std::uint64_t>(payment_units) | (static_cast<std::uint64_t>(payment_bdc) << 40));
+        return mix(h, payment_calendar);
+    }
+
+    ScheduleCache::ScheduleCache(std::size_t capacity, std::size_t shards)
+        : shards_(std::max<std::size_t>(1, shards)) {
+        shard_capacity_ = std::max<std::size_t>(1, (capacity + shards_.size() - 1) / shards_.size());
+    }
+
+    ScheduleCache& ScheduleCache::instance() {
+        static ScheduleCache cache;
+        return cache;
+    }
+
+    ScheduleCache::Schedule ScheduleCache::schedule(const Date& start_date,
+                                                    const Date& end_date,
+                                                    const QuantLib::Period& accrual_period,
+                                                    const QuantLib::Calendar& holiday_convention,
+                                                    QuantLib::BusinessDayConvention business_day_convention,
+                                                    const QuantLib::DayCounter& accrual_basis,
+                                                    const std::string& rule,
+                                                    bool end_of_month,
+                                                    bool fix_in_arrear,
+                                                    const QuantLib::Period& fixing_offset,
+                                                    const QuantLib::Period& payment_offset,
+                                                    QuantLib::BusinessDayConvention payment_business_day_convention,
+                                                    const QuantLib::Calendar& payment_holiday_convention) {
+        ScheduleKey key = ScheduleKey::make(start_date, end_date, accrual_period, holiday_convention,
+                                            business_day_convention, accrual_basis, rule, end_of_month, fix_in_arrear,
+                                            fixing_offset, payment_offset, payment_business_day_convention,
+                                            payment_holiday_convention);
+        Shard& shard = shard_for(key.hash());
+
+        std::uint64_t generation;
+        {
+            std::lock_guard lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return it->second->value;
+            }
+            generation = shard.generation;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+
+        // Build outside the lock, invalid inputs throw here and never reach the cache
+        Schedule value = std::make_shared<const std::vector<ScheduleRow>>(make_schedule(
+            start_date, end_date, accrual_period, holiday_convention, business_day_convention, accrual_basis, rule,
+            end_of_month, fix_in_arrear, fixing_offset, payment_offset, payment_business_day_convention,
+            payment_holiday_convention));
+
+        std::lock_guard lock(shard.mutex);
+        // The shard was invalidated or cleared during the build, which may have seen the old holidays
+        if (shard.generation != generation) return value;
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            // Another thread built the same schedule meanwhile, keep theirs so everyone shares one copy
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return it->second->value;
+        }
+
+        if (shard.index.size() >= shard_capacity_) {
+            shard.index.erase(shard.lru.back().key);
+            shard.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.lru.push_front(Entry{std::move(key), value});
+        shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+        return value;
+    }
+
+    ScheduleCache::Stats ScheduleCache::stats() const {
+        Stats s;
+        s.hits = hits_.load(std::memory_order_relaxed);
+        s.misses = misses_.load(std::memory_order_relaxed);
+        s.evictions = evictions_.load(std::memory_order_relaxed);
+        s.capacity = shard_capacity_ * shards_.size();
+        for (const Shard& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            s.size += shard.index.size();
+        }
+        return s;
+    }
+
+    void ScheduleCache::reset_stats() {
+        hits_.store(0, std::memory_order_relaxed);
+        misses_.store(0, std::memory_order_relaxed);
+        evictions_.store(0, std::memory_order_relaxed);
+    }
+
+    void ScheduleCache::clear() {
+        for (Shard& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            shard.index.clear();
+            shard.lru.clear();
+            ++shard.generation;
+        }
+    }
+
+    std::size_t ScheduleCache::invalidate(const QuantLib::Calendar& calendar) {
+        // A JointCalendar's name lists its components' names, so a substring match catches the joints too
+        const std::string name = calendar.name();
+        auto uses = [&](const std::string& key_name) { return key_name.find(name) != std::string::npos; };
+        std::size_t dropped = 0;
+        for (Shard& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            ++shard.generation;
+            for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+                if (uses(it->key.calendar) || uses(it->key.payment_calendar)) {
+                    shard.index.erase(it->key);
+                    it = shard.lru.erase(it);
+                    ++dropped;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return dropped;
+    }
+}
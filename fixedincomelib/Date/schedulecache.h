@@ -0,0 +1,150 @@
+#pragma once
+
+#include "fixedincomelib/Date/utilities.h"
+
+#include <ql/time/calendar.hpp>
+#include <ql/time/daycounter.hpp>
+#include <ql/time/period.hpp>
+#include <ql/time/businessdayconvention.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Everything that decides the output of make_schedule, reduced to plain values
+    // Calendars and day counters are identified by name(), which is also how QuantLib compares them. Parameters
+    // make_schedule ignores are normalised away so they can't split the cache: with a zero fixing offset the fixing
+    // side is dropped, with a zero payment offset the payment calendar/convention are dropped, and any rule other
+    // than "BACKWARD" is stored as forward (make_schedule treats it that way).
+    struct ScheduleKey {
+        QuantLib::Date::serial_type start = 0;
+        QuantLib::Date::serial_type end = 0;
+        int period_length = 0;
+        int period_units = 0;
+        std::string calendar;
+        int bdc = 0;
+        std::string day_counter;
+        bool backward = true;
+        bool end_of_month = false;
+        bool fix_in_arrear = false;
+        int fixing_length = 0;
+        int fixing_units = 0;
+        int payment_length = 0;
+        int payment_units = 0;
+        int payment_bdc = 0;
+        std::string payment_calendar;
+
+        bool operator==(const ScheduleKey&) const = default;
+
+        static ScheduleKey make(const Date& start_date,
+                                const Date& end_date,
+                                const QuantLib::Period& accrual_period,
+                                const QuantLib::Calendar& holiday_convention,
+                                QuantLib::BusinessDayConvention business_day_convention,
+                                const QuantLib::DayCounter& accrual_basis,
+                                const std::string& rule,
+                                bool end_of_month,
+                                bool fix_in_arrear,
+                                const QuantLib::Period& fixing_offset,
+                                const QuantLib::Period& payment_offset,
+                                QuantLib::BusinessDayConvention payment_business_day_convention,
+                                const QuantLib::Calendar& payment_holiday_convention);
+
+        std::uint64_t hash() const;
+    };
+
+    // Bounded, thread-safe memo cache in front of make_schedule
+    // Books hold many trades with identical terms, so the same schedule would otherwise be rebuilt (QuantLib::Schedule
+    // plus every accrual) over and over. Results are shared as immutable vectors: a hit costs a hash, one short lock
+    // and a refcount bump.
+    //
+    // The cache is split into shards by key hash, each with its own mutex and LRU list, so concurrent callers rarely
+    // meet on a lock. Every shard holds at most capacity / shards entries and evicts its least recently used entry
+    // when full. Schedules are built outside the lock; if two threads miss on the same key at once both build it and
+    // the first insert wins. A build that overlaps invalidate() or clear() on its shard is returned but not cached,
+    // since it may have read the calendar from before the change.
+    //
+    // Calendars are keyed by name() only, so the cache can't tell when a calendar's holidays change: after
+    // addHoliday/removeHoliday on a calendar call invalidate(calendar), or schedules built before the change keep
+    // being served. ConventionRegistry::add_holiday/remove_holiday (and qfAddHoliday/qfRemoveHoliday) do this for the
+    // process-wide cache.
+    class ScheduleCache {
+        public:
+            using Schedule = std::shared_ptr<const std::vector<ScheduleRow>>;
+
+            struct Stats {
+                std::uint64_t hits = 0;
+                std::uint64_t misses = 0;
+                std::uint64_t evictions = 0;
+                std::size_t size = 0;      // entries currently cached
+                std::size_t capacity = 0;
+            };
+
+            explicit ScheduleCache(std::size_t capacity = 65536, std::size_t shards = 16);
+
+            // Process-wide instance used by qfMakeSchedule
+            static ScheduleCache& instance();
+
+            // Same arguments and result as make_schedule
+            Schedule schedule(const Date& start_date,
+                              const Date& end_date,
+                              const QuantLib::Period& accrual_period,
+                              const QuantLib::Calendar& holiday_convention,
+                              QuantLib::BusinessDayConvention business_day_convention,
+                              const QuantLib::DayCounter& accrual_basis,
+                              const std::string& rule = "BACKWARD",
+                              bool end_of_month = false,
+                              bool fix_in_arrear = false,
+                              const QuantLib::Period& fixing_offset = QuantLib::Period(0, QuantLib::Days),
+                              const QuantLib::Period& payment_offset = QuantLib::Period(0, QuantLib::Days),
+                              QuantLib::BusinessDayConvention payment_business_day_convention = QuantLib::Following,
+                              const QuantLib::Calendar& payment_holiday_convention =
+                                  QuantLib::UnitedStates(QuantLib::UnitedStates::FederalReserve));
+
+            Stats stats() const;
+            void reset_stats();
+            void clear();
+
+            // Drops every schedule built with `calendar` as its accrual or payment calendar, or as a component of a
+            // joint one (matched on name()); returns how many were dropped
+            std::size_t invalidate(const QuantLib::Calendar& calendar);
+
+        private:
+            struct KeyHash {
+                std::size_t operator()(const ScheduleKey& k) const { return static_cast<std::size_t>(k.hash()); }
+            };
+
+            struct Entry {
+                ScheduleKey key;
+                Schedule value;
+            };
+
+            // Front of lru is the most recently used entry
+            struct Shard {
+                mutable std::mutex mutex;
+                std::list<Entry> lru;
+                std::unordered_map<ScheduleKey, std::list<Entry>::iterator, KeyHash> index;
+                std::uint64_t generation = 0;  // bumped by invalidate() and clear(), guarded by mutex
+            };
+
+            Shard& shard_for(std::uint64_t hash) { return shards_[(hash >> 32) % shards_.size()]; }
+
+            std::size_t shard_capacity_;
+            std::vector<Shard> shards_;
+            std::atomic<std::uint64_t> hits_{0};
+            std::atomic<std::uint64_t> misses_{0};
+            std::atomic<std::uint64_t> evictions_{0};
+    };
+
+    // Shorthand used by the api layer
+    inline ScheduleCache& schedule_cache() { return ScheduleCache::instance(); }
+
+}
@@ -0,0 +1,113 @@
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/market/registry.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace fixedincomelib {
+    namespace {
+        // Trades per work-stealing chunk, big enough to amortise the queue lock and small enough to balance well
+        constexpr std::size_t trades_per_chunk = 64;
+
+        // Trades generated per block in generate_table before being appended to the table
+        constexpr std::size_t trades_per_table_block = 16384;
+    }
+
+    // Per-worker handles, filled from the registry the first time a worker sees a name
+    // The bitmap-backed calendars make the adjust/advance loops inside QuantLib::Schedule bit tests. A holiday change
+    // rebuilds the registry's bitmaps, so the calendars are dropped and looked up again once its generation moves on.
+    struct ScheduleEngine::WorkerConventions {
+        std::unordered_map<std::string, QuantLib::Calendar> calendars;
+        std::unordered_map<std::string, QuantLib::DayCounter> day_counters;
+        std::unordered_map<std::string, QuantLib::BusinessDayConvention> bdcs;
+        std::uint64_t generation = 0;  // registry generation the calendars were resolved at
+
+        // Called before each trade rather than inside calendar(), so the references a trade holds stay valid
+        void refresh() {
+            const std::uint64_t current = conventions().generation();
+            if (current == generation) return;
+            calendars.clear();
+            generation = current;
+        }
+
+        const QuantLib::Calendar& calendar(const std::string& name) {
+            auto it = calendars.find(name);
+            if (it == calendars.end())
+                it = calendars.emplace(name, conventions().bitmap_calendar(name).calendar()).first;
+            return it->second;
+        }
+
+        const QuantLib::DayCounter& day_counter(const std::string& name) {
+            auto it = day_counters.find(name);
+            if (it == day_counters.end())
+                it = day_counters.emplace(name, conventions().day_counter(name)).first;
+            return it->second;
+        }
+
+        QuantLib::BusinessDayConvention bdc(const std::string& name) {
+            auto it = bdcs.find(name);
+            if (it == bdcs.end())
+                it = bdcs.emplace(name, conventions().bdc(name)).first;
+            return it->second;
+        }
+    };
+
+    ScheduleEngine::ScheduleEngine(unsigned threads, ScheduleCache* cache)
+        : pool_(threads), cache_(cache), conventions_(pool_.size()) {}
+
+    ScheduleEngine::~ScheduleEngine() = default;
+
+    void ScheduleEngine::generate_range(const std::vector<ScheduleSpec>& specs, std::size_t begin, std::size_t end,
+                                        std::vector<std::vector<ScheduleRow>>& out) {
+        pool_.parallel_for(end - begin, trades_per_chunk, [&](std::size_t b, std::size_t e, unsigned worker) {
+            WorkerConventions& c = conventions_[worker];
+            for (std::size_t i = b; i < e; ++i) {
+                const ScheduleSpec& s = specs[begin + i];
+                c.refresh();
+                const QuantLib::Calendar& cal = c.calendar(s.holiday_convention);
+                const QuantLib::Calendar& pay_cal = c.calendar(s.payment_holiday_convention);
+                const QuantLib::DayCounter& dc = c.day_counter(s.accrual_basis);
+                const QuantLib::BusinessDayConvention bdc = c.bdc(s.business_day_convention);
+                const QuantLib::BusinessDayConvention pay_bdc = c.bdc(s.payment_business_day_convention);
+                if (cache_) {
+                    out[i] = *cache_->schedule(s.start_date, s.end_date, s.accrual_period, cal, bdc, dc, s.rule,
+                                               s.end_of_month, s.fix_in_arrear, s.fixing_offset, s.payment_offset,
+                                               pay_bdc, pay_cal);
+                    continue;
+                }
+                out[i] = make_schedule(
+                    s.start_date, s.end_date, s.accrual_period,
+                    cal,
+                    bdc,
+                    dc,
+                    s.rule,
+                    s.end_of_month,
+                    s.fix_in_arrear,
+                    s.fixing_offset,
+                    s.payment_offset,
+                    pay_bdc,
+                    pay_cal
+                );
+            }
+        });
+    }
+
+    std::vector<std::vector<ScheduleRow>> ScheduleEngine::generate(const std::vector<ScheduleSpec>& specs) {
+        std::vector<std::vector<ScheduleRow>> out(specs.size());
+        generate_range(specs, 0, specs.size(), out);
+        return out;
+    }
+
+    ScheduleTable ScheduleEngine::generate_table(const std::vector<ScheduleSpec>& specs, const QuantLib::Date& epoch) {
+        ScheduleTable table(epoch);
+        std::vector<std::vector<ScheduleRow>> block(std::min(specs.size(), trades_per_table_block));
+        for (std::size_t begin = 0; begin < specs.size(); begin += trades_per_table_block) {
+            const std::size_t end = std::min(specs.size(), begin + trades_per_table_block);
+            generate_range(specs, begin, end, block);
+            for (std::size_t i = 0; i < end - begin; ++i)
+                table.append(block[i]);
+        }
+        return table;
+    }
+}
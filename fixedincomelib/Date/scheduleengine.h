@@ -0,0 +1,72 @@
+#pragma once
+
+#include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/Date/scheduletable.h"
+#include "fixedincomelib/Date/schedulecache.h"
+#include "fixedincomelib/utils/threadpool.h"
+
+#include <ql/time/period.hpp>
+
+#include <string>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Everything make_schedule needs for one trade, with conventions given by name as in qfMakeSchedule
+    // The defaults match qfMakeSchedule's
+    struct ScheduleSpec {
+        Date start_date;
+        Date end_date;
+        QuantLib::Period accrual_period;
+        std::string holiday_convention = "NONE";
+        std::string business_day_convention = "NONE";
+        std::string accrual_basis = "NONE";
+        std::string rule = "BACKWARD";
+        bool end_of_month = false;
+        bool fix_in_arrear = false;
+        QuantLib::Period fixing_offset = QuantLib::Period(0, QuantLib::Days);
+        QuantLib::Period payment_offset = QuantLib::Period(0, QuantLib::Days);
+        std::string payment_business_day_convention = "F";
+        std::string payment_holiday_convention = "USGS";
+    };
+
+    // Builds the schedules of a whole book in parallel
+    // Trades are spread over a work-stealing ThreadPool in small chunks. Every worker resolves conventions through
+    // its own cache of handles (bitmap-backed calendars from the registry, day counters), so workers never contend
+    // on a lock or a shared refcount after warm-up. The calendars and day counters are only ever read, and
+    // make_schedule doesn't touch QuantLib's global Settings, so no other state is shared between workers. Before
+    // each trade a worker compares the registry's generation() with the one its calendars came from, and looks them
+    // up again after a holiday change, so a long-lived engine follows qfAddHoliday / qfRemoveHoliday.
+    //
+    // Output is deterministic: schedule i always belongs to specs[i], whatever the thread count.
+    class ScheduleEngine {
+        public:
+            // threads = 0 uses one worker per hardware thread
+            // With a cache, trades whose terms were already seen copy the cached rows instead of rebuilding them
+            // (pass &schedule_cache() to share the process-wide one); the cache must outlive the engine
+            explicit ScheduleEngine(unsigned threads = 0, ScheduleCache* cache = nullptr);
+            ~ScheduleEngine();
+
+            unsigned threads() const { return pool_.size(); }
+
+            std::vector<std::vector<ScheduleRow>> generate(const std::vector<ScheduleSpec>& specs);
+
+            // Same schedules in columnar form, trade i of the table is specs[i]
+            // Trades are generated a block at a time and appended, so the per-trade vectors never all exist at once
+            ScheduleTable generate_table(const std::vector<ScheduleSpec>& specs,
+                                         const QuantLib::Date& epoch = QuantLib::Date(1, QuantLib::January, 1950));
+
+        private:
+            struct WorkerConventions;
+
+            // Schedules of specs[begin, end) into out[0, end - begin)
+            void generate_range(const std::vector<ScheduleSpec>& specs, std::size_t begin, std::size_t end,
+                                std::vector<std::vector<ScheduleRow>>& out);
+
+            ThreadPool pool_;
+            ScheduleCache* cache_;
+            std::vector<WorkerConventions> conventions_;  // one per worker, indexed by worker id
+    };
+
+}
@@ -0,0 +1,214 @@
+#include "fixedincomelib/Date/schedulefile.h"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace fixedincomelib {
+    namespace {
+        static_assert(std::endian::native == std::endian::little, "schedule files are written little-endian");
+
+        constexpr char header_magic[8] = {'F', 'I', 'L', 'S', 'C', 'H', 'E', 'D'};
+        constexpr char trailer_magic[8] = {'F', 'I', 'L', 'S', 'C', 'E', 'N', 'D'};
+        constexpr std::size_t header_size = 64, trailer_size = 64;
+        // Trailer fields, 8 bytes each after the magic
+        enum TrailerField { rows_at, blocks_at, directory_at, trades_at, index_at, ids_at, ids_size_at, fields };
+        static_assert(8 + 8 * fields <= trailer_size);
+
+        // accrued is 8 bytes a row, the four date columns 4 bytes each
+        constexpr std::size_t bytes_per_row = sizeof(double) + 4 * sizeof(std::int32_t);
+
+        std::int32_t serial32(const QuantLib::Date& d) { return static_cast<std::int32_t>(d.serialNumber()); }
+
+        template <class T>
+        void write(std::ofstream& out, const T* data, std::size_t n) {
+            out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+        }
+    }
+
+    ScheduleRow ScheduleColumns::row(std::size_t i) const {
+        return ScheduleRow{QuantLib::Date(start_dates[i]), QuantLib::Date(end_dates[i]),
+                           QuantLib::Date(fixing_dates[i]), QuantLib::Date(payment_dates[i]), accrued[i]};
+    }
+
+    // ---------- writer ----------
+
+    ScheduleFileWriter::ScheduleFileWriter(const std::string& path, std::size_t block_rows)
+        : path_(path), out_(path, std::ios::binary | std::ios::trunc), block_rows_(block_rows) {
+        if (block_rows == 0) throw std::invalid_argument("ScheduleFileWriter: block_rows must be positive");
+        if (!out_) throw std::runtime_error("Cannot create " + path);
+
+        char header[header_size] = {};
+        std::memcpy(header, header_magic, sizeof(header_magic));
+        std::memcpy(header + sizeof(header_magic), &schedule_file::version, sizeof(schedule_file::version));
+        out_.write(header, sizeof(header));
+        offset_ = header_size;
+    }
+
+    ScheduleFileWriter::~ScheduleFileWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void ScheduleFileWriter::append(std::string_view trade_id, std::span<const ScheduleRow> rows) {
+        if (closed_) throw std::logic_error("ScheduleFileWriter::append: " + path_ + " is already closed");
+        if (rows.size() > std::numeric_limits<std::uint32_t>::max() ||
+            ids_.size() + trade_id.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("ScheduleFileWriter::append: trade " + std::string(trade_id) + " is too large");
+        if (!accrued_.empty() && accrued_.size() + rows.size() > block_rows_) flush_block();
+
+        index_.push_back(static_cast<std::uint32_t>(directory_.size() / 2));
+        index_.push_back(static_cast<std::uint32_t>(accrued_.size()));
+        index_.push_back(static_cast<std::uint32_t>(rows.size()));
+        index_.push_back(static_cast<std::uint32_t>(ids_.size()));
+        ids_.append(trade_id);
+
+        for (const ScheduleRow& r : rows) {
+            accrued_.push_back(r.accrued);
+            start_.push_back(serial32(r.startDate));
+            end_.push_back(serial32(r.endDate));
+            fixing_.push_back(serial32(r.fixingDate));
+            payment_.push_back(serial32(r.paymentDate));
+        }
+        if (accrued_.size() >= block_rows_) flush_block();
+    }
+
+    void ScheduleFileWriter::flush_block() {
+        const std::size_t n = accrued_.size();
+        if (n == 0) return;
+        write(out_, accrued_.data(), n);
+        write(out_, start_.data(), n);
+        write(out_, end_.data(), n);
+        write(out_, fixing_.data(), n);
+        write(out_, payment_.data(), n);
+        if (!out_) throw std::runtime_error("Failed writing schedules to " + path_);
+
+        directory_.push_back(offset_);
+        directory_.push_back(n);
+        offset_ += n * bytes_per_row;
+        rows_written_ += n;
+        accrued_.clear();
+        start_.clear();
+        end_.clear();
+        fixing_.clear();
+        payment_.clear();
+    }
+
+    void ScheduleFileWriter::close() {
+        if (closed_) return;
+        closed_ = true;
+        flush_block();
+
+        std::uint64_t trailer[fields];
+        trailer[rows_at] = rows_written_;
+        trailer[blocks_at] = directory_.size() / 2;
+        trailer[trades_at] = index_.size() / 4;
+
+        trailer[directory_at] = offset_;
+        write(out_, directory_.data(), directory_.size());
+        offset_ += directory_.size() * sizeof(std::uint64_t);
+
+        trailer[index_at] = offset_;
+        write(out_, index_.data(), index_.size());
+        offset_ += index_.size() * sizeof(std::uint32_t);
+
+        trailer[ids_at] = offset_;
+        trailer[ids_size_at] = ids_.size();
+        out_.write(ids_.data(), static_cast<std::streamsize>(ids_.size()));
+
+        char tail[7 + trailer_size] = {};
+        const std::size_t padding = (8 - ids_.size() % 8) % 8;
+        std::memcpy(tail + padding, trailer_magic, sizeof(trailer_magic));
+        std::memcpy(tail + padding + sizeof(trailer_magic), trailer, sizeof(trailer));
+        out_.write(tail, static_cast<std::streamsize>(padding + trailer_size));
+        out_.close();
+        if (!out_) throw std::runtime_error("Failed writing schedules to " + path_);
+    }
+
+    // ---------- reader ----------
+
+    ScheduleFile::ScheduleFile(const std::string& path) : file_(path) {
+        const char* data = file_.data();
+        const std::size_t size = file_.size();
+        std::uint32_t version = 0;
+        if (size < header_size + trailer_size || std::memcmp(data, header_magic, sizeof(header_magic)) != 0)
+            throw std::runtime_error(path + " is not a schedule file");
+        std::memcpy(&version, data + sizeof(header_magic), sizeof(version));
+        if (version != schedule_file::version)
+            throw std::runtime_error(path + " is schedule file version " + std::to_string(version) + ", expected " +
+                                     std::to_string(schedule_file::version));
+
+        const char* tail = data + size - trailer_size;
+        std::uint64_t trailer[fields];
+        std::memcpy(trailer, tail + sizeof(trailer_magic), sizeof(trailer));
+        const std::size_t body = size - trailer_size;
+        auto fits = [&](std::uint64_t at, std::uint64_t count, std::uint64_t width, std::uint64_t limit) {
+            return at % 8 == 0 && at >= header_size && at <= limit && count <= (limit - at) / width;
+        };
+        if (std::memcmp(tail, trailer_magic, sizeof(trailer_magic)) != 0 ||
+            !fits(trailer[directory_at], trailer[blocks_at], 16, body) ||
+            !fits(trailer[index_at], trailer[trades_at], 16, body) ||
+            trailer[index_at] < trailer[directory_at] + 16 * trailer[blocks_at] ||
+            trailer[ids_at] < trailer[index_at] + 16 * trailer[trades_at] ||
+            trailer[ids_at] > body || trailer[ids_size_at] > body - trailer[ids_at])
+            throw std::runtime_error(path + " is truncated or has a corrupt trailer");
+
+        row_count_ = static_cast<std::size_t>(trailer[rows_at]);
+        block_count_ = static_cast<std::size_t>(trailer[blocks_at]);
+        trade_count_ = static_cast<std::size_t>(trailer[trades_at]);
+        directory_ = reinterpret_cast<const std::uint64_t*>(data + trailer[directory_at]);
+        index_ = reinterpret_cast<const std::uint32_t*>(data + trailer[index_at]);
+        ids_ = data + trailer[ids_at];
+        ids_size_ = static_cast<std::size_t>(trailer[ids_size_at]);
+
+        // One entry per block, cheap next to the rows themselves
+        std::uint64_t rows = 0;
+        for (std::size_t b = 0; b < block_count_; ++b) {
+            if (!fits(directory_[2 * b], directory_[2 * b + 1], bytes_per_row, trailer[directory_at]))
+                throw std::runtime_error(path + ": block " + std::to_string(b) + " is outside the file");
+            rows += directory_[2 * b + 1];
+        }
+        if (rows != row_count_) throw std::runtime_error(path + ": block row counts don't add up");
+    }
+
+    std::string_view ScheduleFile::trade_id(std::size_t t) const {
+        if (t >= trade_count_) throw std::out_of_range("ScheduleFile: no trade " + std::to_string(t));
+        const std::size_t begin = index_[4 * t + 3];
+        const std::size_t end = t + 1 < trade_count_ ? index_[4 * (t + 1) + 3] : ids_size_;
+        if (begin > end || end > ids_size_)
+            throw std::runtime_error("ScheduleFile: corrupt id for trade " + std::to_string(t));
+        return std::string_view(ids_ + begin, end - begin);
+    }
+
+    ScheduleColumns ScheduleFile::trade(std::size_t t) const {
+        if (t >= trade_count_) throw std::out_of_range("ScheduleFile: no trade " + std::to_string(t));
+        const std::uint32_t* e = index_ + 4 * t;
+        const std::size_t block = e[0], first = e[1], rows = e[2];
+        // A trade with no rows may point one past the last block, when nothing was written after it
+        if (rows == 0) return ScheduleColumns{};
+        if (block >= block_count_ || first + rows > directory_[2 * block + 1])
+            throw std::runtime_error("ScheduleFile: corrupt index entry for trade " + std::to_string(t));
+
+        const char* base = file_.data() + directory_[2 * block];
+        const std::size_t n = static_cast<std::size_t>(directory_[2 * block + 1]);
+        const auto* dates = reinterpret_cast<const std::int32_t*>(base + n * sizeof(double));
+        ScheduleColumns c;
+        c.accrued = std::span<const double>(reinterpret_cast<const double*>(base) + first, rows);
+        c.start_dates = std::span<const std::int32_t>(dates + first, rows);
+        c.end_dates = std::span<const std::int32_t>(dates + n + first, rows);
+        c.fixing_dates = std::span<const std::int32_t>(dates + 2 * n + first, rows);
+        c.payment_dates = std::span<const std::int32_t>(dates + 3 * n + first, rows);
+        return c;
+    }
+
+    std::vector<ScheduleRow> ScheduleFile::trade_rows(std::size_t t) const {
+        const ScheduleColumns c = trade(t);
+        std::vector<ScheduleRow> rows;
+        rows.reserve(c.size());
+        for (std::size_t i = 0; i < c.size(); ++i) rows.push_back(c.row(i));
+        return rows;
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/utils/mappedfile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Flat binary file of generated schedules, for handing millions of rows from one batch stage to the next
+//
+//   header        64 bytes: magic, version
+//   blocks        each holds the rows of whole trades as fixed-width columns, one after the other:
+//                 accrued (double), then start, end, fixing and payment dates (int32 QuantLib serials)
+//   directory     per block: file offset and row count
+//   trade index   per trade: block, first row in the block, row count, offset of its id
+//   trade ids     the ids back to back
+//   trailer       64 bytes: magic, row/block/trade counts and where the directory, index and ids start
+// Everything is little-endian and 8-byte aligned, so a reader maps the file and points spans straight at the columns,
+// with no parsing and no copy. The trailer goes last so the writer can stream blocks out as trades come in. The
+// version is bumped whenever the layout changes and readers refuse any other version.
+
+namespace fixedincomelib {
+
+    namespace schedule_file {
+        inline constexpr std::uint32_t version = 1;
+        inline constexpr std::size_t default_block_rows = 65536;
+    }
+
+    // One trade's rows, viewing the columns of a mapped file
+    struct ScheduleColumns {
+        std::span<const double> accrued;
+        std::span<const std::int32_t> start_dates;
+        std::span<const std::int32_t> end_dates;
+        std::span<const std::int32_t> fixing_dates;
+        std::span<const std::int32_t> payment_dates;
+
+        std::size_t size() const { return accrued.size(); }
+        ScheduleRow row(std::size_t i) const;
+    };
+
+    // Streams trades into a schedule file
+    // Rows collect in memory as columns and go out a block at a time; a block is closed before the trade that would
+    // take it past block_rows, so no trade straddles two blocks (a trade longer than that gets a block to itself).
+    // The index and ids stay in memory until close(), 16 bytes a trade plus the ids.
+    class ScheduleFileWriter {
+        public:
+            // Throws std::runtime_error if the file can't be created, std::invalid_argument for block_rows == 0
+            explicit ScheduleFileWriter(const std::string& path,
+                                        std::size_t block_rows = schedule_file::default_block_rows);
+            // Closes the file if close() wasn't called, swallowing errors; call close() to see them
+            ~ScheduleFileWriter();
+
+            ScheduleFileWriter(const ScheduleFileWriter&) = delete;
+            ScheduleFileWriter& operator=(const ScheduleFileWriter&) = delete;
+
+            // Throws std::logic_error after close(), std::runtime_error if a write fails
+            void append(std::string_view trade_id, std::span<const ScheduleRow> rows);
+
+            // Writes the last block, the directory, the index and the trailer; the file is only readable after this
+            void close();
+
+            std::size_t trade_count() const { return index_.size() / 4; }
+            std::size_t row_count() const { return rows_written_ + accrued_.size(); }
+
+        private:
+            void flush_block();
+
+            std::string path_;
+            std::ofstream out_;
+            std::size_t block_rows_;
+            bool closed_ = false;
+            std::uint64_t offset_ = 0;         // bytes written so far
+            std::uint64_t rows_written_ = 0;   // rows in flushed blocks
+
+            // The block being filled
+            std::vector<double> accrued_;
+            std::vector<std::int32_t> start_, end_, fixing_, payment_;
+
+            std::vector<std::uint64_t> directory_;   // offset, rows per block
+            std::vector<std::uint32_t> index_;       // block, first row, rows, id offset per trade
+            std::string ids_;
+    };
+
+    // Read-only view of a schedule file over a memory map
+    // Opening checks the header, trailer and section bounds; trade(t) checks t's own index entry, so a damaged entry
+    // is reported when it is reached rather than by scanning the file up front. Everything is const and can be used
+    // from any number of threads.
+    class ScheduleFile {
+        public:
+            // Throws std::runtime_error if the file can't be mapped, isn't a schedule file of this version, or its
+            // sections don't fit in it
+            explicit ScheduleFile(const std::string& path);
+
+            std::size_t trade_count() const { return trade_count_; }
+            std::size_t row_count() const { return row_count_; }
+            std::size_t block_count() const { return block_count_; }
+
+            // Throw std::out_of_range for t >= trade_count(), std::runtime_error for a corrupt index entry
+            std::string_view trade_id(std::size_t t) const;
+            ScheduleColumns trade(std::size_t t) const;
+            // Copies the trade back out as rows
+            std::vector<ScheduleRow> trade_rows(std::size_t t) const;
+
+        private:
+            MappedFile file_;
+            std::size_t row_count_ = 0;
+            std::size_t block_count_ = 0;
+            std::size_t trade_count_ = 0;
+            const std::uint64_t* directory_ = nullptr;
+            const std::uint32_t* index_ = nullptr;
+            const char* ids_ = nullptr;
+            std::size_t ids_size_ = 0;
+    };
+
+}
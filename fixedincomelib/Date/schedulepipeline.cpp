@@ -0,0 +1,264 @@
+#include "fixedincomelib/Date/schedulepipeline.h"
+#include "fixedincomelib/Date/schedulewriter.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/utils/boundedqueue.h"
+#include "fixedincomelib/utils/mappedfile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace fixedincomelib {
+    namespace {
+        // Trades per work-stealing chunk, each chunk is formatted into its own buffer
+        constexpr std::size_t trades_per_chunk = 64;
+
+        constexpr std::string_view output_header = "TradeId,StartDate,EndDate,FixingDate,PaymentDate,Accrued\n";
+
+        // make_schedule takes the rule as a std::string, anything but "BACKWARD" meaning forward
+        const std::string backward_rule = "BACKWARD";
+        const std::string forward_rule = "FORWARD";
+
+        struct NameHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+
+        template <class T>
+        using NameMap = std::unordered_map<std::string, T, NameHash, std::equal_to<>>;
+    }
+
+    // Per-worker handles, filled from the registry the first time a worker sees a name
+    // Same idea as ScheduleEngine's, but looked up by the string_views of the parsed line; the calendars are dropped
+    // the same way once a holiday change moves the registry's generation on
+    struct SchedulePipeline::WorkerConventions {
+        NameMap<QuantLib::Calendar> calendars;
+        NameMap<QuantLib::DayCounter> day_counters;
+        NameMap<QuantLib::BusinessDayConvention> bdcs;
+        std::uint64_t generation = 0;  // registry generation the calendars were resolved at
+
+        // Called before each line, so the references a line holds stay valid
+        void refresh() {
+            const std::uint64_t current = conventions().generation();
+            if (current == generation) return;
+            calendars.clear();
+            generation = current;
+        }
+
+        const QuantLib::Calendar& calendar(std::string_view name) {
+            auto it = calendars.find(name);
+            if (it == calendars.end())
+                it = calendars.emplace(std::string(name), conventions().bitmap_calendar(name).calendar()).first;
+            return it->second;
+        }
+
+        const QuantLib::DayCounter& day_counter(std::string_view name) {
+            auto it = day_counters.find(name);
+            if (it == day_counters.end())
+                it = day_counters.emplace(std::string(name), conventions().day_counter(name)).first;
+            return it->second;
+        }
+
+        QuantLib::BusinessDayConvention bdc(std::string_view name) {
+            auto it = bdcs.find(name);
+            if (it == bdcs.end())
+                it = bdcs.emplace(std::string(name), conventions().bdc(name)).first;
+            return it->second;
+        }
+    };
+
+    // A block of input lines and, once generated, their output
+    // Blocks are allocated once per run and cycled between the generator and the writer, so the line vector and
+    // the part buffers keep their capacity from one block to the next.
+    struct SchedulePipeline::Block {
+        struct Part {
+            std::string text;
+            std::uint64_t trades = 0, rows = 0, invalid = 0;
+        };
+
+        std::vector<std::string_view> lines;   // views into the input, without the '\n'
+        std::uint64_t first_line = 0;          // line number of lines[0], the header being line 1
+        std::vector<Part> parts;               // one per chunk of trades_per_chunk lines
+    };
+
+    SchedulePipeline::SchedulePipeline(SchedulePipelineOptions options)
+        : options_(options), pool_(options.threads), conventions_(pool_.size()) {
+        options_.trades_per_block = std::max<std::size_t>(options_.trades_per_block, 1);
+    }
+
+    SchedulePipeline::~SchedulePipeline() = default;
+
+    void SchedulePipeline::generate(const TradeFileLayout& layout, Block& block) {
+        const std::size_t n = block.lines.size();
+        block.parts.resize((n + trades_per_chunk - 1) / trades_per_chunk);
+
+        pool_.parallel_for(n, trades_per_chunk, [&](std::size_t b, std::size_t e, unsigned worker) {
+            Block::Part& part = block.parts[b / trades_per_chunk];
+            part.text.clear();
+            part.trades = part.rows = part.invalid = 0;
+
+            WorkerConventions& c = conventions_[worker];
+            CsvSink sink(part.text);
+            char line_id[24];
+
+            auto write = [&](std::string_view id, const std::vector<ScheduleRow>& rows) {
+                for (const ScheduleRow& r : rows) {
+                    part.text.append(id);
+                    part.text.push_back(',');
+                    sink.row(r);
+                }
+                ++part.trades;
+                part.rows += rows.size();
+            };
+
+            for (std::size_t i = b; i < e; ++i) {
+                const std::string_view line = block.lines[i];
+                if (line.empty() || line == "\r") continue;
+                const std::uint64_t line_number = block.first_line + i;
+
+                try {
+                    ScheduleSpecView s;
+                    layout.parse(line, s);
+
+                    std::string_view id = s.trade_id;
+                    if (id.empty()) {
+                        const char* end = std::to_chars(line_id, line_id + sizeof(line_id), line_number).ptr;
+                        id = std::string_view(line_id, static_cast<std::size_t>(end - line_id));
+                    }
+
+                    c.refresh();
+                    const QuantLib::Calendar& cal = c.calendar(s.holiday_convention);
+                    const QuantLib::Calendar& pay_cal = c.calendar(s.payment_holiday_convention);
+                    const QuantLib::DayCounter& dc = c.day_counter(s.accrual_basis);
+                    const QuantLib::BusinessDayConvention bdc = c.bdc(s.business_day_convention);
+                    const QuantLib::BusinessDayConvention pay_bdc = c.bdc(s.payment_business_day_convention);
+                    const std::string& rule = s.rule == backward_rule ? backward_rule : forward_rule;
+
+                    if (options_.cache) {
+                        write(id, *options_.cache->schedule(s.start_date, s.end_date, s.accrual_period, cal, bdc, dc,
+                                                            rule, s.end_of_month, s.fix_in_arrear, s.fixing_offset,
+                                                            s.payment_offset, pay_bdc, pay_cal));
+                    } else {
+                        write(id, make_schedule(s.start_date, s.end_date, s.accrual_period, cal, bdc, dc, rule,
+                                                s.end_of_month, s.fix_in_arrear, s.fixing_offset, s.payment_offset,
+                                                pay_bdc, pay_cal));
+                    }
+                } catch (const std::exception& ex) {
+                    if (!options_.skip_invalid)
+                        throw std::invalid_argument("Trade file line " + std::to_string(line_number) + ": " +
+                                                    ex.what());
+                    ++part.invalid;
+                }
+            }
+        });
+    }
+
+    SchedulePipelineStats SchedulePipeline::run(const std::string& input_path, const std::string& output_path) {
+        MappedFile input(input_path);
+        std::ofstream out(output_path, std::ios::binary);
+        if (!out) throw std::runtime_error("Cannot write schedules to " + output_path);
+
+        SchedulePipelineStats stats = run(input.view(), out, &input);
+        out.close();
+        if (!out) throw std::runtime_error("Failed writing schedules to " + output_path);
+        return stats;
+    }
+
+    SchedulePipelineStats SchedulePipeline::run(std::string_view input, std::ostream& out) {
+        return run(input, out, nullptr);
+    }
+
+    SchedulePipelineStats SchedulePipeline::run(std::string_view input, std::ostream& out, MappedFile* source) {
+        const auto t0 = std::chrono::steady_clock::now();
+        SchedulePipelineStats stats;
+        stats.input_bytes = input.size();
+
+        std::size_t pos = 0;
+        auto next_line = [&]() {
+            std::size_t end = input.find('\n', pos);
+            if (end == std::string_view::npos) end = input.size();
+            const std::string_view line = input.substr(pos, end - pos);
+            pos = end + 1;
+            return line;
+        };
+
+        if (input.empty()) throw std::invalid_argument("Trade file is empty, expected a header line");
+        const TradeFileLayout layout(next_line());
+        std::uint64_t line_number = 1;
+
+        out.write(output_header.data(), static_cast<std::streamsize>(output_header.size()));
+        stats.output_bytes += output_header.size();
+
+        // One block being generated plus up to queue_blocks waiting for (or in) the writer
+        std::vector<Block> blocks(std::max<std::size_t>(options_.queue_blocks, 1) + 1);
+        BoundedQueue<Block*> free_blocks(blocks.size()), full_blocks(blocks.size());
+        for (Block& b : blocks) free_blocks.push(&b);
+
+        std::exception_ptr writer_error;
+        std::thread writer([&] {
+            try {
+                while (std::optional<Block*> b = full_blocks.pop()) {
+                    for (const Block::Part& part : (*b)->parts) {
+                        out.write(part.text.data(), static_cast<std::streamsize>(part.text.size()));
+                        stats.output_bytes += part.text.size();
+                        stats.trades += part.trades;
+                        stats.rows += part.rows;
+                        stats.invalid += part.invalid;
+                    }
+                    if (!out) throw std::runtime_error("Failed writing schedules");
+                    free_blocks.push(*b);
+                }
+            } catch (...) {
+                writer_error = std::current_exception();
+                free_blocks.close();
+                full_blocks.close();
+            }
+        });
+
+        try {
+            std::size_t released = 0;
+            while (pos < input.size()) {
+                // Waits here while every block is queued for the writer
+                std::optional<Block*> b = free_blocks.pop();
+                if (!b) break;
+
+                Block& block = **b;
+                block.lines.clear();
+                block.first_line = line_number + 1;
+                while (block.lines.size() < options_.trades_per_block && pos < input.size())
+                    block.lines.push_back(next_line());
+                line_number += block.lines.size();
+
+                generate(layout, block);
+
+                // The block's output is in its own buffers now, so the input behind us can go
+                if (source) {
+                    source->release(released, pos);
+                    released = pos;
+                }
+                if (!full_blocks.push(&block)) break;
+            }
+        } catch (...) {
+            full_blocks.close();
+            free_blocks.close();
+            writer.join();
+            throw;
+        }
+
+        full_blocks.close();
+        writer.join();
+        if (writer_error) std::rethrow_exception(writer_error);
+
+        out.flush();
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return stats;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "fixedincomelib/Date/schedulecache.h"
+#include "fixedincomelib/Date/tradefile.h"
+#include "fixedincomelib/utils/threadpool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fixedincomelib {
+
+    class MappedFile;
+
+    struct SchedulePipelineOptions {
+        unsigned threads = 0;                 // generator threads, 0 = one per hardware thread
+        std::size_t trades_per_block = 4096;  // lines parsed and generated per parallel step
+        std::size_t queue_blocks = 4;         // generated blocks waiting for the writer before generation stalls
+        bool skip_invalid = false;            // count and skip bad lines instead of throwing
+        ScheduleCache* cache = nullptr;       // as for ScheduleEngine, must outlive the pipeline
+    };
+
+    struct SchedulePipelineStats {
+        std::uint64_t trades = 0;             // lines turned into schedules
+        std::uint64_t rows = 0;               // schedule rows written
+        std::uint64_t invalid = 0;            // lines skipped with skip_invalid
+        std::uint64_t input_bytes = 0;
+        std::uint64_t output_bytes = 0;
+        double seconds = 0.0;
+
+        double trades_per_second() const { return seconds > 0.0 ? static_cast<double>(trades) / seconds : 0.0; }
+        double input_mb_per_second() const {
+            return seconds > 0.0 ? static_cast<double>(input_bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+        }
+    };
+
+    // Trade file (Date/tradefile.h) in, one CSV of schedule rows out:
+    //   TradeId,StartDate,EndDate,FixingDate,PaymentDate,Accrued
+    // with the rows of each trade in file order (trade ids default to the line number).
+    //
+    // The input is memory-mapped and read a block of lines at a time. Each block is parsed in place (the specs view
+    // the mapping) and generated on a work-stealing ThreadPool, every worker formatting its chunk of trades into its
+    // own buffer. Finished blocks go through a bounded queue to a writer thread; when the writer falls behind the
+    // generator waits for a free block (backpressure). Blocks and their buffers are recycled and the input pages
+    // behind the generator are handed back to the OS, so memory stays flat however large the file is. Workers keep
+    // their calendar handles from one run to the next and look them up again after a holiday change
+    // (ConventionRegistry::generation()).
+    class SchedulePipeline {
+        public:
+            explicit SchedulePipeline(SchedulePipelineOptions options = {});
+            ~SchedulePipeline();
+
+            SchedulePipeline(const SchedulePipeline&) = delete;
+            SchedulePipeline& operator=(const SchedulePipeline&) = delete;
+
+            // Throws std::runtime_error if a file can't be opened, std::invalid_argument on a bad line (with its
+            // line number) unless skip_invalid is set
+            SchedulePipelineStats run(const std::string& input_path, const std::string& output_path);
+
+            // Same from a buffer already in memory into any stream
+            SchedulePipelineStats run(std::string_view input, std::ostream& out);
+
+        private:
+            struct Block;
+            struct WorkerConventions;
+
+            SchedulePipelineStats run(std::string_view input, std::ostream& out, MappedFile* source);
+            void generate(const TradeFileLayout& layout, Block& block);
+
+            SchedulePipelineOptions options_;
+            ThreadPool pool_;
+            std::vector<WorkerConventions> conventions_;  // one per worker, indexed by worker id
+    };
+
+}
@@ -0,0 +1,89 @@
+#include "fixedincomelib/Date/scheduletable.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+
+    ScheduleTable::ScheduleTable(const QuantLib::Date& epoch)
+        : epoch_(epoch.serialNumber()), trade_offsets_{0} {}
+
+    void ScheduleTable::reserve(std::size_t trades, std::size_t rows) {
+        trade_offsets_.reserve(trades + 1);
+        start_.reserve(rows);
+        end_.reserve(rows);
+        fixing_.reserve(rows);
+        payment_.reserve(rows);
+        accrued_.reserve(rows);
+    }
+
+    void ScheduleTable::clear() {
+        trade_offsets_.assign(1, 0);
+        start_.clear();
+        end_.clear();
+        fixing_.clear();
+        payment_.clear();
+        accrued_.clear();
+    }
+
+    ScheduleTable::offset_type ScheduleTable::encode(const QuantLib::Date& d) const {
+        const serial_type offset = d.serialNumber() - epoch_;
+        if (offset < 0 || offset > std::numeric_limits<offset_type>::max())
+            throw std::out_of_range("ScheduleTable: date " + Date(d).get_date_str() +
+                                    " is outside the range of the table's epoch " + Date(epoch()).get_date_str());
+        return static_cast<offset_type>(offset);
+    }
+
+    void ScheduleTable::append(const std::vector<ScheduleRow>& rows) {
+        if (row_count() + rows.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("ScheduleTable: too many rows");
+
+        // Rows are appended as they are encoded; if a date doesn't fit (or an allocation fails) the columns are cut
+        // back to where they were, so a failed append leaves the table as it was
+        const std::size_t n = row_count();
+        try {
+            for (const auto& r : rows) {
+                start_.push_back(encode(r.startDate));
+                end_.push_back(encode(r.endDate));
+                fixing_.push_back(encode(r.fixingDate));
+                payment_.push_back(encode(r.paymentDate));
+                accrued_.push_back(r.accrued);
+            }
+            trade_offsets_.push_back(static_cast<std::uint32_t>(row_count()));
+        } catch (...) {
+            start_.resize(n);
+            end_.resize(n);
+            fixing_.resize(n);
+            payment_.resize(n);
+            accrued_.resize(n);
+            throw;
+        }
+    }
+
+    void ScheduleTable::decode(std::span<const offset_type> column, std::span<serial_type> out) const {
+        if (out.size() < column.size())
+            throw std::invalid_argument("ScheduleTable::decode: output buffer is smaller than the input");
+        for (std::size_t i = 0; i < column.size(); ++i)
+            out[i] = epoch_ + column[i];
+    }
+
+    ScheduleRow ScheduleTable::row(std::size_t i) const {
+        return ScheduleRow{ to_date(start_[i]), to_date(end_[i]), to_date(fixing_[i]), to_date(payment_[i]),
+                            accrued_[i] };
+    }
+
+    std::vector<ScheduleRow> ScheduleTable::trade_rows(std::size_t t) const {
+        std::vector<ScheduleRow> out;
+        out.reserve(trade_end(t) - trade_begin(t));
+        for (std::size_t i = trade_begin(t); i < trade_end(t); ++i)
+            out.push_back(row(i));
+        return out;
+    }
+
+    std::size_t ScheduleTable::memory_bytes() const {
+        return trade_offsets_.capacity() * sizeof(std::uint32_t)
+             + (start_.capacity() + end_.capacity() + fixing_.capacity() + payment_.capacity()) * sizeof(offset_type)
+             + accrued_.capacity() * sizeof(double);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Date/utilities.h"
+
+#include <ql/time/date.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Columnar (structure-of-arrays) storage for the schedules of many trades
+    // A std::vector<ScheduleRow> per trade costs 40 bytes a row (four 8-byte QuantLib::Date plus the accrual) and one
+    // heap block per trade. Here each field is its own contiguous column across all trades:
+    //   - dates are 16-bit day offsets from the table's epoch (65535 days, about 179 years of range)
+    //   - accruals are doubles
+    //   - trade t owns rows [trade_begin(t), trade_end(t))
+    // which is 16 bytes a row plus 4 bytes a trade, and lets cashflow kernels stream over just the columns they use.
+    class ScheduleTable {
+        public:
+            using offset_type = std::uint16_t;
+
+            static constexpr std::size_t bytes_per_row = 4 * sizeof(offset_type) + sizeof(double);
+
+            // The default epoch covers 01-01-1950 to 06-06-2129
+            explicit ScheduleTable(const QuantLib::Date& epoch = QuantLib::Date(1, QuantLib::January, 1950));
+
+            void reserve(std::size_t trades, std::size_t rows);
+            void clear();
+
+            // Adds one trade, throws std::out_of_range if a date doesn't fit the 16-bit encoding
+            void append(const std::vector<ScheduleRow>& rows);
+
+            std::size_t trade_count() const { return trade_offsets_.size() - 1; }
+            std::size_t row_count() const { return accrued_.size(); }
+            std::size_t trade_begin(std::size_t t) const { return trade_offsets_[t]; }
+            std::size_t trade_end(std::size_t t) const { return trade_offsets_[t + 1]; }
+            std::span<const std::uint32_t> trade_offsets() const { return trade_offsets_; }
+
+            // Columns, dates are day offsets from epoch()
+            std::span<const offset_type> start_dates() const { return start_; }
+            std::span<const offset_type> end_dates() const { return end_; }
+            std::span<const offset_type> fixing_dates() const { return fixing_; }
+            std::span<const offset_type> payment_dates() const { return payment_; }
+            std::span<const double> accrued() const { return accrued_; }
+
+            QuantLib::Date epoch() const { return QuantLib::Date(epoch_); }
+            serial_type to_serial(offset_type offset) const { return epoch_ + offset; }
+            QuantLib::Date to_date(offset_type offset) const { return QuantLib::Date(to_serial(offset)); }
+
+            // Widens a whole date column (or part of one) back to serials
+            // Throws std::invalid_argument if out is shorter than column
+            void decode(std::span<const offset_type> column, std::span<serial_type> out) const;
+
+            // Back to the row representation
+            ScheduleRow row(std::size_t i) const;
+            std::vector<ScheduleRow> trade_rows(std::size_t t) const;
+
+            // Bytes held by the columns (capacity, not size), for footprint comparisons
+            std::size_t memory_bytes() const;
+
+        private:
+            offset_type encode(const QuantLib::Date& d) const;
+
+            serial_type epoch_;
+            std::vector<std::uint32_t> trade_offsets_;  // trade_count() + 1 entries, starts with 0
+            std::vector<offset_type> start_;
+            std::vector<offset_type> end_;
+            std::vector<offset_type> fixing_;
+            std::vector<offset_type> payment_;
+            std::vector<double> accrued_;
+    };
+
+}
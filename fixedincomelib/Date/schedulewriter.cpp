@@ -0,0 +1,174 @@
+#include "fixedincomelib/Date/schedulewriter.h"
+#include "fixedincomelib/Date/format.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace fixedincomelib {
+    namespace {
+        constexpr std::array<std::string_view, 5> headers = {
+            "StartDate", "EndDate", "FixingDate", "PaymentDate", "Accrued"
+        };
+
+        // Same digits the aligned table has always printed (std::fixed, std::setprecision(6))
+        constexpr int text_precision = 6;
+
+        // Largest line any sink writes for one row: four dates, separators and one number
+        constexpr std::size_t max_line_size = 128 + format_double_max_size;
+
+        char* pad(char* p, std::size_t n) {
+            std::fill_n(p, n, ' ');
+            return p + n;
+        }
+
+        char* put(std::string_view s, char* p) {
+            return std::copy(s.begin(), s.end(), p);
+        }
+    }
+
+    ScheduleFormat schedule_format_from_string(std::string_view s) {
+        std::string key;
+        key.reserve(s.size());
+        for (char ch : s)
+            key.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(ch))));
+
+        if (key == "TEXT") return ScheduleFormat::Text;
+        if (key == "CSV") return ScheduleFormat::Csv;
+        if (key == "JSONL" || key == "JSON_LINES") return ScheduleFormat::JsonLines;
+        throw std::invalid_argument("Unknown schedule format: " + std::string(s));
+    }
+
+    // ---------- aligned text ----------
+
+    void AlignedTextSink::begin(std::span<const ScheduleRow> rows) {
+        for (std::size_t j = 0; j < 5; ++j) widths_[j] = headers[j].size();
+
+        // Dates always print as 10 chars, only the accrual column depends on the values
+        char buf[format_double_max_size];
+        for (const ScheduleRow& r : rows) {
+            for (std::size_t j = 0; j < 4; ++j) widths_[j] = std::max(widths_[j], dd_mm_yyyy_size);
+            const char* e = format_double(r.accrued, text_precision, buf, buf + sizeof(buf));
+            widths_[4] = std::max(widths_[4], static_cast<std::size_t>(e - buf));
+        }
+
+        // header
+        for (std::size_t j = 0; j < 5; ++j) {
+            out_.append(headers[j]);
+            out_.append(widths_[j] + 2 - headers[j].size(), ' ');
+        }
+        out_.push_back('\n');
+
+        // separator
+        for (std::size_t j = 0; j < 5; ++j) {
+            out_.append(widths_[j], '-');
+            out_.append("  ");
+        }
+        out_.push_back('\n');
+
+        // Every row has the same length, so one reservation covers the whole table
+        std::size_t line = 1;
+        for (std::size_t w : widths_) line += w + 2;
+        out_.reserve(out_.size() + rows.size() * line);
+    }
+
+    void AlignedTextSink::row(const ScheduleRow& r) {
+        char line[max_line_size];
+        char* p = line;
+
+        const QuantLib::Date* dates[4] = {&r.startDate, &r.endDate, &r.fixingDate, &r.paymentDate};
+        for (std::size_t j = 0; j < 4; ++j) {
+            p = format_dd_mm_yyyy(*dates[j], p);
+            p = pad(p, widths_[j] + 2 - dd_mm_yyyy_size);
+        }
+
+        char num[format_double_max_size];
+        const char* e = format_double(r.accrued, text_precision, num, num + sizeof(num));
+        const std::size_t n = static_cast<std::size_t>(e - num);
+        p = pad(p, widths_[4] + 2 - n);
+        p = std::copy(static_cast<const char*>(num), e, p);
+        *p++ = '\n';
+
+        out_.append(line, p);
+    }
+
+    // ---------- CSV ----------
+
+    void CsvSink::begin(std::span<const ScheduleRow> rows) {
+        for (std::size_t j = 0; j < 5; ++j) {
+            if (j) out_.push_back(',');
+            out_.append(headers[j]);
+        }
+        out_.push_back('\n');
+        out_.reserve(out_.size() + rows.size() * (4 * (dd_mm_yyyy_size + 1) + 20));
+    }
+
+    void CsvSink::row(const ScheduleRow& r) {
+        char line[max_line_size];
+        char* p = line;
+        p = format_dd_mm_yyyy(r.startDate, p);   *p++ = ',';
+        p = format_dd_mm_yyyy(r.endDate, p);     *p++ = ',';
+        p = format_dd_mm_yyyy(r.fixingDate, p);  *p++ = ',';
+        p = format_dd_mm_yyyy(r.paymentDate, p); *p++ = ',';
+        p = format_double(r.accrued, -1, p, line + sizeof(line) - 1);
+        *p++ = '\n';
+        out_.append(line, p);
+    }
+
+    // ---------- JSON lines ----------
+
+    void JsonLinesSink::begin(std::span<const ScheduleRow> rows) {
+        out_.reserve(out_.size() + rows.size() * 128);
+    }
+
+    void JsonLinesSink::row(const ScheduleRow& r) {
+        char line[max_line_size];
+        char* p = line;
+
+        const QuantLib::Date* dates[4] = {&r.startDate, &r.endDate, &r.fixingDate, &r.paymentDate};
+        *p++ = '{';
+        for (std::size_t j = 0; j < 4; ++j) {
+            *p++ = '"';
+            p = put(headers[j], p);
+            p = put("\":\"", p);
+            p = format_dd_mm_yyyy(*dates[j], p);
+            p = put("\",", p);
+        }
+        *p++ = '"';
+        p = put(headers[4], p);
+        p = put("\":", p);
+        // JSON has no NaN or infinity, so those go out as null rather than as text no parser would take
+        if (std::isfinite(r.accrued))
+            p = format_double(r.accrued, -1, p, line + sizeof(line) - 2);
+        else
+            p = put("null", p);
+        *p++ = '}';
+        *p++ = '\n';
+        out_.append(line, p);
+    }
+
+    // ---------- helpers ----------
+
+    std::unique_ptr<ScheduleSink> make_schedule_sink(ScheduleFormat format, std::string& out) {
+        switch (format) {
+            case ScheduleFormat::Text:      return std::make_unique<AlignedTextSink>(out);
+            case ScheduleFormat::Csv:       return std::make_unique<CsvSink>(out);
+            case ScheduleFormat::JsonLines: return std::make_unique<JsonLinesSink>(out);
+        }
+        throw std::invalid_argument("Unknown schedule format");
+    }
+
+    void write_schedule(std::span<const ScheduleRow> rows, ScheduleSink& sink) {
+        sink.begin(rows);
+        for (const ScheduleRow& r : rows)
+            sink.row(r);
+        sink.end();
+    }
+
+    std::string write_schedule(std::span<const ScheduleRow> rows, ScheduleFormat format) {
+        std::string out;
+        write_schedule(rows, *make_schedule_sink(format, out));
+        return out;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "fixedincomelib/Date/utilities.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Writers that turn a schedule into text
+// Rows are formatted straight into one output string through the buffer formatters in Date/format.h, so no
+// per-cell std::string or stream is ever built.
+
+namespace fixedincomelib {
+
+    enum class ScheduleFormat {
+        Text,       // aligned columns, as qfMakeSchedule has always printed
+        Csv,        // header line then one comma separated line per row
+        JsonLines   // one JSON object per row, a non-finite Accrued written as null
+    };
+
+    // "TEXT", "CSV", "JSONL" / "JSON_LINES" (case-insensitive)
+    ScheduleFormat schedule_format_from_string(std::string_view s);
+
+    // A sink receives the whole schedule in begin() (some formats need a pass over it first, e.g. for column
+    // widths), then every row in order, then end(). Output is appended to the string given at construction.
+    class ScheduleSink {
+        public:
+            explicit ScheduleSink(std::string& out): out_(out) {}
+            virtual ~ScheduleSink() = default;
+
+            virtual void begin(std::span<const ScheduleRow> rows) = 0;
+            virtual void row(const ScheduleRow& r) = 0;
+            virtual void end() {}
+
+        protected:
+            std::string& out_;
+    };
+
+    // StartDate  EndDate  FixingDate  PaymentDate  Accrued
+    // Dates are left aligned, the accrual right aligned with 6 decimals
+    class AlignedTextSink : public ScheduleSink {
+        public:
+            using ScheduleSink::ScheduleSink;
+            void begin(std::span<const ScheduleRow> rows) override;
+            void row(const ScheduleRow& r) override;
+
+        private:
+            std::array<std::size_t, 5> widths_{};
+    };
+
+    // Accruals are written with the shortest representation that reads back exactly
+    class CsvSink : public ScheduleSink {
+        public:
+            using ScheduleSink::ScheduleSink;
+            void begin(std::span<const ScheduleRow> rows) override;
+            void row(const ScheduleRow& r) override;
+    };
+
+    class JsonLinesSink : public ScheduleSink {
+        public:
+            using ScheduleSink::ScheduleSink;
+            void begin(std::span<const ScheduleRow> rows) override;
+            void row(const ScheduleRow& r) override;
+    };
+
+    std::unique_ptr<ScheduleSink> make_schedule_sink(ScheduleFormat format, std::string& out);
+
+    void write_schedule(std::span<const ScheduleRow> rows, ScheduleSink& sink);
+    std::string write_schedule(std::span<const ScheduleRow> rows, ScheduleFormat format);
+
+}
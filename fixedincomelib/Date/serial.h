@@ -0,0 +1,66 @@
+#pragma once
+
+#include <ql/time/date.hpp>
+
+// Plain integer calendar arithmetic on QuantLib serial numbers
+// These let hot loops (parsing, formatting, day counting) work on serials directly instead of going through
+// QuantLib::Date accessors one field at a time. Everything here is constexpr and branch-light so the compiler can
+// vectorize loops that call it.
+
+namespace fixedincomelib {
+
+    using serial_type = QuantLib::Date::serial_type;
+
+    // QuantLib only supports dates in [01-01-1901, 31-12-2199]
+    inline constexpr int min_serial_year = 1901;
+    inline constexpr int max_serial_year = 2199;
+
+    constexpr bool is_leap_year(int y) {
+        return (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
+    }
+
+    // Number of days in month m (1-12) of year y, written without a lookup table so it stays vectorizable
+    // 31 for Jan/Mar/May/Jul/Aug/Oct/Dec, 30 for the rest, and 28/29 for February
+    constexpr int days_in_month(int y, int m) {
+        return m == 2 ? 28 + static_cast<int>(is_leap_year(y)) : 30 + ((m ^ (m >> 3)) & 1);
+    }
+
+    // Days since 01-01-1970 in the proleptic Gregorian calendar, negative before it (H. Hinnant's days_from_civil)
+    constexpr long days_from_civil(int y, int m, int d) {
+        y -= m <= 2;
+        const long era = (y >= 0 ? y : y - 399) / 400;
+        const long yoe = y - era * 400;                                  // [0, 399]
+        const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1; // [0, 365]
+        const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;          // [0, 146096]
+        return era * 146097 + doe - 719468;
+    }
+
+    static_assert(days_from_civil(1970, 1, 1) == 0 && days_from_civil(1969, 12, 31) == -1);
+
+    // Inverse of days_from_civil (H. Hinnant's civil_from_days)
+    constexpr void civil_from_days(long z, int& y, int& m, int& d) {
+        z += 719468;
+        const long era = (z >= 0 ? z : z - 146096) / 146097;
+        const long doe = z - era * 146097;                                     // [0, 146096]
+        const long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+        const long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);               // [0, 365]
+        const long mp = (5 * doy + 2) / 153;                                    // [0, 11]
+        d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        y = static_cast<int>(yoe + era * 400 + (m <= 2));
+    }
+
+    // QuantLib serials count days from 30-12-1899 (Excel convention), e.g. 01-01-1901 is serial 367
+    inline constexpr long serial_epoch_offset = days_from_civil(1899, 12, 30);
+
+    constexpr serial_type serial_from_ymd(int y, int m, int d) {
+        return static_cast<serial_type>(days_from_civil(y, m, d) - serial_epoch_offset);
+    }
+
+    constexpr void ymd_from_serial(serial_type s, int& y, int& m, int& d) {
+        civil_from_days(static_cast<long>(s) + serial_epoch_offset, y, m, d);
+    }
+
+    static_assert(serial_from_ymd(1901, 1, 1) == 367, "serials must agree with QuantLib::Date");
+    static_assert(serial_from_ymd(2199, 12, 31) == 109574, "serials must agree with QuantLib::Date");
+}
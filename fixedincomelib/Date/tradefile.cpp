@@ -0,0 +1,154 @@
+#include "fixedincomelib/Date/tradefile.h"
+
+#include <ql/utilities/dataparsers.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+    namespace {
+        std::string_view trim(std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+            return s;
+        }
+
+        bool iequals(std::string_view a, std::string_view b) {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return std::toupper(static_cast<unsigned char>(x)) == std::toupper(static_cast<unsigned char>(y));
+            });
+        }
+    }
+
+    ScheduleSpec ScheduleSpecView::to_spec() const {
+        ScheduleSpec s;
+        s.start_date = start_date;
+        s.end_date = end_date;
+        s.accrual_period = accrual_period;
+        s.holiday_convention = holiday_convention;
+        s.business_day_convention = business_day_convention;
+        s.accrual_basis = accrual_basis;
+        s.rule = rule;
+        s.end_of_month = end_of_month;
+        s.fix_in_arrear = fix_in_arrear;
+        s.fixing_offset = fixing_offset;
+        s.payment_offset = payment_offset;
+        s.payment_business_day_convention = payment_business_day_convention;
+        s.payment_holiday_convention = payment_holiday_convention;
+        return s;
+    }
+
+    QuantLib::Period parse_tenor(std::string_view s) {
+        std::string_view digits = s;
+        const bool negative = !digits.empty() && digits.front() == '-';
+        if (negative || (!digits.empty() && digits.front() == '+')) digits.remove_prefix(1);
+
+        // The common case, a single number and unit
+        if (digits.size() >= 2 && digits.size() <= 6) {
+            int n = 0;
+            bool numeric = true;
+            for (char c : digits.substr(0, digits.size() - 1)) {
+                numeric &= c >= '0' && c <= '9';
+                n = n * 10 + (c - '0');
+            }
+            if (numeric) {
+                n = negative ? -n : n;
+                switch (std::toupper(static_cast<unsigned char>(digits.back()))) {
+                    case 'D': return QuantLib::Period(n, QuantLib::Days);
+                    case 'W': return QuantLib::Period(n, QuantLib::Weeks);
+                    case 'M': return QuantLib::Period(n, QuantLib::Months);
+                    case 'Y': return QuantLib::Period(n, QuantLib::Years);
+                    default: break;
+                }
+            }
+        }
+        if (s.empty()) throw std::invalid_argument("Empty tenor");
+        // Compound tenors like '1Y6M', and QuantLib's own error for anything it can't read either
+        return QuantLib::PeriodParser::parse(std::string(s));
+    }
+
+    bool parse_flag(std::string_view s) {
+        if (s.empty() || iequals(s, "FALSE") || iequals(s, "N") || s == "0") return false;
+        if (iequals(s, "TRUE") || iequals(s, "Y") || s == "1") return true;
+        throw std::invalid_argument("Expected TRUE/FALSE, Y/N or 1/0, got '" + std::string(s) + "'");
+    }
+
+    TradeFileLayout::TradeFileLayout(std::string_view header) {
+        static constexpr std::pair<std::string_view, Field> known[] = {
+            {"trade_id", Field::TradeId},
+            {"start_date", Field::StartDate},
+            {"end_date", Field::EndDate},
+            {"accrual_period", Field::AccrualPeriod},
+            {"holiday_convention", Field::HolidayConvention},
+            {"business_day_convention", Field::BusinessDayConvention},
+            {"accrual_basis", Field::AccrualBasis},
+            {"rule", Field::Rule},
+            {"end_of_month", Field::EndOfMonth},
+            {"fix_in_arrear", Field::FixInArrear},
+            {"fixing_offset", Field::FixingOffset},
+            {"payment_offset", Field::PaymentOffset},
+            {"payment_business_day_convention", Field::PaymentBusinessDayConvention},
+            {"payment_holiday_convention", Field::PaymentHolidayConvention},
+        };
+
+        header = trim(header);
+        for (std::size_t begin = 0; begin <= header.size();) {
+            std::size_t end = header.find(',', begin);
+            if (end == std::string_view::npos) end = header.size();
+            const std::string_view name = trim(header.substr(begin, end - begin));
+
+            Field field = Field::Ignored;
+            for (const auto& [known_name, known_field] : known)
+                if (iequals(name, known_name)) field = known_field;
+            if (field != Field::Ignored && std::find(fields_.begin(), fields_.end(), field) != fields_.end())
+                throw std::invalid_argument("Trade file header has column '" + std::string(name) + "' twice");
+
+            fields_.push_back(field);
+            names_.emplace_back(name);
+            begin = end + 1;
+        }
+
+        for (Field required : {Field::StartDate, Field::EndDate, Field::AccrualPeriod})
+            if (std::find(fields_.begin(), fields_.end(), required) == fields_.end())
+                throw std::invalid_argument("Trade file header needs start_date, end_date and accrual_period columns");
+    }
+
+    void TradeFileLayout::parse(std::string_view line, ScheduleSpecView& spec) const {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        std::size_t begin = 0;
+        for (std::size_t col = 0; col < fields_.size(); ++col) {
+            if (begin > line.size())
+                throw std::invalid_argument("Expected " + std::to_string(fields_.size()) + " columns, got " +
+                                            std::to_string(col));
+            std::size_t end = line.find(',', begin);
+            if (end == std::string_view::npos) end = line.size();
+            const std::string_view value = trim(line.substr(begin, end - begin));
+            begin = end + 1;
+
+            try {
+                switch (fields_[col]) {
+                    case Field::Ignored: break;
+                    case Field::TradeId: spec.trade_id = value; break;
+                    case Field::StartDate: spec.start_date = Date(value); break;
+                    case Field::EndDate: spec.end_date = Date(value); break;
+                    case Field::AccrualPeriod: spec.accrual_period = parse_tenor(value); break;
+                    case Field::HolidayConvention: spec.holiday_convention = value; break;
+                    case Field::BusinessDayConvention: spec.business_day_convention = value; break;
+                    case Field::AccrualBasis: spec.accrual_basis = value; break;
+                    case Field::Rule: spec.rule = value; break;
+                    case Field::EndOfMonth: spec.end_of_month = parse_flag(value); break;
+                    case Field::FixInArrear: spec.fix_in_arrear = parse_flag(value); break;
+                    case Field::FixingOffset: spec.fixing_offset = parse_tenor(value); break;
+                    case Field::PaymentOffset: spec.payment_offset = parse_tenor(value); break;
+                    case Field::PaymentBusinessDayConvention: spec.payment_business_day_convention = value; break;
+                    case Field::PaymentHolidayConvention: spec.payment_holiday_convention = value; break;
+                }
+            } catch (const std::exception& ex) {
+                throw std::invalid_argument("Bad " + names_[col] + " '" + std::string(value) + "': " + ex.what());
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/scheduleengine.h"
+
+#include <ql/time/period.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Trade files: CSV with a header line, one trade per line
+// Columns are matched by name (case-insensitive, any order) against the ScheduleSpec fields:
+//   trade_id, start_date, end_date, accrual_period, holiday_convention, business_day_convention, accrual_basis, rule,
+//   end_of_month, fix_in_arrear, fixing_offset, payment_offset, payment_business_day_convention,
+//   payment_holiday_convention
+// start_date, end_date and accrual_period are required, missing columns take the ScheduleSpec defaults and columns
+// with other names are ignored. Fields are dates, tenors and convention codes, so there is no quoting.
+
+namespace fixedincomelib {
+
+    // ScheduleSpec for one trade file row, with the text fields left as views into the line
+    // Nothing is copied, so the views are only valid as long as the buffer the line came from.
+    struct ScheduleSpecView {
+        std::string_view trade_id;
+        Date start_date;
+        Date end_date;
+        QuantLib::Period accrual_period;
+        std::string_view holiday_convention = "NONE";
+        std::string_view business_day_convention = "NONE";
+        std::string_view accrual_basis = "NONE";
+        std::string_view rule = "BACKWARD";
+        bool end_of_month = false;
+        bool fix_in_arrear = false;
+        QuantLib::Period fixing_offset = QuantLib::Period(0, QuantLib::Days);
+        QuantLib::Period payment_offset = QuantLib::Period(0, QuantLib::Days);
+        std::string_view payment_business_day_convention = "F";
+        std::string_view payment_holiday_convention = "USGS";
+
+        // Owning copy, e.g. to hand to a ScheduleEngine
+        ScheduleSpec to_spec() const;
+    };
+
+    // '3M', '-2D', '10Y' without going through a std::string, anything else is handed to QuantLib's PeriodParser
+    QuantLib::Period parse_tenor(std::string_view s);
+
+    // TRUE/FALSE, Y/N or 1/0 (case-insensitive), an empty field is false
+    bool parse_flag(std::string_view s);
+
+    // Column layout read from a trade file's header line
+    class TradeFileLayout {
+        public:
+            // Throws std::invalid_argument if a required column is missing or a column appears twice
+            explicit TradeFileLayout(std::string_view header);
+
+            // Fills spec from one line (without its line ending), fields the file doesn't have keep their defaults
+            // Throws std::invalid_argument naming the column on a bad field or a short line
+            void parse(std::string_view line, ScheduleSpecView& spec) const;
+
+            std::size_t columns() const { return fields_.size(); }
+
+        private:
+            enum class Field : std::uint8_t {
+                Ignored,
+                TradeId,
+                StartDate,
+                EndDate,
+                AccrualPeriod,
+                HolidayConvention,
+                BusinessDayConvention,
+                AccrualBasis,
+                Rule,
+                EndOfMonth,
+                FixInArrear,
+                FixingOffset,
+                PaymentOffset,
+                PaymentBusinessDayConvention,
+                PaymentHolidayConvention
+            };
+
+            std::vector<Field> fields_;   // by column position
+            std::vector<std::string> names_;   // as written in the header, for error messages
+    };
+
+}
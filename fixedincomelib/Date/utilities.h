@@ -2,6 +2,9 @@
 #pragma once
 
 #include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/bitmapcalendar.h"
+#include "fixedincomelib/Date/yearfraction.h"
+#include "fixedincomelib/utils/instrumentation.h"
 
 #include <ql/time/date.hpp>
 #include <ql/time/period.hpp>
@@ -9,6 +12,8 @@
 #include <ql/time/calendars/unitedstates.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 #include <ql/time/businessdayconvention.hpp>
+#include <algorithm>
+#include <span>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -24,7 +29,7 @@ namespace fixedincomelib {
     };
     
     // add_period: calendar.advance(start, term, bdc, endOfMonth)
-    Date add_period(const Date& start_date,
+    inline Date add_period(const Date& start_date,
                               const Period& term,
                               const QuantLib::Calendar& cal = QuantLib::UnitedStates(QuantLib::UnitedStates::FederalReserve),
                               QuantLib::BusinessDayConvention bdc = QuantLib::Following,
@@ -33,14 +38,14 @@ namespace fixedincomelib {
     }
     
     // move_to_business_day: calendar.adjust(date, bdc)
-    Date move_to_business_day(const Date& input_date,
+    inline Date move_to_business_day(const Date& input_date,
                                         const QuantLib::Calendar& cal,
                                         const QuantLib::BusinessDayConvention bdc) {
         return Date(cal.adjust(input_date.get_date(), bdc));
     }
     
     // accrued: dayCounter.yearFraction(start, adjusted_end)
-    double accrued(const Date& start_date,
+    inline double accrued(const Date& start_date,
                    const Date& end_date,
                    const QuantLib::DayCounter& dc,
                    QuantLib::BusinessDayConvention bdc = QuantLib::Following,
@@ -49,20 +54,58 @@ namespace fixedincomelib {
         return dc.yearFraction(start_date.get_date(), adjusted_end.get_date());
     }
     
-    bool is_business_day(const Date& d, const QuantLib::Calendar& cal) {
+    inline bool is_business_day(const Date& d, const QuantLib::Calendar& cal) {
         return cal.isBusinessDay(d.get_date());
     }
-    bool is_holiday(const Date& d, const QuantLib::Calendar& cal) {
+    inline bool is_holiday(const Date& d, const QuantLib::Calendar& cal) {
         return cal.isHoliday(d.get_date());
     }
-    bool is_end_of_month(const Date& d, const QuantLib::Calendar& cal) {
+    inline bool is_end_of_month(const Date& d, const QuantLib::Calendar& cal) {
         return cal.isEndOfMonth(d.get_date());
     }
-    Date end_of_month(const Date& d, const QuantLib::Calendar& cal) {
+    inline Date end_of_month(const Date& d, const QuantLib::Calendar& cal) {
         return Date(cal.endOfMonth(d.get_date()));
     }
 
-    std::vector<ScheduleRow> make_schedule(
+    // Same utilities on a precomputed BitmapCalendar, where adjust/advance are O(1) instead of a day-by-day walk
+    // For make_schedule (or anything else expecting a QuantLib::Calendar) pass bitmap.calendar() instead
+    inline Date add_period(const Date& start_date,
+                           const Period& term,
+                           const BitmapCalendar& cal,
+                           QuantLib::BusinessDayConvention bdc = QuantLib::Following,
+                           bool end_of_month = false) {
+        return Date(cal.advance(start_date.get_date(), term, bdc, end_of_month));
+    }
+
+    inline Date move_to_business_day(const Date& input_date,
+                                     const BitmapCalendar& cal,
+                                     const QuantLib::BusinessDayConvention bdc) {
+        return Date(cal.adjust(input_date.get_date(), bdc));
+    }
+
+    inline double accrued(const Date& start_date,
+                          const Date& end_date,
+                          const QuantLib::DayCounter& dc,
+                          QuantLib::BusinessDayConvention bdc,
+                          const BitmapCalendar& cal) {
+        Date adjusted_end = move_to_business_day(end_date, cal, bdc);
+        return dc.yearFraction(start_date.get_date(), adjusted_end.get_date());
+    }
+
+    inline bool is_business_day(const Date& d, const BitmapCalendar& cal) {
+        return cal.is_business_day(d.get_date());
+    }
+    inline bool is_holiday(const Date& d, const BitmapCalendar& cal) {
+        return cal.is_holiday(d.get_date());
+    }
+    inline bool is_end_of_month(const Date& d, const BitmapCalendar& cal) {
+        return cal.is_end_of_month(d.get_date());
+    }
+    inline Date end_of_month(const Date& d, const BitmapCalendar& cal) {
+        return Date(cal.end_of_month(d.get_date()));
+    }
+
+    inline std::vector<ScheduleRow> make_schedule(
         const Date& start_date,
         const Date& end_date,
         const QuantLib::Period& accrual_period,
@@ -77,6 +120,8 @@ namespace fixedincomelib {
         QuantLib::BusinessDayConvention payment_business_day_convention = QuantLib::Following,
         const QuantLib::Calendar& payment_holiday_convention = QuantLib::UnitedStates(QuantLib::UnitedStates::FederalReserve)
     ) {
+        FIXEDINCOMELIB_PROBE(make_schedule);
+
         // Rule for date generation is an enum, backward is from termination date to effective date (forward is reversed order)
         QuantLib::DateGeneration::Rule ql_rule = (rule == "BACKWARD" ? QuantLib::DateGeneration::Backward : QuantLib::DateGeneration::Forward);
 
@@ -100,28 +145,44 @@ namespace fixedincomelib {
         std::vector<ScheduleRow> out;
         out.reserve(dates.size() - 1);
 
+        // Accruals are computed a block of periods at a time with the column year-fraction kernels
+        // The schedule dates are already adjusted with this calendar and convention, so the adjustment accrued()
+        // would apply to each end date is a no-op and is skipped
+        constexpr std::size_t block = 64;
+        const YearFractionKernel kernel = year_fraction_kernel(accrual_basis);
+        serial_type starts[block], ends[block];
+        double accruals[block];
+
         // start_dates = dates[:-1], end_dates = dates[1:]
-        for (std::size_t i = 0; i + 1 < dates.size(); ++i) {
-            const QuantLib::Date s = dates[i];
-            const QuantLib::Date e = dates[i + 1];
-
-            // Here our fix-in-arrear indicates whether the fixing is determined at the start/end of an accrual period 
-            // Especially applicable for SOFR swaps where the accrual is determined towards the end
-            QuantLib::Date f = s;
-            if (fixing_offset.length() != 0) {
-                const QuantLib::Date anchor = fix_in_arrear ? e : s;
-                f = holiday_convention.advance(anchor, fixing_offset, business_day_convention, end_of_month);
+        for (std::size_t b = 0; b + 1 < dates.size(); b += block) {
+            const std::size_t n = std::min(block, dates.size() - 1 - b);
+            for (std::size_t i = 0; i < n; ++i) {
+                starts[i] = dates[b + i].serialNumber();
+                ends[i] = dates[b + i + 1].serialNumber();
             }
+            year_fractions(kernel, accrual_basis, std::span<const serial_type>(starts, n),
+                           std::span<const serial_type>(ends, n), std::span<double>(accruals, n));
 
-            // To account for payment offset 
-            QuantLib::Date p = e;
-            if (payment_offset.length() != 0) {
-                p = payment_holiday_convention.advance(e, payment_offset, payment_business_day_convention, end_of_month);
-            }
+            for (std::size_t i = 0; i < n; ++i) {
+                const QuantLib::Date s = dates[b + i];
+                const QuantLib::Date e = dates[b + i + 1];
+
+                // Here our fix-in-arrear indicates whether the fixing is determined at the start/end of an accrual period 
+                // Especially applicable for SOFR swaps where the accrual is determined towards the end
+                QuantLib::Date f = s;
+                if (fixing_offset.length() != 0) {
+                    const QuantLib::Date anchor = fix_in_arrear ? e : s;
+                    f = holiday_convention.advance(anchor, fixing_offset, business_day_convention, end_of_month);
+                }
 
-            // Compute accrued year fraction 
-            double acc = accrued(Date(s), Date(e),  accrual_basis, business_day_convention, holiday_convention);
-            out.push_back(ScheduleRow{ s, e, f, p, acc });
+                // To account for payment offset 
+                QuantLib::Date p = e;
+                if (payment_offset.length() != 0) {
+                    p = payment_holiday_convention.advance(e, payment_offset, payment_business_day_convention, end_of_month);
+                }
+
+                out.push_back(ScheduleRow{ s, e, f, p, accruals[i] });
+            }
         }
 
         return out;
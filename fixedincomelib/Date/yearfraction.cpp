@@ -0,0 +1,232 @@
+#include "fixedincomelib/Date/yearfraction.h"
+
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/actualactual.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define FIXEDINCOMELIB_YEARFRACTION_AVX2 1
+#else
+    #define FIXEDINCOMELIB_YEARFRACTION_AVX2 0
+#endif
+
+namespace fixedincomelib {
+    namespace {
+        // The kernels work in 32-bit ints: every serial QuantLib accepts fits, unsigned division by a constant
+        // vectorizes as a multiply, and AVX2 can convert int32 (but not int64) lanes to double
+
+        // Days since 01-03-0000 of serial 0 (30-12-1899), keeps all the intermediate values positive
+        constexpr unsigned serial_shift = static_cast<unsigned>(serial_epoch_offset + 719468);
+
+        struct Civil {
+            unsigned y, m, d;
+        };
+
+        // civil_from_days (Date/serial.h) restricted to positive days, without branches
+        inline Civil civil(unsigned s) {
+            const unsigned z = s + serial_shift;
+            const unsigned era = z / 146097;
+            const unsigned doe = z - era * 146097;
+            const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp = (5 * doy + 2) / 153;
+            const unsigned march_based = mp >= 10;
+            return Civil{yoe + era * 400 + march_based, mp + 3 - 12 * march_based, doy - (153 * mp + 2) / 5 + 1};
+        }
+
+        inline unsigned leap(unsigned y) {
+            return static_cast<unsigned>(((y % 4 == 0) & (y % 100 != 0)) | (y % 400 == 0));
+        }
+
+        // Serial of 01-01-y
+        inline unsigned jan1(unsigned y) {
+            const unsigned p = y - 1;
+            return 365 * p + p / 4 - p / 100 + p / 400 - (365 * 1900 + 1900 / 4 - 1900 / 100 + 1900 / 400) + 367;
+        }
+
+        // QuantLib: daysBetween(d1, d2) / 360.0
+        inline double act360(serial_type s, serial_type e) {
+            return static_cast<double>(static_cast<int>(e - s)) / 360.0;
+        }
+
+        // QuantLib: daysBetween(d1, d2) / 365.0
+        inline double act365f(serial_type s, serial_type e) {
+            return static_cast<double>(static_cast<int>(e - s)) / 365.0;
+        }
+
+        // QuantLib's Thirty360::ISDA: 31st -> 30th on both sides, last day of February -> 30th on both sides (no
+        // termination date is set by accrualbasis_from_string), then 360 * dy + 30 * dm + dd over 360.0
+        inline double thirty360_isda(serial_type s, serial_type e) {
+            const Civil a = civil(static_cast<unsigned>(s));
+            const Civil b = civil(static_cast<unsigned>(e));
+            const unsigned a_feb_end = (a.m == 2) & (a.d == 28 + leap(a.y));
+            const unsigned b_feb_end = (b.m == 2) & (b.d == 28 + leap(b.y));
+            const int d1 = (a.d == 31) | a_feb_end ? 30 : static_cast<int>(a.d);
+            const int d2 = (b.d == 31) | b_feb_end ? 30 : static_cast<int>(b.d);
+            const int days = 360 * (static_cast<int>(b.y) - static_cast<int>(a.y)) +
+                             30 * (static_cast<int>(b.m) - static_cast<int>(a.m)) + (d2 - d1);
+            return static_cast<double>(days) / 360.0;
+        }
+
+        // QuantLib's ActualActual::ISDA: for d1 < d2
+        //   sum = y2 - y1 - 1; sum += days(d1, 01-01-(y1+1)) / dib1; sum += days(01-01-y2, d2) / dib2
+        // negated for d1 > d2 and exactly 0 for d1 == d2
+        inline double actact_isda(serial_type s, serial_type e) {
+            const unsigned lo = static_cast<unsigned>(s < e ? s : e);
+            const unsigned hi = static_cast<unsigned>(s < e ? e : s);
+            const unsigned y1 = civil(lo).y;
+            const unsigned y2 = civil(hi).y;
+            const double dib1 = leap(y1) ? 366.0 : 365.0;
+            const double dib2 = leap(y2) ? 366.0 : 365.0;
+            double sum = static_cast<double>(static_cast<int>(y2 - y1) - 1);
+            sum += static_cast<double>(static_cast<int>(jan1(y1 + 1) - lo)) / dib1;
+            sum += static_cast<double>(static_cast<int>(hi - jan1(y2))) / dib2;
+            const double signed_sum = s < e ? sum : -sum;
+            return s == e ? 0.0 : signed_sum;
+        }
+
+        template <double (*Kernel)(serial_type, serial_type)>
+        inline void apply(const serial_type* s, const serial_type* e, double* out, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = Kernel(s[i], e[i]);
+        }
+
+        // The same loops compiled for the baseline target and for AVX2; with GCC/Clang optimising (-O3 for GCC,
+        // which Release builds use) both are vectorized, the AVX2 one four doubles / eight int32 lanes wide
+        inline void run(YearFractionKernel k, const serial_type* s, const serial_type* e, double* out, std::size_t n) {
+            switch (k) {
+                case YearFractionKernel::Actual360:        apply<act360>(s, e, out, n); break;
+                case YearFractionKernel::Actual365Fixed:   apply<act365f>(s, e, out, n); break;
+                case YearFractionKernel::Thirty360Isda:    apply<thirty360_isda>(s, e, out, n); break;
+                case YearFractionKernel::ActualActualIsda: apply<actact_isda>(s, e, out, n); break;
+                case YearFractionKernel::Generic:          break;
+            }
+        }
+
+        void run_baseline(YearFractionKernel k, const serial_type* s, const serial_type* e, double* out,
+                          std::size_t n) {
+            run(k, s, e, out, n);
+        }
+
+#if FIXEDINCOMELIB_YEARFRACTION_AVX2
+        __attribute__((target("avx2")))
+        void run_avx2(YearFractionKernel k, const serial_type* s, const serial_type* e, double* out, std::size_t n) {
+            run(k, s, e, out, n);
+        }
+
+        bool cpu_has_avx2() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        }
+#endif
+
+        using RunFn = void (*)(YearFractionKernel, const serial_type*, const serial_type*, double*, std::size_t);
+
+        RunFn select_run() {
+#if FIXEDINCOMELIB_YEARFRACTION_AVX2
+            if (cpu_has_avx2()) return run_avx2;
+#endif
+            return run_baseline;
+        }
+
+        RunFn runner() {
+            static const RunFn fn = select_run();
+            return fn;
+        }
+
+        // Checks a kernel against QuantLib's own implementation on the dates where conventions usually differ
+        bool agrees_with_quantlib(YearFractionKernel k, const QuantLib::DayCounter& dc) {
+            const int years[] = {1999, 2000, 2023, 2024, 2100};
+            const int month_days[][2] = {{1, 1}, {1, 31}, {2, 27}, {2, 28}, {2, 29}, {3, 1}, {3, 30}, {3, 31},
+                                         {6, 30}, {7, 31}, {8, 15}, {12, 30}, {12, 31}};
+            std::vector<serial_type> dates;
+            for (int y : years)
+                for (const auto& md : month_days)
+                    if (md[1] <= days_in_month(y, md[0]))
+                        dates.push_back(serial_from_ymd(y, md[0], md[1]));
+
+            std::vector<serial_type> s, e;
+            for (std::size_t i = 0; i < dates.size(); ++i) {
+                for (std::size_t j = 0; j < dates.size(); j += 3) {
+                    s.push_back(dates[i]);
+                    e.push_back(dates[j]);
+                }
+            }
+
+            std::vector<double> fast(s.size());
+            runner()(k, s.data(), e.data(), fast.data(), s.size());
+            for (std::size_t i = 0; i < s.size(); ++i)
+                if (fast[i] != dc.yearFraction(QuantLib::Date(s[i]), QuantLib::Date(e[i])))
+                    return false;
+            return true;
+        }
+
+        struct Candidate {
+            YearFractionKernel kernel;
+            std::string name;
+            bool valid;
+
+            Candidate(YearFractionKernel k, const QuantLib::DayCounter& dc)
+                : kernel(k), name(dc.name()), valid(agrees_with_quantlib(k, dc)) {}
+        };
+
+        // Built and checked once per process
+        const std::vector<Candidate>& candidates() {
+            static const std::vector<Candidate> list = {
+                Candidate(YearFractionKernel::Actual360, QuantLib::Actual360()),
+                Candidate(YearFractionKernel::Actual365Fixed, QuantLib::Actual365Fixed()),
+                Candidate(YearFractionKernel::Thirty360Isda, QuantLib::Thirty360(QuantLib::Thirty360::ISDA)),
+                Candidate(YearFractionKernel::ActualActualIsda, QuantLib::ActualActual(QuantLib::ActualActual::ISDA)),
+            };
+            return list;
+        }
+    }
+
+    YearFractionKernel year_fraction_kernel(const QuantLib::DayCounter& dc) {
+        if (dc.empty()) return YearFractionKernel::Generic;
+        const std::string name = dc.name();
+        for (const Candidate& c : candidates())
+            if (c.name == name)
+                return c.valid ? c.kernel : YearFractionKernel::Generic;
+        return YearFractionKernel::Generic;
+    }
+
+    void year_fractions(const QuantLib::DayCounter& dc,
+                        std::span<const serial_type> start,
+                        std::span<const serial_type> end,
+                        std::span<double> out) {
+        year_fractions(year_fraction_kernel(dc), dc, start, end, out);
+    }
+
+    void year_fractions(YearFractionKernel kernel,
+                        const QuantLib::DayCounter& dc,
+                        std::span<const serial_type> start,
+                        std::span<const serial_type> end,
+                        std::span<double> out) {
+        if (start.size() != end.size())
+            throw std::invalid_argument("year_fractions: start and end columns differ in length");
+        if (out.size() < start.size())
+            throw std::invalid_argument("year_fractions: output buffer is smaller than the input");
+
+        if (kernel == YearFractionKernel::Generic) {
+            for (std::size_t i = 0; i < start.size(); ++i)
+                out[i] = dc.yearFraction(QuantLib::Date(start[i]), QuantLib::Date(end[i]));
+            return;
+        }
+        runner()(kernel, start.data(), end.data(), out.data(), start.size());
+    }
+
+    bool year_fractions_use_avx2() {
+#if FIXEDINCOMELIB_YEARFRACTION_AVX2
+        return runner() == run_avx2;
+#else
+        return false;
+#endif
+    }
+}
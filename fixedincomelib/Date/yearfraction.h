@@ -0,0 +1,48 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+
+#include <ql/time/daycounter.hpp>
+
+#include <span>
+
+// Column year fractions for the day counters accrualbasis_from_string hands out
+// For ACT/360, ACT/365 (Fixed), 30/360 ISDA and ACT/ACT ISDA a year fraction is plain integer arithmetic on the two
+// serials, so instead of one virtual DayCounter::yearFraction per period we run a branch-free loop over the whole
+// column. The loop is built twice, for the baseline target and for AVX2, and the AVX2 build is picked at runtime when
+// the CPU has it. Every kernel follows QuantLib's own order of operations, so results are bit for bit the same.
+//
+// Anything else (Business252, Simple, ...) goes through dc.yearFraction as before.
+
+namespace fixedincomelib {
+
+    enum class YearFractionKernel {
+        Generic,            // no kernel, call dc.yearFraction per row
+        Actual360,
+        Actual365Fixed,
+        Thirty360Isda,
+        ActualActualIsda
+    };
+
+    // Which kernel reproduces dc, decided by comparing with QuantLib's own instances (DayCounter equality is by name)
+    // The first time a kernel is selected it is checked against QuantLib on a set of awkward dates (month ends,
+    // February, year boundaries, reversed periods); if the linked QuantLib disagrees that kernel is never used.
+    YearFractionKernel year_fraction_kernel(const QuantLib::DayCounter& dc);
+
+    // out[i] = dc.yearFraction(start[i], end[i])
+    void year_fractions(const QuantLib::DayCounter& dc,
+                        std::span<const serial_type> start,
+                        std::span<const serial_type> end,
+                        std::span<double> out);
+
+    // Same with the kernel already chosen, for callers that run many columns with one day counter
+    void year_fractions(YearFractionKernel kernel,
+                        const QuantLib::DayCounter& dc,
+                        std::span<const serial_type> start,
+                        std::span<const serial_type> end,
+                        std::span<double> out);
+
+    // True when the AVX2 build of the kernels is in use on this machine
+    bool year_fractions_use_avx2();
+
+}
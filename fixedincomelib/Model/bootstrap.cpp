@@ -0,0 +1,165 @@
+#include "fixedincomelib/Model/bootstrap.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/utils/instrumentation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace fixedincomelib {
+    namespace {
+        // Residual is a PV per unit notional, so this is well below a hundredth of a basis point on any instrument
+        constexpr double pv_tolerance = 1e-14;
+        constexpr int max_iterations = 50;
+
+        struct Flow {
+            serial_type date;
+            double fixed;
+            double rate;
+        };
+
+        // Cashflows of one instrument per unit notional, PV(quote) = sum (fixed + rate * quote) * DF(date) = 0
+        std::vector<Flow> instrument_flows(const CurveInstrument& inst, const QuantLib::Date& spot) {
+            const QuantLib::Calendar& cal = conventions().calendar(inst.calendar);
+            const QuantLib::DayCounter& dc = conventions().day_counter(inst.accrual_basis);
+            const QuantLib::BusinessDayConvention bdc = conventions().bdc(inst.business_day_convention);
+
+            std::vector<Flow> flows{{spot.serialNumber(), -1.0, 0.0}};
+            if (inst.kind == CurveInstrument::Kind::Deposit) {
+                const QuantLib::Date end = cal.advance(spot, inst.tenor, bdc);
+                flows.push_back({end.serialNumber(), 1.0, dc.yearFraction(spot, end)});
+                return flows;
+            }
+
+            // Single-curve par swap: the float leg is worth DF(spot) - DF(maturity), so receiving fixed is
+            // -DF(spot) + quote * sum accrued_i * DF(pay_i) + DF(maturity)
+            const std::vector<ScheduleRow> rows =
+                make_schedule(Date(spot), Date(spot + inst.tenor), inst.fixed_frequency, cal, bdc, dc, "BACKWARD",
+                              false, false, QuantLib::Period(0, QuantLib::Days), QuantLib::Period(0, QuantLib::Days),
+                              bdc, cal);
+            if (rows.empty()) throw std::invalid_argument("CurveBootstrapper: swap has no fixed coupons");
+            for (const ScheduleRow& r : rows)
+                flows.push_back({r.paymentDate.serialNumber(), 0.0, r.accrued});
+            flows.back().fixed = 1.0;
+            return flows;
+        }
+    }
+
+    CurveBootstrapper::CurveBootstrapper(const QuantLib::Date& reference_date,
+                                         std::vector<CurveInstrument> instruments,
+                                         const QuantLib::Date& spot_date)
+        : instruments_(std::move(instruments)),
+          reference_(reference_date.serialNumber()),
+          spot_(spot_date == QuantLib::Date() ? reference_ : spot_date.serialNumber()) {
+        const std::size_t n = instruments_.size();
+        if (n == 0) throw std::invalid_argument("CurveBootstrapper: no instruments");
+        if (spot_ < reference_) throw std::invalid_argument("CurveBootstrapper: spot date is before the reference date");
+
+        // Pillars first, every instrument's flows are then placed among them
+        std::vector<std::vector<Flow>> flows(n);
+        pillars_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            flows[i] = instrument_flows(instruments_[i], QuantLib::Date(spot_));
+            serial_type maturity = 0;
+            for (const Flow& f : flows[i]) maturity = std::max(maturity, f.date);
+            const serial_type previous = i == 0 ? spot_ : pillars_.back();
+            if (maturity <= previous)
+                throw std::invalid_argument("CurveBootstrapper: instrument " + std::to_string(i) + " matures " +
+                                            Date(QuantLib::Date(maturity)).get_date_str() + ", not after " +
+                                            Date(QuantLib::Date(previous)).get_date_str());
+            pillars_.push_back(maturity);
+        }
+
+        cashflows_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            cashflows_[i].reserve(flows[i].size());
+            for (const Flow& f : flows[i]) {
+                // Node 0 is the reference date, node k + 1 is pillar k
+                const std::size_t k = static_cast<std::size_t>(
+                    std::lower_bound(pillars_.begin(), pillars_.end(), f.date) - pillars_.begin());
+                const serial_type lo = k == 0 ? reference_ : pillars_[k - 1];
+                const double w = static_cast<double>(f.date - lo) / static_cast<double>(pillars_[k] - lo);
+                cashflows_[i].push_back(Cashflow{k + 1, w, f.fixed, f.rate});
+            }
+        }
+
+        // First guesses for the solver, the quote as a continuously compounded zero rate
+        log_df_.assign(n + 1, 0.0);
+        for (std::size_t i = 0; i < n; ++i)
+            log_df_[i + 1] = -instruments_[i].quote * static_cast<double>(pillars_[i] - reference_) / 365.0;
+        dfs_.resize(n);
+    }
+
+    void CurveBootstrapper::set_quote(std::size_t i, double quote) {
+        if (i >= instruments_.size())
+            throw std::out_of_range("CurveBootstrapper: no instrument " + std::to_string(i));
+        ++stats_.ticks;
+        instruments_[i].quote = quote;
+
+        const bool was_current = !stale() && curve_.has_value();
+        first_stale_ = std::min(first_stale_, i);
+        if (was_current)
+            for (auto& [id, on_stale] : subscribers_) on_stale();
+    }
+
+    void CurveBootstrapper::solve(std::size_t i) {
+        const std::size_t node = i + 1;
+        const double q = instruments_[i].quote;
+        double x = log_df_[node];
+
+        for (int iteration = 1; iteration <= max_iterations; ++iteration) {
+            ++stats_.newton_iterations;
+            double pv = 0.0, dpv = 0.0;
+            for (const Cashflow& cf : cashflows_[i]) {
+                const double hi = cf.segment == node ? x : log_df_[cf.segment];
+                const double v = (cf.fixed + cf.rate * q) *
+                                 std::exp((1.0 - cf.weight) * log_df_[cf.segment - 1] + cf.weight * hi);
+                pv += v;
+                if (cf.segment == node) dpv += v * cf.weight;
+            }
+
+            if (std::abs(pv) <= pv_tolerance) {
+                log_df_[node] = x;
+                ++stats_.pillars_solved;
+                return;
+            }
+            if (!(dpv != 0.0) || !std::isfinite(pv)) break;
+            x -= pv / dpv;
+        }
+        throw std::runtime_error("CurveBootstrapper: no discount factor reprices instrument " + std::to_string(i) +
+                                 " at quote " + std::to_string(q));
+    }
+
+    const YieldCurve& CurveBootstrapper::curve() {
+        if (stale() || !curve_) {
+            FIXEDINCOMELIB_PROBE(bootstrap_resolve);
+            const auto t0 = std::chrono::steady_clock::now();
+
+            for (std::size_t i = first_stale_; i < instruments_.size(); ++i) solve(i);
+            first_stale_ = instruments_.size();
+
+            for (std::size_t i = 0; i < dfs_.size(); ++i) dfs_[i] = std::exp(log_df_[i + 1]);
+            if (curve_)
+                curve_->set_discount_factors(dfs_);
+            else
+                curve_.emplace(QuantLib::Date(reference_), pillars_, dfs_, CurveInterpolation::LogLinearDiscount);
+            ++version_;
+
+            ++stats_.solves;
+            stats_.solve_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+        return *curve_;
+    }
+
+    std::size_t CurveBootstrapper::subscribe(std::function<void()> on_stale) {
+        subscribers_.emplace_back(next_subscriber_, std::move(on_stale));
+        return next_subscriber_++;
+    }
+
+    void CurveBootstrapper::unsubscribe(std::size_t id) {
+        std::erase_if(subscribers_, [id](const auto& s) { return s.first == id; });
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // A quoted instrument the curve is bootstrapped from, starting on the bootstrapper's spot date
+    //   Deposit: simple rate from spot to spot + tenor
+    //   Swap: par rate of a fixed leg (make_schedule at fixed_frequency) against a float leg on the same curve
+    // Conventions are the usual codes (market/basics.h) and are resolved through the ConventionRegistry.
+    struct CurveInstrument {
+        enum class Kind { Deposit, Swap };
+
+        Kind kind = Kind::Swap;
+        QuantLib::Period tenor;
+        double quote = 0.0;
+        QuantLib::Period fixed_frequency = QuantLib::Period(1, QuantLib::Years);
+        std::string calendar = "USGS";
+        std::string business_day_convention = "MF";
+        std::string accrual_basis = "ACT/360";
+    };
+
+    struct BootstrapStats {
+        std::uint64_t ticks = 0;              // set_quote calls
+        std::uint64_t solves = 0;             // curve() calls that had work to do
+        std::uint64_t pillars_solved = 0;
+        std::uint64_t newton_iterations = 0;
+        double solve_seconds = 0.0;           // inside curve(), re-solving and rebuilding
+
+        double micros_per_tick() const { return ticks > 0 ? solve_seconds * 1e6 / static_cast<double>(ticks) : 0.0; }
+        double iterations_per_pillar() const {
+            return pillars_solved > 0 ? static_cast<double>(newton_iterations) / static_cast<double>(pillars_solved)
+                                      : 0.0;
+        }
+    };
+
+    // Bootstraps a log-linear YieldCurve from deposits and swaps, one pillar per instrument, and keeps it current as
+    // quotes tick
+    // Each instrument's cashflows are laid out once, when the bootstrapper is built: every date (spot, coupon
+    // payments, maturity) is pinned to the curve segment it falls in and its interpolation weight. Pillar k's log
+    // discount factor then solves a one-dimensional equation in which only the dates in segment k move, by Newton
+    // with an analytic derivative.
+    //
+    // Log-linear interpolation is local, so a new quote on instrument i leaves pillars before i as they were:
+    // set_quote only records the quote and the first stale pillar (and tells subscribers, once, that the curve is
+    // stale). The next curve() re-solves from that pillar on, each Newton solve starting from the pillar's previous
+    // value, which after a tick of a few basis points is one or two iterations.
+    //
+    // Not thread-safe: ticks and curve() are expected on one thread.
+    class CurveBootstrapper {
+        public:
+            // Instruments must mature in strictly increasing order (one pillar each)
+            // Throws std::invalid_argument otherwise, or if a maturity isn't after the spot date
+            CurveBootstrapper(const QuantLib::Date& reference_date,
+                              std::vector<CurveInstrument> instruments,
+                              const QuantLib::Date& spot_date = QuantLib::Date());
+
+            std::size_t size() const { return instruments_.size(); }
+            const CurveInstrument& instrument(std::size_t i) const { return instruments_[i]; }
+            double quote(std::size_t i) const { return instruments_[i].quote; }
+            QuantLib::Date pillar(std::size_t i) const { return QuantLib::Date(pillars_[i]); }
+
+            // Records a new quote, no solving happens until the next curve()
+            void set_quote(std::size_t i, double quote);
+
+            // Re-solves whatever is stale, then returns the curve; throws std::runtime_error if a pillar fails to
+            // converge. The reference stays valid for the bootstrapper's lifetime, later ticks update it in place.
+            const YieldCurve& curve();
+
+            bool stale() const { return first_stale_ < instruments_.size(); }
+
+            // Bumped every time curve() produces a new curve, for consumers that poll
+            std::uint64_t version() const { return version_; }
+
+            // on_stale runs inside set_quote when the curve goes from current to stale, not on every tick, so
+            // consumers can mark themselves dirty and pull curve() when they need it. Callbacks must not subscribe or
+            // unsubscribe.
+            std::size_t subscribe(std::function<void()> on_stale);
+            void unsubscribe(std::size_t id);
+
+            const BootstrapStats& stats() const { return stats_; }
+            void reset_stats() { stats_ = BootstrapStats{}; }
+
+        private:
+            // A cashflow of (fixed + rate * quote) at a date, which sits in segment k at weight w:
+            // log DF(date) = (1 - w) * log DF[k-1] + w * log DF[k], with log DF[0] = 0 at the reference date
+            struct Cashflow {
+                std::size_t segment;
+                double weight;
+                double fixed;
+                double rate;
+            };
+
+            void solve(std::size_t k);
+
+            std::vector<CurveInstrument> instruments_;
+            serial_type reference_;
+            serial_type spot_;
+            std::vector<serial_type> pillars_;
+            std::vector<std::vector<Cashflow>> cashflows_;   // by instrument
+
+            std::vector<double> log_df_;       // solver state by node (0 the reference date), warm start for the next solve
+            std::vector<double> dfs_;          // scratch for building the curve
+            std::size_t first_stale_ = 0;
+            std::optional<YieldCurve> curve_;   // built by the first curve(), updated in place after that
+            std::uint64_t version_ = 0;
+
+            std::vector<std::pair<std::size_t, std::function<void()>>> subscribers_;
+            std::size_t next_subscriber_ = 0;
+
+            BootstrapStats stats_;
+    };
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+// Interpolation math shared by YieldCurve (on doubles) and the adjoint valuation in Model/curvesensitivity.h (on
+// aad::Active), so both run exactly the same formulas. Branches are taken on values, through value(x).
+
+namespace fixedincomelib::curve_detail {
+
+    // Time on the curve is ACT/365 from the reference date
+    inline constexpr double days_per_year = 365.0;
+
+    inline double value(double x) { return x; }
+
+    // Integral over [0, x] of g, the instantaneous forward less the segment's discrete forward in units of the
+    // segment length, for Hagan-West's monotone convex interpolation (Hagan & West, "Interpolation Methods for Curve
+    // Construction", 2006). g0 and g1 are g at both ends; the integral over the whole segment is 0, which is what
+    // keeps the curve on its pillars.
+    template <class T>
+    T monotone_convex_integral(const T& g0, const T& g1, double x) {
+        const double v0 = value(g0), v1 = value(g1);
+        if (v0 == 0.0 && v1 == 0.0) return T(0.0);
+
+        // (i) quadratic
+        if ((v0 < 0.0 && -0.5 * v0 <= v1 && v1 <= -2.0 * v0) || (v0 > 0.0 && -0.5 * v0 >= v1 && v1 >= -2.0 * v0))
+            return g0 * (x - 2.0 * x * x + x * x * x) + g1 * (x * x * x - x * x);
+
+        // (ii) flat at g0 up to eta, then quadratic to g1
+        if ((v0 < 0.0 && v1 > -2.0 * v0) || (v0 > 0.0 && v1 < -2.0 * v0)) {
+            const T eta = (g1 + 2.0 * g0) / (g1 - g0);
+            if (x <= value(eta)) return g0 * x;
+            const T u = (x - eta) / (1.0 - eta);
+            return g0 * x + (g1 - g0) * (1.0 - eta) * u * u * u / 3.0;
+        }
+
+        // (iii) quadratic from g0 down to g1 at eta, then flat
+        if ((v0 > 0.0 && v1 < 0.0 && v1 > -0.5 * v0) || (v0 < 0.0 && v1 > 0.0 && v1 < -0.5 * v0)) {
+            const T eta = 3.0 * g1 / (g1 - g0);
+            if (x >= value(eta)) return g1 * x + (g0 - g1) * eta / 3.0;
+            const T u = (eta - x) / eta;
+            return g1 * x + (g0 - g1) * eta * (1.0 - u * u * u) / 3.0;
+        }
+
+        // (iv) both ends on the same side: two quadratics meeting at A at eta
+        const T eta = g1 / (g1 + g0);
+        const T a = -g0 * g1 / (g0 + g1);
+        if (x <= value(eta)) {
+            const T u = (eta - x) / eta;
+            return a * x + (g0 - a) * eta * (1.0 - u * u * u) / 3.0;
+        }
+        const T u = (x - eta) / (1.0 - eta);
+        return a * x + (g0 - a) * eta / 3.0 + (g1 - a) * (1.0 - eta) * u * u * u / 3.0;
+    }
+
+    // Per segment state from the log discount factors on nodes 0..n (node 0 the reference date, log DF 0):
+    // forward[k] the discrete forward over segment k, and for monotone convex g0[k], g1[k] the instantaneous forwards
+    // at both ends of it less forward[k]. Entry 0 of each is unused; g0 and g1 are only touched for monotone convex.
+    // tail is the flat forward used past the last pillar.
+    template <class T>
+    void segment_forwards(std::span<const double> times, std::span<const T> log_df, bool monotone_convex,
+                          std::span<T> forward, std::span<T> g0, std::span<T> g1, T& tail) {
+        const std::size_t n = times.size() - 1;
+        for (std::size_t k = 1; k <= n; ++k)
+            forward[k] = -(log_df[k] - log_df[k - 1]) / (times[k] - times[k - 1]);
+        tail = forward[n];
+        if (!monotone_convex) return;
+
+        // Instantaneous forwards on the nodes, computed into g1: interior ones weight the two neighbouring discrete
+        // forwards by the length of the opposite segment, the end ones are chosen so the forward's slope is zero at
+        // the ends
+        std::span<T> f = g1;
+        for (std::size_t k = 1; k < n; ++k) {
+            const double h0 = times[k] - times[k - 1];
+            const double h1 = times[k + 1] - times[k];
+            f[k] = (h0 * forward[k + 1] + h1 * forward[k]) / (h0 + h1);
+        }
+        if (n == 1) {
+            f[0] = f[1] = forward[1];
+        } else {
+            f[0] = forward[1] - 0.5 * (f[1] - forward[1]);
+            f[n] = forward[n] - 0.5 * (f[n - 1] - forward[n]);
+        }
+        tail = f[n];
+
+        // Then relative to each segment's discrete forward, from the back so f[k - 1] is still there when needed
+        for (std::size_t k = n; k >= 1; --k) {
+            g0[k] = f[k - 1] - forward[k];
+            g1[k] = f[k] - forward[k];
+        }
+    }
+
+}
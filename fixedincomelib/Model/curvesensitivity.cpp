@@ -0,0 +1,133 @@
+#include "fixedincomelib/Model/curvesensitivity.h"
+#include "fixedincomelib/Model/curvemath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace fixedincomelib {
+    namespace {
+        constexpr double basis_point = 1e-4;
+
+        double leg_value(const DiscountedLeg& leg, std::span<const double> dfs) {
+            double pv = 0.0;
+            for (std::size_t i = 0; i < leg.rows.size(); ++i)
+                pv += leg.notional * leg.rate * leg.rows[i].accrued * dfs[i];
+            if (leg.notional_exchange) pv += leg.notional * dfs[leg.rows.size() - 1];
+            return pv;
+        }
+
+        // Pillar times on the curve's clock, node 0 the reference date
+        std::vector<double> node_times(const YieldCurve& curve) {
+            const auto pillars = curve.pillars();
+            const serial_type reference = curve.reference_date().serialNumber();
+            std::vector<double> times(pillars.size() + 1, 0.0);
+            for (std::size_t k = 0; k < pillars.size(); ++k)
+                times[k + 1] = static_cast<double>(pillars[k] - reference) / curve_detail::days_per_year;
+            return times;
+        }
+    }
+
+    double present_value(const YieldCurve& curve, std::span<const DiscountedLeg> legs) {
+        std::size_t longest = 0;
+        for (const DiscountedLeg& leg : legs) longest = std::max(longest, leg.rows.size());
+        std::vector<double> dfs(longest);
+
+        double pv = 0.0;
+        for (const DiscountedLeg& leg : legs) {
+            if (leg.rows.empty()) continue;
+            curve.discount_payments(leg.rows, dfs);
+            pv += leg_value(leg, dfs);
+        }
+        return pv;
+    }
+
+    PillarSensitivities adjoint_dv01(const YieldCurve& curve, std::span<const DiscountedLeg> legs, aad::Tape& tape) {
+        using aad::Active;
+
+        const auto pillars = curve.pillars();
+        const std::size_t n = pillars.size();
+        const serial_type reference = curve.reference_date().serialNumber();
+        const bool monotone_convex = curve.interpolation() == CurveInterpolation::MonotoneConvex;
+        const std::vector<double> times = node_times(curve);
+
+        tape.clear();
+        aad::Tape::Recording recording(tape);
+
+        // The curve from its log discount factors, the inputs (node 0, the reference date, is the constant 0)
+        std::vector<Active> log_df(n + 1), forward(n + 1), g0(monotone_convex ? n + 1 : 0), g1(g0.size());
+        for (std::size_t k = 0; k < n; ++k) log_df[k + 1] = tape.input(curve.log_discount_factors()[k]);
+        Active tail;
+        curve_detail::segment_forwards<Active>(times, log_df, monotone_convex, forward, g0, g1, tail);
+        const aad::Tape::Mark curve_end = tape.mark();
+
+        // YieldCurve::log_discount for one date, on the tape
+        auto log_discount = [&](serial_type s) {
+            if (s < reference)
+                throw std::invalid_argument("adjoint_dv01: " + Date(QuantLib::Date(s)).get_date_str() +
+                                            " is before the reference date");
+            const double t = static_cast<double>(s - reference) / curve_detail::days_per_year;
+            if (s > pillars.back()) return log_df[n] - tail * (t - times[n]);
+
+            const std::size_t k =
+                static_cast<std::size_t>(std::lower_bound(pillars.begin(), pillars.end(), s) - pillars.begin()) + 1;
+            const double dt = t - times[k - 1];
+            Active l = log_df[k - 1] - forward[k] * dt;
+            if (monotone_convex) {
+                const double h = times[k] - times[k - 1];
+                l -= h * curve_detail::monotone_convex_integral(g0[k], g1[k], dt / h);
+            }
+            return l;
+        };
+
+        PillarSensitivities result;
+        result.valuations = 1;
+        result.tape_peak = curve_end;
+        for (const DiscountedLeg& leg : legs) {
+            if (leg.rows.empty()) continue;
+            Active pv = 0.0;
+            for (const ScheduleRow& row : leg.rows)
+                pv += (leg.notional * leg.rate * row.accrued) * exp(log_discount(row.paymentDate.serialNumber()));
+            if (leg.notional_exchange)
+                pv += leg.notional * exp(log_discount(leg.rows.back().paymentDate.serialNumber()));
+            result.pv += pv.value();
+            result.tape_peak = std::max(result.tape_peak, tape.size());
+
+            // Checkpoint: this leg's adjoints go into the curve's nodes, then the leg is dropped from the tape
+            tape.seed(pv);
+            tape.propagate(curve_end);
+            tape.rewind(curve_end);
+        }
+        tape.propagate();
+
+        // d log DF_k / d zero_k = -t_k
+        result.dv01.resize(n);
+        for (std::size_t k = 0; k < n; ++k)
+            result.dv01[k] = -times[k + 1] * log_df[k + 1].adjoint() * basis_point;
+        return result;
+    }
+
+    PillarSensitivities bumped_dv01(const YieldCurve& curve, std::span<const DiscountedLeg> legs, double bump) {
+        if (!(bump != 0.0)) throw std::invalid_argument("bumped_dv01: bump must be non-zero");
+        const std::size_t n = curve.pillars().size();
+        const std::vector<double> times = node_times(curve);
+
+        std::vector<double> dfs(n);
+        for (std::size_t k = 0; k < n; ++k) dfs[k] = std::exp(curve.log_discount_factors()[k]);
+
+        PillarSensitivities result;
+        result.pv = present_value(curve, legs);
+        result.valuations = n + 1;
+        result.dv01.resize(n);
+
+        YieldCurve bumped = curve;
+        for (std::size_t k = 0; k < n; ++k) {
+            const double base = dfs[k];
+            dfs[k] = base * std::exp(-bump * times[k + 1]);
+            bumped.set_discount_factors(dfs);
+            result.dv01[k] = (present_value(bumped, legs) - result.pv) * (basis_point / bump);
+            dfs[k] = base;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+#include "fixedincomelib/utils/tape.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Fixed cashflows off a schedule: notional * rate * accrued paid on each row's payment date, plus the notional on
+    // the last payment date when it is exchanged. The rows aren't copied and must outlive the leg.
+    struct DiscountedLeg {
+        std::span<const ScheduleRow> rows;
+        double notional = 1.0;
+        double rate = 0.0;
+        bool notional_exchange = false;
+    };
+
+    // Sum of the legs' PVs on the curve
+    double present_value(const YieldCurve& curve, std::span<const DiscountedLeg> legs);
+
+    struct PillarSensitivities {
+        double pv = 0.0;
+        // By pillar, the PV change for a 1bp rise in the pillar's zero rate (continuously compounded, ACT/365 from
+        // the reference date, like the curve's own time)
+        std::vector<double> dv01;
+        std::size_t valuations = 0;   // full passes over the portfolio
+        std::size_t tape_peak = 0;    // most nodes on the tape at once, 0 when bumping
+    };
+
+    // Bucketed DV01 by reverse-mode AAD, in one forward and one backward pass whatever the number of pillars
+    // The curve is recorded on the tape from its log discount factors (same interpolation code as YieldCurve), then
+    // each leg in turn is recorded, swept back to the curve and rewound, so the tape holds the curve and one leg at a
+    // time (see aad::Tape on checkpointing). The tape is cleared first and can be reused across calls.
+    PillarSensitivities adjoint_dv01(const YieldCurve& curve, std::span<const DiscountedLeg> legs, aad::Tape& tape);
+
+    // The same by bump and revalue, one full revaluation per pillar: the reference adjoint_dv01 is checked and timed
+    // against. One-sided, so it differs from the adjoint by the convexity of a bump of that size.
+    PillarSensitivities bumped_dv01(const YieldCurve& curve, std::span<const DiscountedLeg> legs, double bump = 1e-4);
+
+}
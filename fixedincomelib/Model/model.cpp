@@ -1,34 +1,21 @@
-#include <iostream>
-#include <string>
-#include <algorithm>  // std::transform
-#include <cctype>     // std::toupper
+#include "fixedincomelib/Model/model.h"
+#include "fixedincomelib/utils/perfecthash.h"
 
-class ModelType {
-private:
-    std::string valuestr_;
+#include <stdexcept>
 
-public:
-    enum modeltypes {
-        YIELD_CURVE = 1,
-        IR_SABR = 2,
-    };
-    
-    ModelType(const std::string& modeltype) : valuestr_(modeltype) {
-        std::string upperModelType = modeltype;
-        std::transform(upperModelType.begin(), upperModelType.end(),
-                       upperModelType.begin(),
-                       [](unsigned char c){ return static_cast<char>(std::toupper(c)); });
+namespace fixedincomelib {
 
-        if (upperModelType == "YIELD_CURVE") {
+    ModelType::ModelType(std::string_view modeltype) : valuestr_(modeltype) {
+        if (iequals_ascii(modeltype, "YIELD_CURVE")) {
             value_ = YIELD_CURVE;
-        } else if (upperModelType == "IR_SABR") {
+        } else if (iequals_ascii(modeltype, "IR_SABR")) {
             value_ = IR_SABR;
         } else {
-            throw std::runtime_error("Model type " + modeltype + " is not supported.");
+            throw std::runtime_error("Model type " + valuestr_ + " is not supported.");
         }
     }
 
-    const std::string& valueStr() const { return valuestr_; }
-};
+    ModelType::ModelType(modeltypes value)
+        : valuestr_(value == YIELD_CURVE ? "YIELD_CURVE" : "IR_SABR"), value_(value) {}
 
-class 
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace fixedincomelib {
+
+    class ModelType {
+    private:
+        std::string valuestr_;
+
+    public:
+        enum modeltypes {
+            YIELD_CURVE = 1,
+            IR_SABR = 2,
+        };
+
+        // Case-insensitive, throws std::runtime_error for anything but YIELD_CURVE and IR_SABR
+        explicit ModelType(std::string_view modeltype);
+        ModelType(modeltypes value);
+
+        modeltypes value() const { return value_; }
+        const std::string& valueStr() const { return valuestr_; }
+
+        bool operator==(const ModelType& other) const { return value_ == other.value_; }
+
+    private:
+        modeltypes value_;
+    };
+
+}
@@ -0,0 +1,116 @@
+#include "fixedincomelib/Model/overnightcompounding.h"
+#include "fixedincomelib/Date/basics.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+    namespace {
+        std::string date_str(serial_type s) { return Date(QuantLib::Date(s)).get_date_str(); }
+    }
+
+    OvernightCompounder::OvernightCompounder(const BitmapCalendar& calendar, const QuantLib::Date& first_fixing,
+                                             std::span<const double> fixings, double basis, int max_lookback)
+        : calendar_(calendar), basis_(basis) {
+        if (!(basis > 0.0)) throw std::invalid_argument("OvernightCompounder: basis must be positive");
+        if (max_lookback < 0) throw std::invalid_argument("OvernightCompounder: max_lookback must be non-negative");
+        const serial_type first = first_fixing.serialNumber();
+        if (!calendar_.covers(first) || !calendar_.is_business_day(first_fixing))
+            throw std::invalid_argument("OvernightCompounder: first fixing " + date_str(first) +
+                                        " is not a business day inside the calendar's range");
+        first_rank_ = calendar_.rank(first);
+
+        growth_.assign(static_cast<std::size_t>(max_lookback) + 1, std::vector<double>{1.0});
+        for (auto& g : growth_) g.reserve(fixings.size() + 1);
+        rates_.reserve(fixings.size());
+        for (double r : fixings) append(r);
+    }
+
+    void OvernightCompounder::append(double fixing) {
+        // Day j of table p is business day first_rank_ + p + j, and it needs the next one for its weight
+        const serial_type j = static_cast<serial_type>(rates_.size());
+        if (first_rank_ + max_lookback() + j + 1 >= calendar_.business_day_count())
+            throw std::invalid_argument("OvernightCompounder: fixings run past the end of the calendar's range");
+        rates_.push_back(fixing);
+        for (std::size_t p = 0; p < growth_.size(); ++p) {
+            std::vector<double>& g = growth_[p];
+            g.push_back(g.back() * (1.0 + fixing * weight(first_rank_ + static_cast<serial_type>(p) + j) / basis_));
+        }
+    }
+
+    QuantLib::Date OvernightCompounder::last_fixing() const {
+        if (rates_.empty()) throw std::logic_error("OvernightCompounder: no fixings");
+        return QuantLib::Date(calendar_.select(first_rank_ + static_cast<serial_type>(rates_.size()) - 1));
+    }
+
+    void OvernightCompounder::check(const OvernightConvention& convention) const {
+        if (convention.lookback < 0 || convention.lookback > max_lookback())
+            throw std::invalid_argument("OvernightCompounder: lookback " + std::to_string(convention.lookback) +
+                                        " outside [0, " + std::to_string(max_lookback()) + "]");
+        if (convention.lockout < 0) throw std::invalid_argument("OvernightCompounder: negative lockout");
+    }
+
+    double OvernightCompounder::rate(serial_type start, serial_type end, const OvernightConvention& convention) const {
+        if (end <= start)
+            throw std::invalid_argument("OvernightCompounder: period " + date_str(start) + " to " + date_str(end) +
+                                        " is empty");
+        if (!calendar_.covers(start) || !calendar_.covers(end))
+            throw std::out_of_range("OvernightCompounder: period " + date_str(start) + " to " + date_str(end) +
+                                    " is outside the calendar's range");
+
+        // Observation days [ka, kb) as ranks, and the table that prices them
+        const serial_type p = convention.lookback;
+        serial_type ka = calendar_.rank(start), kb = calendar_.rank(end);
+        std::size_t table = static_cast<std::size_t>(p);
+        if (convention.observation_shift) {
+            ka -= p;
+            kb -= p;
+            table = 0;
+        }
+        const serial_type offset = first_rank_ + static_cast<serial_type>(table);
+        const serial_type lo = ka - offset, hi = kb - offset;
+        if (lo < 0 || hi > static_cast<serial_type>(rates_.size()))
+            throw std::out_of_range("OvernightCompounder: missing fixings for " + date_str(start) + " to " +
+                                    date_str(end));
+        const serial_type locked = convention.lockout;
+        if (locked > 0 && hi - lo <= locked)
+            throw std::invalid_argument("OvernightCompounder: lockout of " + std::to_string(locked) +
+                                        " days leaves nothing observed in " + date_str(start) + " to " +
+                                        date_str(end));
+
+        const std::vector<double>& g = growth_[table];
+        double growth = g[static_cast<std::size_t>(hi - locked)] / g[static_cast<std::size_t>(lo)];
+        if (locked > 0) {
+            const double r = rates_[static_cast<std::size_t>(hi - locked - 1)];
+            for (serial_type j = hi - locked; j < hi; ++j) growth *= 1.0 + r * weight(offset + j) / basis_;
+        }
+
+        const double days = convention.observation_shift
+                                ? static_cast<double>(calendar_.select(kb) - calendar_.select(ka))
+                                : static_cast<double>(end - start);
+        return (growth - 1.0) * basis_ / days;
+    }
+
+    double OvernightCompounder::compounded_rate(serial_type start, serial_type end,
+                                                const OvernightConvention& convention) const {
+        check(convention);
+        return rate(start, end, convention);
+    }
+
+    void OvernightCompounder::compounded_rates(std::span<const serial_type> starts, std::span<const serial_type> ends,
+                                               const OvernightConvention& convention, std::span<double> out) const {
+        if (ends.size() != starts.size() || out.size() < starts.size())
+            throw std::invalid_argument("OvernightCompounder::compounded_rates: mismatched spans");
+        check(convention);
+        for (std::size_t i = 0; i < starts.size(); ++i) out[i] = rate(starts[i], ends[i], convention);
+    }
+
+    void OvernightCompounder::compounded_rates(std::span<const ScheduleRow> rows, const OvernightConvention& convention,
+                                               std::span<double> out) const {
+        if (out.size() < rows.size())
+            throw std::invalid_argument("OvernightCompounder::compounded_rates: output is shorter than the rows");
+        check(convention);
+        for (std::size_t i = 0; i < rows.size(); ++i)
+            out[i] = rate(rows[i].startDate.serialNumber(), rows[i].endDate.serialNumber(), convention);
+    }
+}
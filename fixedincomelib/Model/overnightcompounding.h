@@ -0,0 +1,87 @@
+#pragma once
+
+#include "fixedincomelib/Date/bitmapcalendar.h"
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Date/utilities.h"
+
+#include <ql/time/date.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // How the overnight fixings of an accrual period are observed, in business days of the index calendar
+    //   lookback: each interest day takes the fixing published lookback business days earlier, the day's weight (the
+    //             calendar days to the next business day) staying that of the interest day
+    //   observation_shift: with a lookback, the whole observation period moves back instead, so fixings and weights
+    //             both come from the shifted days and the rate is annualised over the shifted period's length
+    //   lockout: the last lockout observation days reuse the fixing of the day before them, as QuantLib's
+    //             OvernightIndexedCoupon does
+    struct OvernightConvention {
+        int lookback = 0;
+        int lockout = 0;
+        bool observation_shift = false;
+    };
+
+    // Compounded-in-arrears overnight rates (SOFR, SONIA, ESTR) in two lookups per period
+    // The fixings are held as cumulative growth factors over the business days of the index calendar,
+    //   G[k] = prod over business days j < k of (1 + r_j * n_j / basis),  n_j the calendar days from j to the next one
+    // so the compounded rate of any period is (G[end] / G[start] - 1) * basis / days, whatever its length. Business
+    // days map to table positions through BitmapCalendar::rank, which is also constant time.
+    //
+    // A lookback without observation shift pairs the fixing of day j - p with the weight of day j, which no single
+    // table gives, so one table is kept per lookback up to max_lookback (each is one double per fixing). A lockout
+    // multiplies in its few locked days one by one.
+    //
+    // Accrual dates are expected to be business days, as they are on an adjusted schedule from make_schedule. All
+    // queries are const and can run concurrently; append() can't run alongside them.
+    class OvernightCompounder {
+        public:
+            // fixings[i] is the fixing for the i-th business day from first_fixing, which must be a business day
+            // basis is the index's day count denominator, 360 for SOFR and ESTR, 365 for SONIA
+            // Throws std::invalid_argument on a bad first date, basis or max_lookback, or if the fixings (plus
+            // max_lookback days) run past the end of the calendar's bitmap
+            OvernightCompounder(const BitmapCalendar& calendar, const QuantLib::Date& first_fixing,
+                                std::span<const double> fixings, double basis = 360.0, int max_lookback = 10);
+
+            // The next business day's fixing, extending every table by one entry
+            void append(double fixing);
+
+            std::size_t size() const { return rates_.size(); }
+            QuantLib::Date first_fixing() const { return QuantLib::Date(calendar_.select(first_rank_)); }
+            // Throws std::logic_error when there are no fixings
+            QuantLib::Date last_fixing() const;
+            int max_lookback() const { return static_cast<int>(growth_.size()) - 1; }
+            double basis() const { return basis_; }
+
+            // Annualised compounded rate over [start, end)
+            // Throws std::invalid_argument for end <= start, a negative lockout, a lookback outside [0, max_lookback]
+            // or a lockout that leaves no observed day; std::out_of_range if a fixing the period needs is missing
+            double compounded_rate(serial_type start, serial_type end,
+                                   const OvernightConvention& convention = {}) const;
+
+            // The same for a book of periods in one call, out[i] for (starts[i], ends[i])
+            void compounded_rates(std::span<const serial_type> starts, std::span<const serial_type> ends,
+                                  const OvernightConvention& convention, std::span<double> out) const;
+            void compounded_rates(std::span<const ScheduleRow> rows, const OvernightConvention& convention,
+                                  std::span<double> out) const;
+
+        private:
+            void check(const OvernightConvention& convention) const;
+            double rate(serial_type start, serial_type end, const OvernightConvention& convention) const;
+            // Calendar days from business day k (a rank) to the next one
+            double weight(serial_type k) const {
+                return static_cast<double>(calendar_.select(k + 1) - calendar_.select(k));
+            }
+
+            BitmapCalendar calendar_;
+            serial_type first_rank_ = 0;
+            double basis_ = 360.0;
+            std::vector<double> rates_;
+            // growth_[p][j]: growth up to interest day first_rank_ + p + j with lookback p, growth_[p][0] = 1
+            std::vector<std::vector<double>> growth_;
+    };
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "fixedincomelib/Model/model.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // SABR parameters for one expiry/tenor, with the shift of shifted SABR (forward and strikes are moved up by shift
+    // before the formula, so rates down to -shift are allowed)
+    struct SabrParameters {
+        double alpha = 0.0;
+        double beta = 0.0;
+        double rho = 0.0;
+        double nu = 0.0;
+        double shift = 0.0;
+    };
+
+    // Hagan et al. (2002) lognormal implied vol, out[i] for strikes[i], out must be at least strikes.size() long
+    // The loop is branch-free (log and exp are inlined polynomial versions, the ATM limit of z / x(z) is a blend with
+    // its Taylor series rather than a branch), so the compiler vectorizes it; like the year-fraction kernels it is
+    // built for the baseline target and for AVX2, picked at runtime, with the same results from both.
+    // Strikes at or below -shift have no lognormal vol and come out as NaN; so does every strike when the forward is at
+    // or below -shift.
+    void sabr_implied_vols(const SabrParameters& p,
+                           double forward,
+                           double expiry,
+                           std::span<const double> strikes,
+                           std::span<double> out);
+
+    // NaN when the strike or the forward is at or below -shift, as above
+    double sabr_implied_vol(const SabrParameters& p, double forward, double strike, double expiry);
+
+    // True when the AVX2 build of the kernel is in use on this machine
+    bool sabr_use_avx2();
+
+    // SABR model for ModelType::IR_SABR: a cube of parameters over a swaption expiry x tenor grid (both in years)
+    // The cube is kept as structure-of-arrays, one contiguous column per parameter, node (e, t) at e * tenors + t.
+    // Parameters between nodes are bilinear in expiry and tenor, flat outside the grid. Const members can be called
+    // from any number of threads.
+    class SabrModel {
+        public:
+            // nodes are expiry-major, expiries.size() * tenors.size() of them
+            // Throws std::invalid_argument on unsorted grids or parameters out of range (alpha > 0, beta in [0, 1],
+            // |rho| < 1, nu >= 0, shift >= 0)
+            SabrModel(std::vector<double> expiries, std::vector<double> tenors, std::span<const SabrParameters> nodes);
+
+            ModelType model_type() const { return ModelType(ModelType::IR_SABR); }
+
+            std::span<const double> expiries() const { return expiries_; }
+            std::span<const double> tenors() const { return tenors_; }
+
+            // Parameter columns
+            std::span<const double> alpha() const { return alpha_; }
+            std::span<const double> beta() const { return beta_; }
+            std::span<const double> rho() const { return rho_; }
+            std::span<const double> nu() const { return nu_; }
+            std::span<const double> shift() const { return shift_; }
+
+            SabrParameters node(std::size_t expiry_index, std::size_t tenor_index) const;
+            // Same checks as the constructor
+            void set_node(std::size_t expiry_index, std::size_t tenor_index, const SabrParameters& p);
+
+            // Interpolated parameters at any expiry and tenor
+            SabrParameters parameters(double expiry, double tenor) const;
+
+            // Vols for a column of strikes on the swaption expiry x tenor with the given forward swap rate; NaN for a
+            // strike, or with a forward, at or below the interpolated shift
+            void implied_vol(std::span<const double> strikes, double forward, double expiry, double tenor,
+                             std::span<double> out) const;
+            double implied_vol(double strike, double forward, double expiry, double tenor) const;
+
+        private:
+            std::size_t index(std::size_t e, std::size_t t) const { return e * tenors_.size() + t; }
+
+            std::vector<double> expiries_;
+            std::vector<double> tenors_;
+            std::vector<double> alpha_;
+            std::vector<double> beta_;
+            std::vector<double> rho_;
+            std::vector<double> nu_;
+            std::vector<double> shift_;
+    };
+
+}
@@ -0,0 +1,363 @@
+#include "fixedincomelib/Model/sabrcalibration.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace fixedincomelib {
+    namespace {
+        // Same role as the kernel's cutoff: below it z / x(z) and its derivatives come from the Taylor series
+        constexpr double z_series_cutoff = 1e-4;
+
+        // Keeps a previous fit at the edge of the range usable as a start in the transformed variables
+        constexpr double max_start_rho = 0.999;
+        constexpr double min_start_nu = 1e-4;
+
+        // Solver variables: theta = (log alpha, atanh rho, log nu)
+        using Vec3 = std::array<double, 3>;
+
+        Vec3 to_theta(const SabrParameters& p) {
+            return {std::log(p.alpha), std::atanh(std::clamp(p.rho, -max_start_rho, max_start_rho)),
+                    std::log(std::max(p.nu, min_start_nu))};
+        }
+
+        SabrParameters from_theta(const Vec3& theta, double beta, double shift) {
+            // tanh rounds to exactly +-1 past 19, which SabrModel would reject
+            return SabrParameters{std::exp(theta[0]), beta, std::tanh(std::clamp(theta[1], -18.0, 18.0)),
+                                  std::exp(theta[2]), shift};
+        }
+
+        // Residuals w_i (vol_i - quote_i) and, when jacobian isn't null, their derivatives in theta
+        // Returns the cost, half the sum of squares (NaN if any vol is)
+        double residuals(const SabrQuotes& q, double expiry, const SabrParameters& p, std::vector<double>& r,
+                         std::vector<Vec3>* jacobian) {
+            double cost = 0.0;
+            for (std::size_t i = 0; i < q.strikes.size(); ++i) {
+                const double w = q.weights.empty() ? 1.0 : q.weights[i];
+                double d_alpha, d_rho, d_nu;
+                const double vol = sabr_implied_vol_gradient(p, q.forward, q.strikes[i], expiry, d_alpha, d_rho, d_nu);
+                r[i] = w * (vol - q.vols[i]);
+                cost += 0.5 * r[i] * r[i];
+                if (jacobian)
+                    (*jacobian)[i] = {w * d_alpha * p.alpha, w * d_rho * (1.0 - p.rho * p.rho), w * d_nu * p.nu};
+            }
+            return cost;
+        }
+
+        // Solves the symmetric positive definite 3x3 system a x = b by Cholesky, false if a isn't positive definite
+        bool solve3(const std::array<Vec3, 3>& a, const Vec3& b, Vec3& x) {
+            double l[3][3] = {};
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j <= i; ++j) {
+                    double s = a[i][j];
+                    for (int k = 0; k < j; ++k) s -= l[i][k] * l[j][k];
+                    if (i == j) {
+                        if (!(s > 0.0)) return false;
+                        l[i][i] = std::sqrt(s);
+                    } else {
+                        l[i][j] = s / l[j][j];
+                    }
+                }
+            }
+            Vec3 y;
+            for (int i = 0; i < 3; ++i) {
+                double s = b[i];
+                for (int k = 0; k < i; ++k) s -= l[i][k] * y[k];
+                y[i] = s / l[i][i];
+            }
+            for (int i = 2; i >= 0; --i) {
+                double s = y[i];
+                for (int k = i + 1; k < 3; ++k) s -= l[k][i] * x[k];
+                x[i] = s / l[i][i];
+            }
+            return true;
+        }
+
+        struct Fit {
+            SabrParameters params;
+            SabrNodeReport::Status status;
+            int iterations;
+            double rms_error;
+        };
+
+        // Levenberg-Marquardt with Marquardt's diagonal scaling: the damping grows on a rejected step and shrinks on
+        // an accepted one
+        Fit levenberg_marquardt(const SabrQuotes& q, double expiry, const SabrParameters& start,
+                                const SabrCalibrationOptions& options) {
+            const std::size_t n = q.strikes.size();
+            std::vector<double> r(n), trial_r(n);
+            std::vector<Vec3> jacobian(n);
+
+            Vec3 theta = to_theta(start);
+            SabrParameters p = from_theta(theta, start.beta, start.shift);
+            double cost = residuals(q, expiry, p, r, &jacobian);
+            if (!std::isfinite(cost)) return Fit{start, SabrNodeReport::Status::Failed, 0, 0.0};
+
+            auto rms = [n](double c) { return std::sqrt(2.0 * c / static_cast<double>(n)); };
+            double lambda = -1.0;
+            int iteration = 0;
+            while (iteration < options.max_iterations) {
+                // Normal equations J'J and gradient J'r
+                std::array<Vec3, 3> jtj{};
+                Vec3 g{};
+                for (std::size_t i = 0; i < n; ++i)
+                    for (int a = 0; a < 3; ++a) {
+                        g[a] += jacobian[i][a] * r[i];
+                        for (int b = 0; b < 3; ++b) jtj[a][b] += jacobian[i][a] * jacobian[i][b];
+                    }
+                if (std::max({std::abs(g[0]), std::abs(g[1]), std::abs(g[2])}) <= options.gradient_tolerance)
+                    return Fit{p, SabrNodeReport::Status::Converged, iteration, rms(cost)};
+                if (lambda < 0.0) lambda = 1e-3 * std::max({jtj[0][0], jtj[1][1], jtj[2][2]});
+
+                // Try steps until one lowers the cost
+                bool accepted = false;
+                while (!accepted && iteration < options.max_iterations) {
+                    ++iteration;
+                    std::array<Vec3, 3> damped = jtj;
+                    // Floor on the scaling keeps a flat direction (e.g. nu when the smile has no curvature) solvable
+                    for (int a = 0; a < 3; ++a) damped[a][a] += lambda * std::max(jtj[a][a], 1e-12);
+                    Vec3 step;
+                    if (!solve3(damped, Vec3{-g[0], -g[1], -g[2]}, step)) {
+                        lambda *= 10.0;
+                        continue;
+                    }
+
+                    const Vec3 trial_theta{theta[0] + step[0], theta[1] + step[1], theta[2] + step[2]};
+                    const SabrParameters trial = from_theta(trial_theta, start.beta, start.shift);
+                    const double trial_cost = residuals(q, expiry, trial, trial_r, nullptr);
+                    if (std::isfinite(trial_cost) && trial_cost < cost) {
+                        accepted = true;
+                        theta = trial_theta;
+                        p = trial;
+                        cost = residuals(q, expiry, p, r, &jacobian);
+                        lambda = std::max(lambda / 3.0, 1e-15);
+                        const double size = std::max({std::abs(step[0]), std::abs(step[1]), std::abs(step[2])});
+                        if (size <= options.step_tolerance)
+                            return Fit{p, SabrNodeReport::Status::Converged, iteration, rms(cost)};
+                    } else {
+                        lambda *= 4.0;
+                        // Damped to nothing and still no decrease: the fit has stalled with the gradient above its
+                        // tolerance (it was checked above) and no accepted step small enough, so it's kept but not
+                        // counted as converged
+                        if (lambda > 1e20) return Fit{p, SabrNodeReport::Status::MaxIterations, iteration, rms(cost)};
+                    }
+                }
+            }
+            return Fit{p, SabrNodeReport::Status::MaxIterations, iteration, rms(cost)};
+        }
+
+        // ATM vol read off the quotes, linear between the strikes either side of the forward
+        double atm_vol(const SabrQuotes& q) {
+            const auto it = std::lower_bound(q.strikes.begin(), q.strikes.end(), q.forward);
+            if (it == q.strikes.begin()) return q.vols.front();
+            if (it == q.strikes.end()) return q.vols.back();
+            const std::size_t i = static_cast<std::size_t>(it - q.strikes.begin());
+            const double w = (q.forward - q.strikes[i - 1]) / (q.strikes[i] - q.strikes[i - 1]);
+            return (1.0 - w) * q.vols[i - 1] + w * q.vols[i];
+        }
+
+        void check_quotes(const SabrQuotes& q, double shift) {
+            const std::size_t n = q.strikes.size();
+            if (n < 3) throw std::invalid_argument("SabrCalibrator: need at least three strikes to fit alpha, rho, nu");
+            if (q.vols.size() != n || (!q.weights.empty() && q.weights.size() != n))
+                throw std::invalid_argument("SabrCalibrator: " + std::to_string(n) + " strikes but " +
+                                            std::to_string(q.vols.size()) + " vols and " +
+                                            std::to_string(q.weights.size()) + " weights");
+            if (!(q.forward + shift > 0.0))
+                throw std::invalid_argument("SabrCalibrator: forward " + std::to_string(q.forward) +
+                                            " is not above -shift");
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!(q.strikes[i] + shift > 0.0) || (i > 0 && !(q.strikes[i] > q.strikes[i - 1])))
+                    throw std::invalid_argument("SabrCalibrator: strikes must be increasing and above -shift");
+                if (!(q.vols[i] > 0.0) || !std::isfinite(q.vols[i]))
+                    throw std::invalid_argument("SabrCalibrator: vol " + std::to_string(q.vols[i]) + " at strike " +
+                                                std::to_string(q.strikes[i]));
+                if (!q.weights.empty() && !(q.weights[i] >= 0.0))
+                    throw std::invalid_argument("SabrCalibrator: negative weight");
+            }
+        }
+
+        bool same_quotes(const SabrQuotes& a, const SabrQuotes& b) {
+            return a.forward == b.forward && a.strikes == b.strikes && a.vols == b.vols && a.weights == b.weights;
+        }
+
+        std::vector<SabrParameters> flat_nodes(std::size_t n, double beta, double shift) {
+            // Placeholders until the first fit, alpha only has to be positive
+            return std::vector<SabrParameters>(n, SabrParameters{0.01, beta, 0.0, 0.5, shift});
+        }
+    }
+
+    double sabr_implied_vol_gradient(const SabrParameters& p, double forward, double strike, double expiry,
+                                     double& d_alpha, double& d_rho, double& d_nu) {
+        const double f = forward + p.shift, k = strike + p.shift;
+        if (!(k > 0.0) || !(f > 0.0)) {
+            d_alpha = d_rho = d_nu = std::numeric_limits<double>::quiet_NaN();
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        const double alpha = p.alpha, rho = p.rho, nu = p.nu, beta1 = 1.0 - p.beta;
+
+        // vol = alpha / denominator * z / x(z) * time, only z / x(z) and time depend on rho and nu
+        const double l = std::log(f / k);
+        const double fk_b = std::pow(f * k, 0.5 * beta1);
+        const double b2l2 = beta1 * beta1 * l * l;
+        const double denominator = fk_b * (1.0 + b2l2 / 24.0 + b2l2 * b2l2 / 1920.0);
+        const double z = nu / alpha * fk_b * l;
+        const double dz_dnu = fk_b * l / alpha;   // z / nu, and z is -alpha dz/dalpha
+
+        double zx, dzx_dz, dzx_drho;
+        if (std::abs(z) < z_series_cutoff) {
+            const double s1 = -0.5 * rho;
+            const double s2 = (2.0 - 3.0 * rho * rho) / 12.0;
+            const double s3 = rho * (5.0 - 6.0 * rho * rho) / 24.0;
+            zx = 1.0 + z * (s1 + z * (s2 + z * s3));
+            dzx_dz = s1 + z * (2.0 * s2 + 3.0 * z * s3);
+            dzx_drho = z * (-0.5 + z * (-0.5 * rho + z * (5.0 - 18.0 * rho * rho) / 24.0));
+        } else {
+            // With root = sqrt(1 - 2 rho z + z^2) and g = root + z - rho: x = log(g / (1 - rho)), dx/dz = 1 / root
+            // and dx/drho = 1 / (1 - rho) - (z + root) / (root g). g and z + root cancel for z well below 0, so
+            // there they are rearranged.
+            const double root = std::sqrt(1.0 - 2.0 * rho * z + z * z);
+            const double g = z >= 0.0 ? root + z - rho : (1.0 - rho * rho) / (root - z + rho);
+            const double z_root = z >= 0.0 ? z + root : (1.0 - 2.0 * rho * z) / (root - z);
+            const double x = std::log(g / (1.0 - rho));
+            const double dx_drho = 1.0 / (1.0 - rho) - z_root / (root * g);
+            zx = z / x;
+            dzx_dz = (x - z / root) / (x * x);
+            dzx_drho = -z * dx_drho / (x * x);
+        }
+
+        const double ta = beta1 * beta1 / (24.0 * fk_b * fk_b), tb = 0.25 * p.beta / fk_b, tc = 1.0 / 24.0;
+        const double time =
+            1.0 + (ta * alpha * alpha + tb * rho * nu * alpha + tc * (2.0 - 3.0 * rho * rho) * nu * nu) * expiry;
+        const double dtime_dalpha = (2.0 * ta * alpha + tb * rho * nu) * expiry;
+        const double dtime_drho = (tb * nu * alpha - 6.0 * tc * rho * nu * nu) * expiry;
+        const double dtime_dnu = (tb * rho * alpha + 2.0 * tc * (2.0 - 3.0 * rho * rho) * nu) * expiry;
+
+        const double a = alpha / denominator;
+        d_alpha = zx * time / denominator - a * dzx_dz * (z / alpha) * time + a * zx * dtime_dalpha;
+        d_rho = a * (dzx_drho * time + zx * dtime_drho);
+        d_nu = a * (dzx_dz * dz_dnu * time + zx * dtime_dnu);
+        return a * zx * time;
+    }
+
+    SabrCalibrator::SabrCalibrator(std::vector<double> expiries,
+                                   std::vector<double> tenors,
+                                   double beta,
+                                   double shift,
+                                   SabrCalibrationOptions options)
+        : model_(expiries, tenors, flat_nodes(expiries.size() * tenors.size(), beta, shift)),
+          options_(options),
+          nodes_(expiries.size() * tenors.size()) {}
+
+    SabrCalibrator::SabrCalibrator(SabrModel previous, SabrCalibrationOptions options)
+        : model_(std::move(previous)), options_(options), nodes_(model_.expiries().size() * model_.tenors().size()) {
+        for (Node& node : nodes_) node.fitted = true;
+    }
+
+    void SabrCalibrator::set_quotes(std::size_t expiry_index, std::size_t tenor_index, SabrQuotes quotes) {
+        if (expiry_index >= model_.expiries().size() || tenor_index >= model_.tenors().size())
+            throw std::out_of_range("SabrCalibrator: no node (" + std::to_string(expiry_index) + ", " +
+                                    std::to_string(tenor_index) + ")");
+        check_quotes(quotes, model_.node(expiry_index, tenor_index).shift);
+
+        Node& node = nodes_[index(expiry_index, tenor_index)];
+        if (node.has_quotes && same_quotes(node.quotes, quotes)) return;
+        node.quotes = std::move(quotes);
+        node.has_quotes = true;
+        node.pending = true;
+    }
+
+    bool SabrCalibrator::pending(std::size_t expiry_index, std::size_t tenor_index) const {
+        return nodes_[index(expiry_index, tenor_index)].pending;
+    }
+
+    SabrCalibrationReport SabrCalibrator::calibrate(ThreadPool& pool) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const std::size_t n_expiries = model_.expiries().size(), n_tenors = model_.tenors().size();
+
+        SabrCalibrationReport report;
+        report.nodes.resize(nodes_.size());
+        report.threads = pool.size();
+
+        // Starting points are all picked before anything is refitted, from the cube as the last run left it
+        std::vector<std::size_t> work;
+        std::vector<SabrParameters> starts(nodes_.size());
+        for (std::size_t e = 0; e < n_expiries; ++e) {
+            for (std::size_t t = 0; t < n_tenors; ++t) {
+                const std::size_t i = index(e, t);
+                const Node& node = nodes_[i];
+                SabrNodeReport& r = report.nodes[i];
+                if (!node.has_quotes) {
+                    r.status = SabrNodeReport::Status::NoQuotes;
+                    continue;
+                }
+                if (!node.pending) {
+                    r.status = SabrNodeReport::Status::Skipped;
+                    ++report.skipped;
+                    continue;
+                }
+                work.push_back(i);
+
+                SabrParameters start = model_.node(e, t);
+                if (node.fitted) {
+                    r.start = SabrNodeReport::Start::Previous;
+                } else {
+                    double rho = 0.0, nu = 0.0;
+                    int neighbours = 0;
+                    auto take = [&](std::size_t ne, std::size_t nt) {
+                        if (ne >= n_expiries || nt >= n_tenors || !nodes_[index(ne, nt)].fitted) return;
+                        rho += model_.rho()[index(ne, nt)];
+                        nu += model_.nu()[index(ne, nt)];
+                        ++neighbours;
+                    };
+                    // size_t wraps below zero, which take() rejects as off the grid
+                    take(e - 1, t);
+                    take(e + 1, t);
+                    take(e, t - 1);
+                    take(e, t + 1);
+                    r.start = neighbours > 0 ? SabrNodeReport::Start::Neighbour : SabrNodeReport::Start::Guess;
+                    start.rho = neighbours > 0 ? rho / neighbours : 0.0;
+                    start.nu = neighbours > 0 ? nu / neighbours : 0.5;
+                    // Leading order ATM vol is alpha / f^(1 - beta)
+                    start.alpha = atm_vol(node.quotes) * std::pow(node.quotes.forward + start.shift, 1.0 - start.beta);
+                }
+                starts[i] = start;
+            }
+        }
+
+        // Every task writes only its own node's report and fit
+        std::vector<Fit> fits(nodes_.size());
+        pool.parallel_for(work.size(), 1, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t w = begin; w < end; ++w) {
+                const std::size_t i = work[w];
+                const auto start_time = std::chrono::steady_clock::now();
+                fits[i] = levenberg_marquardt(nodes_[i].quotes, model_.expiries()[i / n_tenors], starts[i], options_);
+                report.nodes[i].seconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            }
+        });
+
+        for (std::size_t i : work) {
+            SabrNodeReport& r = report.nodes[i];
+            r.status = fits[i].status;
+            r.iterations = fits[i].iterations;
+            r.rms_error = fits[i].rms_error;
+            ++report.calibrated;
+
+            Node& node = nodes_[i];
+            node.pending = false;
+            if (r.status == SabrNodeReport::Status::Failed) continue;
+            if (r.status == SabrNodeReport::Status::Converged) ++report.converged;
+            model_.set_node(i / n_tenors, i % n_tenors, fits[i].params);
+            node.fitted = true;
+        }
+
+        report.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return report;
+    }
+}
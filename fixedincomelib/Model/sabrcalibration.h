@@ -0,0 +1,105 @@
+#pragma once
+
+#include "fixedincomelib/Model/sabr.h"
+#include "fixedincomelib/utils/threadpool.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Hagan vol with its analytic derivatives in alpha, rho and nu (beta and shift are held fixed in calibration)
+    // Scalar and through std::log / std::exp, for the calibrator's Jacobians rather than for pricing.
+    double sabr_implied_vol_gradient(const SabrParameters& p, double forward, double strike, double expiry,
+                                     double& d_alpha, double& d_rho, double& d_nu);
+
+    // Market smile at one expiry/tenor node: lognormal vols by strike, fitted in the (weighted) least squares sense
+    struct SabrQuotes {
+        double forward = 0.0;
+        std::vector<double> strikes;
+        std::vector<double> vols;
+        std::vector<double> weights;   // empty for all ones
+    };
+
+    struct SabrCalibrationOptions {
+        int max_iterations = 100;         // Levenberg-Marquardt trial steps per node
+        double gradient_tolerance = 1e-13;
+        double step_tolerance = 1e-10;    // on the step in the solver's variables (log alpha, atanh rho, log nu)
+    };
+
+    struct SabrNodeReport {
+        enum class Status {
+            Converged,       // the gradient or the last accepted step got under its tolerance
+            MaxIterations,   // kept, but flagged: out of iterations, or stalled short of both tolerances
+            Failed,          // no usable fit, the node keeps its previous parameters
+            Skipped,         // quotes unchanged since the last calibration
+            NoQuotes
+        };
+        // Where the solver started from
+        enum class Start { Previous, Neighbour, Guess };
+
+        Status status = Status::NoQuotes;
+        Start start = Start::Guess;
+        int iterations = 0;
+        double rms_error = 0.0;   // vols, weighted
+        double seconds = 0.0;
+    };
+
+    struct SabrCalibrationReport {
+        std::vector<SabrNodeReport> nodes;   // expiry-major, like the cube
+        std::size_t calibrated = 0;
+        std::size_t converged = 0;
+        std::size_t skipped = 0;
+        unsigned threads = 0;
+        double wall_seconds = 0.0;
+    };
+
+    // Fits alpha, rho and nu of every node of a SabrModel cube to its quoted smile, nodes in parallel on a ThreadPool
+    // Each node is a Levenberg-Marquardt fit on analytic Jacobians, in log alpha / atanh rho / log nu so the
+    // parameters stay in range without any clamping. A node starts from its own previous fit; if it has none, from
+    // the rho and nu of its fitted neighbours (previous runs only, so results don't depend on scheduling) with alpha
+    // from its ATM vol; failing that from the ATM vol, rho = 0 and nu = 0.5.
+    //
+    // set_quotes marks a node for recalibration only when its quotes actually changed, so an intraday run after a
+    // few quotes tick refits just those nodes.
+    class SabrCalibrator {
+        public:
+            // Nothing fitted yet, beta and shift the same at every node
+            SabrCalibrator(std::vector<double> expiries,
+                           std::vector<double> tenors,
+                           double beta,
+                           double shift = 0.0,
+                           SabrCalibrationOptions options = {});
+
+            // Picks up from an earlier cube (e.g. yesterday's close): its nodes are the warm starts, and its beta and
+            // shift are kept
+            explicit SabrCalibrator(SabrModel previous, SabrCalibrationOptions options = {});
+
+            // Throws std::invalid_argument if there are fewer than three strikes, sizes disagree, or a strike, the
+            // forward or a vol is out of range; std::out_of_range for a node that isn't on the grid
+            void set_quotes(std::size_t expiry_index, std::size_t tenor_index, SabrQuotes quotes);
+
+            bool pending(std::size_t expiry_index, std::size_t tenor_index) const;
+
+            // Refits every node whose quotes changed since the last calibration
+            // Not to be called from one of the pool's own workers (ThreadPool::parallel_for throws std::logic_error)
+            SabrCalibrationReport calibrate(ThreadPool& pool);
+
+            const SabrModel& model() const { return model_; }
+
+        private:
+            struct Node {
+                SabrQuotes quotes;
+                bool has_quotes = false;
+                bool pending = false;
+                bool fitted = false;
+            };
+
+            std::size_t index(std::size_t e, std::size_t t) const { return e * model_.tenors().size() + t; }
+
+            SabrModel model_;
+            SabrCalibrationOptions options_;
+            std::vector<Node> nodes_;
+    };
+
+}
@@ -0,0 +1,170 @@
+#include "fixedincomelib/Model/scenarioengine.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+    namespace {
+        // Per worker, reused across the scenario blocks it runs
+        struct Scratch {
+            std::vector<double> pv;      // trade x scenario
+            std::vector<double> df;      // curve x grid date x scenario, only the dates a curve is read at are filled
+            std::vector<double> curve;   // one curve at its dates
+        };
+    }
+
+    std::uint32_t ScenarioEngine::grid_point(serial_type date) {
+        const auto [it, added] = grid_index_.try_emplace(date, static_cast<std::uint32_t>(grid_.size()));
+        if (added) grid_.push_back(date);
+        return it->second;
+    }
+
+    std::size_t ScenarioEngine::add(std::size_t trade, const SwapLeg& leg, std::size_t discount_curve,
+                                    std::size_t projection_curve) {
+        if (trade >= std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("ScenarioEngine::add: trade number " + std::to_string(trade) + " is too large");
+        const std::size_t index = legs_.add(leg, discount_curve, projection_curve);
+        leg_trade_.push_back(static_cast<std::uint32_t>(trade));
+        trades_ = std::max(trades_, trade + 1);
+
+        // LegPortfolio appended the rows to the end of the leg's group, the grid indexes follow in the same order
+        const std::size_t group = legs_.leg_group_[index];
+        if (group == group_dates_.size()) group_dates_.emplace_back();
+        GroupDates& dates = group_dates_[group];
+        const bool floating = leg.type == SwapLeg::Type::Float;
+        for (const ScheduleRow& row : leg.rows) {
+            dates.payment.push_back(grid_point(row.paymentDate.serialNumber()));
+            if (floating) {
+                dates.start.push_back(grid_point(row.startDate.serialNumber()));
+                dates.end.push_back(grid_point(row.endDate.serialNumber()));
+            }
+        }
+        return index;
+    }
+
+    ScenarioPvs ScenarioEngine::price(std::span<const YieldCurve* const> curves, std::size_t curves_per_scenario,
+                                      ThreadPool& pool) const {
+        if (curves_per_scenario == 0 || curves.size() % curves_per_scenario != 0)
+            throw std::invalid_argument("ScenarioEngine::price: " + std::to_string(curves.size()) +
+                                        " curves is not a whole number of sets of " +
+                                        std::to_string(curves_per_scenario));
+        const std::size_t scenarios = curves.size() / curves_per_scenario;
+
+        // The curve ids the book uses, each given a slot in the date x scenario table. Ids and null curves are
+        // checked here; a curve that can't discount one of its dates (before its reference date) throws from the
+        // worker, and parallel_for passes that on.
+        constexpr std::size_t unused = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> slot(curves_per_scenario, unused), used;
+        for (const LegPortfolio::Group& g : legs_.groups_) {
+            for (std::size_t id : {g.discount, g.projection}) {
+                if (id == LegPortfolio::no_curve) continue;
+                if (id >= curves_per_scenario)
+                    throw std::invalid_argument("ScenarioEngine::price: no curve " + std::to_string(id) + " among " +
+                                                std::to_string(curves_per_scenario) + " per scenario");
+                if (slot[id] != unused) continue;
+                for (std::size_t s = 0; s < scenarios; ++s)
+                    if (curves[s * curves_per_scenario + id] == nullptr)
+                        throw std::invalid_argument("ScenarioEngine::price: curve " + std::to_string(id) +
+                                                    " of scenario " + std::to_string(s) + " is null");
+                slot[id] = used.size();
+                used.push_back(id);
+            }
+        }
+
+        // The grid points each curve is read at, in date order: payment dates for a discount curve, accrual starts
+        // and ends for a projection curve. A curve is only evaluated there, not over the whole grid, so curves with
+        // later reference dates than the rest of the book aren't asked for dates they don't cover.
+        const std::size_t points = grid_.size();
+        std::vector<std::vector<std::uint32_t>> reads(used.size());
+        std::vector<std::vector<serial_type>> read_dates(used.size());
+        {
+            std::vector<char> read(used.size() * points, 0);
+            for (std::size_t k = 0; k < legs_.groups_.size(); ++k) {
+                const LegPortfolio::Group& g = legs_.groups_[k];
+                const GroupDates& dates = group_dates_[k];
+                char* discount = read.data() + slot[g.discount] * points;
+                for (std::uint32_t p : dates.payment) discount[p] = 1;
+                if (g.projection == LegPortfolio::no_curve) continue;
+                char* projection = read.data() + slot[g.projection] * points;
+                for (std::uint32_t p : dates.start) projection[p] = 1;
+                for (std::uint32_t p : dates.end) projection[p] = 1;
+            }
+            for (std::size_t u = 0; u < used.size(); ++u) {
+                for (std::uint32_t p = 0; p < points; ++p)
+                    if (read[u * points + p]) reads[u].push_back(p);
+                std::sort(reads[u].begin(), reads[u].end(),
+                          [&](std::uint32_t a, std::uint32_t b) { return grid_[a] < grid_[b]; });
+                for (std::uint32_t p : reads[u]) read_dates[u].push_back(grid_[p]);
+            }
+        }
+
+        ScenarioPvs result;
+        result.scenarios = scenarios;
+        result.trades = trades_;
+        result.values.assign(scenarios * trades_, 0.0);
+        if (scenarios == 0 || trades_ == 0) return result;
+
+        // Enough blocks for every worker when scenarios are few, full-width blocks when there are plenty
+        const std::size_t width = std::clamp<std::size_t>((scenarios + pool.size() - 1) / pool.size(), 1,
+                                                          max_scenario_block);
+        const std::size_t blocks = (scenarios + width - 1) / width;
+        std::vector<Scratch> scratch(pool.size());
+
+        auto run = [&](std::size_t s0, std::size_t s1, Scratch& w) {
+            const std::size_t n = s1 - s0;
+            w.pv.assign(trades_ * n, 0.0);
+            w.df.resize(used.size() * points * n);
+            // Each curve of each scenario once at its dates, transposed so a date's scenarios are contiguous
+            for (std::size_t u = 0; u < used.size(); ++u) {
+                double* table = w.df.data() + u * points * n;
+                w.curve.resize(reads[u].size());
+                for (std::size_t s = 0; s < n; ++s) {
+                    curves[(s0 + s) * curves_per_scenario + used[u]]->discount(read_dates[u], w.curve);
+                    for (std::size_t i = 0; i < reads[u].size(); ++i)
+                        table[static_cast<std::size_t>(reads[u][i]) * n + s] = w.curve[i];
+                }
+            }
+
+            for (std::size_t k = 0; k < legs_.groups_.size(); ++k) {
+                const LegPortfolio::Group& g = legs_.groups_[k];
+                const GroupDates& dates = group_dates_[k];
+                const double* discount = w.df.data() + slot[g.discount] * points * n;
+
+                if (g.projection == LegPortfolio::no_curve) {
+                    for (std::size_t i = 0; i < g.payment.size(); ++i) {
+                        double* pv = w.pv.data() + static_cast<std::size_t>(leg_trade_[g.leg[i]]) * n;
+                        const double* d = discount + static_cast<std::size_t>(dates.payment[i]) * n;
+                        const double fixed = g.fixed_amount[i];
+                        for (std::size_t s = 0; s < n; ++s) pv[s] += fixed * d[s];
+                    }
+                    continue;
+                }
+
+                const double* projection = w.df.data() + slot[g.projection] * points * n;
+                for (std::size_t i = 0; i < g.payment.size(); ++i) {
+                    double* pv = w.pv.data() + static_cast<std::size_t>(leg_trade_[g.leg[i]]) * n;
+                    const double* d = discount + static_cast<std::size_t>(dates.payment[i]) * n;
+                    const double* p_start = projection + static_cast<std::size_t>(dates.start[i]) * n;
+                    const double* p_end = projection + static_cast<std::size_t>(dates.end[i]) * n;
+                    const double fixed = g.fixed_amount[i], notional = g.float_notional[i];
+                    // Same arithmetic as LegPortfolio::price, the forward in the leg's own accrual basis
+                    for (std::size_t s = 0; s < n; ++s)
+                        pv[s] += (fixed + notional * (p_start[s] / p_end[s] - 1.0)) * d[s];
+                }
+            }
+
+            for (std::size_t s = 0; s < n; ++s) {
+                double* out = result.values.data() + (s0 + s) * trades_;
+                for (std::size_t t = 0; t < trades_; ++t) out[t] = w.pv[t * n + s];
+            }
+        };
+
+        pool.parallel_for(blocks, 1, [&](std::size_t begin, std::size_t end, unsigned worker) {
+            for (std::size_t b = begin; b < end; ++b)
+                run(b * width, std::min(scenarios, (b + 1) * width), scratch[worker]);
+        });
+        return result;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Model/swappricer.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+#include "fixedincomelib/utils/threadpool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // PVs by scenario and trade, pv(s, t) = values[s * trades + t]
+    struct ScenarioPvs {
+        std::size_t scenarios = 0;
+        std::size_t trades = 0;
+        std::vector<double> values;
+
+        double operator()(std::size_t scenario, std::size_t trade) const { return values[scenario * trades + trade]; }
+        std::span<const double> scenario(std::size_t s) const {
+            return std::span<const double>(values).subspan(s * trades, trades);
+        }
+    };
+
+    // Revalues a book of trades under many curve scenarios (stress tests, historical VaR)
+    // Everything that doesn't depend on the curves is worked out once, as legs are added:
+    //   - the cashflow columns of a LegPortfolio (notionals, rates and accruals folded into per-cashflow weights)
+    //   - a grid of the distinct dates the cashflows use, with each cashflow's payment, start and end dates stored
+    //     as indexes into it
+    // A book's cashflows share most of their dates (same roll dates, same tenors), so a scenario only has to evaluate
+    // each of its curves once per grid date; a cashflow then gathers its discount factors by index. A curve is only
+    // evaluated at the grid dates it is read at (payment dates of the legs it discounts, accrual dates of the legs it
+    // projects), so a curve with a later reference date than the rest of the book is fine as long as its own legs
+    // start after it.
+    //
+    // price() splits the scenarios into blocks and runs the blocks on the pool. A block evaluates its scenarios'
+    // curves at their dates into a date x scenario table, then walks the cashflow columns once: each cashflow's weights
+    // are loaded once and applied to every scenario in the innermost loop, accumulating into a trade x scenario
+    // buffer. Scenarios are only split across threads, so no two threads ever write the same PV.
+    class ScenarioEngine {
+        public:
+            // Scenarios per block at most, the width of the innermost loop
+            static constexpr std::size_t max_scenario_block = 16;
+
+            // Adds a leg to trade `trade` (trades are numbered by the caller, from 0), the curve ids as for
+            // LegPortfolio::add, where they index into one scenario's curves; returns the leg's index
+            std::size_t add(std::size_t trade, const SwapLeg& leg, std::size_t discount_curve,
+                            std::size_t projection_curve = LegPortfolio::no_curve);
+
+            // One more than the largest trade number added
+            std::size_t trade_count() const { return trades_; }
+            std::size_t grid_size() const { return grid_.size(); }
+            const LegPortfolio& legs() const { return legs_; }
+
+            // curves holds the curve sets of the scenarios one after the other, curves_per_scenario each, so curve id
+            // c of scenario s is curves[s * curves_per_scenario + c]
+            // Throws std::invalid_argument if curves isn't a whole number of sets, a curve the book uses is null or a
+            // curve is read at a date before its reference date
+            ScenarioPvs price(std::span<const YieldCurve* const> curves, std::size_t curves_per_scenario,
+                              ThreadPool& pool) const;
+
+        private:
+            std::uint32_t grid_point(serial_type date);
+
+            // Grid indexes of a LegPortfolio group's cashflows, in the group's order
+            struct GroupDates {
+                std::vector<std::uint32_t> payment;
+                std::vector<std::uint32_t> start;   // empty for fixed groups
+                std::vector<std::uint32_t> end;
+            };
+
+            LegPortfolio legs_;
+            std::vector<std::uint32_t> leg_trade_;
+            std::size_t trades_ = 0;
+            std::vector<GroupDates> group_dates_;
+            std::vector<serial_type> grid_;
+            std::unordered_map<serial_type, std::uint32_t> grid_index_;
+    };
+
+}
@@ -0,0 +1,149 @@
+#include "fixedincomelib/Model/swappricer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+    namespace {
+        // Cashflows per block: the date and discount factor buffers for one block stay in L1
+        constexpr std::size_t block = 256;
+
+        const YieldCurve& curve_at(std::span<const YieldCurve* const> curves, std::size_t id) {
+            if (id >= curves.size() || curves[id] == nullptr)
+                throw std::invalid_argument("LegPortfolio::price: no curve " + std::to_string(id) + " among " +
+                                            std::to_string(curves.size()));
+            return *curves[id];
+        }
+    }
+
+    LegValue price_leg(const SwapLeg& leg, const YieldCurve& discount, const YieldCurve* projection) {
+        const bool floating = leg.type == SwapLeg::Type::Float;
+        if (floating && projection == nullptr)
+            throw std::invalid_argument("price_leg: a float leg needs a projection curve");
+
+        serial_type pay[block], start[block], end[block];
+        double df[block], p_start[block], p_end[block];
+        LegValue value;
+        for (std::size_t b = 0; b < leg.rows.size(); b += block) {
+            const std::size_t m = std::min(block, leg.rows.size() - b);
+            const std::span<const ScheduleRow> rows = leg.rows.subspan(b, m);
+            for (std::size_t i = 0; i < m; ++i) pay[i] = rows[i].paymentDate.serialNumber();
+            discount.discount(std::span<const serial_type>(pay, m), std::span<double>(df, m));
+
+            if (floating) {
+                for (std::size_t i = 0; i < m; ++i) {
+                    start[i] = rows[i].startDate.serialNumber();
+                    end[i] = rows[i].endDate.serialNumber();
+                }
+                projection->discount(std::span<const serial_type>(start, m), std::span<double>(p_start, m));
+                projection->discount(std::span<const serial_type>(end, m), std::span<double>(p_end, m));
+            }
+
+            // Same arithmetic as LegPortfolio::price, so a leg prices identically either way
+            for (std::size_t i = 0; i < m; ++i) {
+                double amount = leg.notional * leg.rate * rows[i].accrued;
+                if (floating) amount += leg.notional * (p_start[i] / p_end[i] - 1.0);
+                value.pv += amount * df[i];
+                value.annuity += leg.notional * rows[i].accrued * df[i];
+            }
+        }
+        return value;
+    }
+
+    SwapValue swap_value(const LegValue& fixed_leg, const LegValue& float_leg) {
+        SwapValue v;
+        v.fixed_pv = fixed_leg.pv;
+        v.float_pv = float_leg.pv;
+        v.pv = fixed_leg.pv + float_leg.pv;
+        if (fixed_leg.annuity == 0.0) throw std::invalid_argument("swap_value: the fixed leg has no annuity");
+        v.par_rate = -float_leg.pv / fixed_leg.annuity;
+        return v;
+    }
+
+    SwapValue price_swap(const SwapLeg& fixed_leg, const SwapLeg& float_leg, const YieldCurve& discount,
+                         const YieldCurve& projection) {
+        if (fixed_leg.type != SwapLeg::Type::Fixed || float_leg.type != SwapLeg::Type::Float)
+            throw std::invalid_argument("price_swap: expected a fixed leg and a float leg");
+        return swap_value(price_leg(fixed_leg, discount), price_leg(float_leg, discount, &projection));
+    }
+
+    std::size_t LegPortfolio::add(const SwapLeg& leg, std::size_t discount_curve, std::size_t projection_curve) {
+        if (discount_curve == no_curve) throw std::invalid_argument("LegPortfolio::add: no discount curve");
+        const bool floating = leg.type == SwapLeg::Type::Float;
+        if (floating && projection_curve == no_curve)
+            throw std::invalid_argument("LegPortfolio::add: a float leg needs a projection curve");
+        if (leg_group_.size() >= std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("LegPortfolio::add: too many legs");
+        if (!floating) projection_curve = no_curve;
+
+        // A handful of curve pairs in practice, so a scan is fine
+        auto it = std::find_if(groups_.begin(), groups_.end(), [&](const Group& g) {
+            return g.discount == discount_curve && g.projection == projection_curve;
+        });
+        if (it == groups_.end()) {
+            groups_.push_back(Group{discount_curve, projection_curve, {}, {}, {}, {}, {}, {}, {}});
+            it = groups_.end() - 1;
+        }
+        Group& g = *it;
+
+        const std::uint32_t index = static_cast<std::uint32_t>(leg_group_.size());
+        for (const ScheduleRow& row : leg.rows) {
+            g.payment.push_back(row.paymentDate.serialNumber());
+            if (floating) {
+                g.start.push_back(row.startDate.serialNumber());
+                g.end.push_back(row.endDate.serialNumber());
+                g.float_notional.push_back(leg.notional);
+            }
+            g.fixed_amount.push_back(leg.notional * leg.rate * row.accrued);
+            g.annuity_weight.push_back(leg.notional * row.accrued);
+            g.leg.push_back(index);
+        }
+        leg_group_.push_back(static_cast<std::size_t>(it - groups_.begin()));
+        return index;
+    }
+
+    std::size_t LegPortfolio::cashflow_count() const {
+        std::size_t n = 0;
+        for (const Group& g : groups_) n += g.payment.size();
+        return n;
+    }
+
+    void LegPortfolio::price(std::span<const YieldCurve* const> curves, std::span<LegValue> out) const {
+        if (out.size() < size())
+            throw std::invalid_argument("LegPortfolio::price: output buffer is smaller than the portfolio");
+        std::fill(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(size()), LegValue{});
+
+        double df[block], p_start[block], p_end[block];
+        for (const Group& g : groups_) {
+            const YieldCurve& discount = curve_at(curves, g.discount);
+            const YieldCurve* projection = g.projection == no_curve ? nullptr : &curve_at(curves, g.projection);
+
+            const std::size_t n = g.payment.size();
+            for (std::size_t b = 0; b < n; b += block) {
+                const std::size_t m = std::min(block, n - b);
+                discount.discount(std::span<const serial_type>(g.payment.data() + b, m), std::span<double>(df, m));
+                if (projection) {
+                    projection->discount(std::span<const serial_type>(g.start.data() + b, m),
+                                         std::span<double>(p_start, m));
+                    projection->discount(std::span<const serial_type>(g.end.data() + b, m),
+                                         std::span<double>(p_end, m));
+                    for (std::size_t i = 0; i < m; ++i) {
+                        const double amount =
+                            g.fixed_amount[b + i] + g.float_notional[b + i] * (p_start[i] / p_end[i] - 1.0);
+                        LegValue& v = out[g.leg[b + i]];
+                        v.pv += amount * df[i];
+                        v.annuity += g.annuity_weight[b + i] * df[i];
+                    }
+                } else {
+                    for (std::size_t i = 0; i < m; ++i) {
+                        LegValue& v = out[g.leg[b + i]];
+                        v.pv += g.fixed_amount[b + i] * df[i];
+                        v.annuity += g.annuity_weight[b + i] * df[i];
+                    }
+                }
+            }
+        }
+    }
+}
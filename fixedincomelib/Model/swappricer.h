@@ -0,0 +1,95 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // One leg of a swap over rows from make_schedule
+    //   Fixed: notional * rate * accrued, paid on each row's payment date
+    //   Float: notional * (forward + rate) * accrued, rate being the spread. The forward is projected over the row's
+    //          accrual period (startDate to endDate) in the leg's own day count, the one its accrued comes from:
+    //          forward * accrued = P(start) / P(end) - 1 on the projection curve.
+    // Notional is signed, negative for the leg that is paid. The rows aren't copied and must outlive the leg.
+    struct SwapLeg {
+        enum class Type { Fixed, Float };
+
+        Type type = Type::Fixed;
+        std::span<const ScheduleRow> rows;
+        double notional = 1.0;
+        double rate = 0.0;
+    };
+
+    struct LegValue {
+        double pv = 0.0;
+        double annuity = 0.0;   // PV of paying 1 (as a rate) on the leg's notional and accruals
+    };
+
+    // The projection curve is only used for float legs; leaving it null for one throws std::invalid_argument
+    LegValue price_leg(const SwapLeg& leg, const YieldCurve& discount, const YieldCurve* projection = nullptr);
+
+    struct SwapValue {
+        double pv = 0.0;
+        double fixed_pv = 0.0;
+        double float_pv = 0.0;
+        double par_rate = 0.0;   // the fixed rate that sets pv to 0, with the float leg as it is
+    };
+
+    SwapValue price_swap(const SwapLeg& fixed_leg, const SwapLeg& float_leg, const YieldCurve& discount,
+                         const YieldCurve& projection);
+
+    // From the two leg values: pv is the sum, par rate is -float_pv / fixed annuity
+    SwapValue swap_value(const LegValue& fixed_leg, const LegValue& float_leg);
+
+    // Many legs priced together on a set of curves
+    // Legs are grouped by their (discount, projection) curve pair when they are added, and each group keeps its
+    // cashflows in contiguous columns (payment, accrual start and end serials, and the per-cashflow weights with the
+    // notional, rate and accrued already multiplied in). Pricing walks a group in blocks of cashflows: one batch
+    // discount call per date column into stack buffers, then one fused loop that scatters amounts into the legs. No
+    // ScheduleRow, QuantLib::Date or curve lookup by name is touched on that path.
+    //
+    // Curve ids are indexes into the span of curves given to price(), so the same book can be priced on today's
+    // curves, on bumped ones, or on a scenario set without being rebuilt. price() is const and can run concurrently.
+    class LegPortfolio {
+        public:
+            static constexpr std::size_t no_curve = std::numeric_limits<std::size_t>::max();
+
+            // Copies the cashflows in and returns the leg's index (legs are numbered in the order they are added)
+            // Float legs need a projection curve, fixed legs ignore it; throws std::invalid_argument otherwise
+            std::size_t add(const SwapLeg& leg, std::size_t discount_curve, std::size_t projection_curve = no_curve);
+
+            std::size_t size() const { return leg_group_.size(); }
+            std::size_t cashflow_count() const;
+            std::size_t group_count() const { return groups_.size(); }
+
+            // out[i] for leg i, out must be at least size() long
+            // Throws std::invalid_argument if a curve id is past the end of curves or its curve is null
+            void price(std::span<const YieldCurve* const> curves, std::span<LegValue> out) const;
+
+        private:
+            friend class ScenarioEngine;   // prices the same columns under many curve sets
+
+            struct Group {
+                std::size_t discount;
+                std::size_t projection;        // no_curve when every leg in the group is fixed
+                std::vector<serial_type> payment;
+                std::vector<serial_type> start;    // empty without projection
+                std::vector<serial_type> end;
+                std::vector<double> fixed_amount;  // notional * rate * accrued (rate is the spread on float legs)
+                std::vector<double> float_notional;   // notional on float legs, 0 on fixed ones
+                std::vector<double> annuity_weight;   // notional * accrued
+                std::vector<std::uint32_t> leg;
+            };
+
+            std::vector<Group> groups_;
+            std::vector<std::size_t> leg_group_;
+    };
+
+}
@@ -0,0 +1,190 @@
+#include "fixedincomelib/Model/yieldcurve.h"
+#include "fixedincomelib/Model/curvemath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace fixedincomelib {
+    namespace {
+        // Queries are handled this many at a time through stack buffers
+        constexpr std::size_t block = 64;
+
+        using curve_detail::days_per_year;
+        using curve_detail::monotone_convex_integral;
+    }
+
+    YieldCurve::YieldCurve(const QuantLib::Date& reference_date,
+                           std::span<const serial_type> pillars,
+                           std::span<const double> discount_factors,
+                           CurveInterpolation interpolation,
+                           const QuantLib::DayCounter& forward_basis)
+        : interpolation_(interpolation),
+          forward_basis_(forward_basis),
+          forward_kernel_(year_fraction_kernel(forward_basis)) {
+        if (pillars.empty()) throw std::invalid_argument("YieldCurve: no pillars");
+
+        const std::size_t n = pillars.size();
+        serials_.reserve(n + 1);
+        times_.reserve(n + 1);
+
+        const serial_type reference = reference_date.serialNumber();
+        serials_.push_back(reference);
+        times_.push_back(0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (pillars[i] <= serials_.back())
+                throw std::invalid_argument("YieldCurve: pillar " + Date(QuantLib::Date(pillars[i])).get_date_str() +
+                                            " is not after " + Date(QuantLib::Date(serials_.back())).get_date_str());
+            serials_.push_back(pillars[i]);
+            times_.push_back(static_cast<double>(pillars[i] - reference) / days_per_year);
+        }
+
+        log_df_.assign(n + 1, 0.0);
+        forward_.assign(n + 1, 0.0);
+        if (interpolation_ == CurveInterpolation::MonotoneConvex) {
+            g0_.assign(n + 1, 0.0);
+            g1_.assign(n + 1, 0.0);
+        }
+        set_discount_factors(discount_factors);
+    }
+
+    void YieldCurve::set_discount_factors(std::span<const double> discount_factors) {
+        const std::size_t n = segment_count();
+        if (discount_factors.size() != n)
+            throw std::invalid_argument("YieldCurve: " + std::to_string(n) + " pillars but " +
+                                        std::to_string(discount_factors.size()) + " discount factors");
+        for (std::size_t i = 0; i < n; ++i)
+            if (!(discount_factors[i] > 0.0))
+                throw std::invalid_argument("YieldCurve: discount factor " + std::to_string(discount_factors[i]) +
+                                            " at " + Date(QuantLib::Date(serials_[i + 1])).get_date_str() +
+                                            " is not positive");
+
+        for (std::size_t k = 1; k <= n; ++k)
+            log_df_[k] = std::log(discount_factors[k - 1]);
+        curve_detail::segment_forwards<double>(times_, log_df_, interpolation_ == CurveInterpolation::MonotoneConvex,
+                                               forward_, g0_, g1_, tail_forward_);
+    }
+
+    std::size_t YieldCurve::locate(serial_type s) const {
+        // lower_bound over serials_[1..n], written so the compiler turns the compare into a conditional move
+        const serial_type* base = serials_.data() + 1;
+        std::size_t len = segment_count();
+        while (len > 1) {
+            const std::size_t half = len / 2;
+            base = base[half - 1] < s ? base + half : base;
+            len -= half;
+        }
+        const std::size_t k = static_cast<std::size_t>(base - serials_.data());
+        return *base < s ? segment_count() : k;
+    }
+
+    void YieldCurve::log_discount(const serial_type* dates, double* out, std::size_t n) const {
+        if (n == 0) return;
+
+        const serial_type reference = serials_.front();
+        const std::size_t last = segment_count();
+        const serial_type last_pillar = serials_[last];
+        const bool monotone_convex = interpolation_ == CurveInterpolation::MonotoneConvex;
+
+        std::size_t k = locate(dates[0]);
+        for (std::size_t i = 0; i < n; ++i) {
+            const serial_type s = dates[i];
+            if (s < reference)
+                throw std::invalid_argument("YieldCurve: " + Date(QuantLib::Date(s)).get_date_str() +
+                                            " is before the reference date " +
+                                            Date(reference_date()).get_date_str());
+
+            // Sorted queries move the cursor forward a pillar at a time, anything behind it is looked up again
+            if (s < serials_[k - 1]) {
+                k = locate(s);
+            } else {
+                while (k < last && s > serials_[k]) ++k;
+            }
+
+            const double t = static_cast<double>(s - reference) / days_per_year;
+            if (s > last_pillar) {
+                out[i] = log_df_[last] - tail_forward_ * (t - times_[last]);
+                continue;
+            }
+
+            const double dt = t - times_[k - 1];
+            double log_df = log_df_[k - 1] - forward_[k] * dt;
+            if (monotone_convex) {
+                const double h = times_[k] - times_[k - 1];
+                log_df -= h * monotone_convex_integral(g0_[k], g1_[k], dt / h);
+            }
+            out[i] = log_df;
+        }
+    }
+
+    double YieldCurve::discount(serial_type date) const {
+        double log_df;
+        log_discount(&date, &log_df, 1);
+        return std::exp(log_df);
+    }
+
+    void YieldCurve::discount(std::span<const serial_type> dates, std::span<double> out) const {
+        if (out.size() < dates.size())
+            throw std::invalid_argument("YieldCurve::discount: output buffer is smaller than the input");
+        log_discount(dates.data(), out.data(), dates.size());
+        for (std::size_t i = 0; i < dates.size(); ++i)
+            out[i] = std::exp(out[i]);
+    }
+
+    double YieldCurve::forward(serial_type start, serial_type end) const {
+        double rate;
+        forward(std::span<const serial_type>(&start, 1), std::span<const serial_type>(&end, 1),
+                std::span<double>(&rate, 1));
+        return rate;
+    }
+
+    void YieldCurve::forward(std::span<const serial_type> start, std::span<const serial_type> end,
+                             std::span<double> out) const {
+        if (start.size() != end.size())
+            throw std::invalid_argument("YieldCurve::forward: start and end columns differ in length");
+        if (out.size() < start.size())
+            throw std::invalid_argument("YieldCurve::forward: output buffer is smaller than the input");
+
+        double log_start[block], log_end[block], tau[block];
+        for (std::size_t b = 0; b < start.size(); b += block) {
+            const std::size_t m = std::min(block, start.size() - b);
+            log_discount(start.data() + b, log_start, m);
+            log_discount(end.data() + b, log_end, m);
+            year_fractions(forward_kernel_, forward_basis_, start.subspan(b, m), end.subspan(b, m),
+                           std::span<double>(tau, m));
+            for (std::size_t i = 0; i < m; ++i) {
+                if (tau[i] == 0.0)
+                    throw std::invalid_argument("YieldCurve::forward: empty period starting " +
+                                                Date(QuantLib::Date(start[b + i])).get_date_str());
+                out[b + i] = (std::exp(log_start[i] - log_end[i]) - 1.0) / tau[i];
+            }
+        }
+    }
+
+    void YieldCurve::discount_payments(std::span<const ScheduleRow> leg, std::span<double> out) const {
+        if (out.size() < leg.size())
+            throw std::invalid_argument("YieldCurve::discount_payments: output buffer is smaller than the leg");
+
+        serial_type dates[block];
+        for (std::size_t b = 0; b < leg.size(); b += block) {
+            const std::size_t m = std::min(block, leg.size() - b);
+            for (std::size_t i = 0; i < m; ++i)
+                dates[i] = leg[b + i].paymentDate.serialNumber();
+            discount(std::span<const serial_type>(dates, m), out.subspan(b, m));
+        }
+    }
+
+    void YieldCurve::discount_payments(const ScheduleTable& table, std::span<double> out) const {
+        if (out.size() < table.row_count())
+            throw std::invalid_argument("YieldCurve::discount_payments: output buffer is smaller than the table");
+
+        const auto payments = table.payment_dates();
+        serial_type dates[block];
+        for (std::size_t b = 0; b < payments.size(); b += block) {
+            const std::size_t m = std::min(block, payments.size() - b);
+            table.decode(payments.subspan(b, m), std::span<serial_type>(dates, m));
+            discount(std::span<const serial_type>(dates, m), out.subspan(b, m));
+        }
+    }
+}
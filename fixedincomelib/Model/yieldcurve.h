@@ -0,0 +1,102 @@
+#pragma once
+
+#include "fixedincomelib/Date/scheduletable.h"
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/Date/yearfraction.h"
+#include "fixedincomelib/Model/model.h"
+
+#include <ql/time/date.hpp>
+#include <ql/time/daycounter.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace fixedincomelib {
+
+    enum class CurveInterpolation {
+        LogLinearDiscount,   // piecewise flat forwards between pillars
+        MonotoneConvex       // Hagan-West: continuous forwards, no spurious wiggles, exact on the pillars
+    };
+
+    // Discount curve for ModelType::YIELD_CURVE
+    // Pillars are kept as contiguous sorted columns (serials, times, log discount factors and per-segment forwards),
+    // with the reference date as an implicit pillar with discount factor 1. Time on the curve is ACT/365 from the
+    // reference date; forward rates are quoted in the curve's own day counter.
+    //
+    // The batch queries are the fast path: each one walks a cursor over the pillars, so sorted queries (a leg's
+    // payment dates, a table of legs) cost a compare or two each, and a query behind the cursor re-seats it with a
+    // branch-free binary search. Past the last pillar the curve extrapolates with a flat instantaneous forward.
+    class YieldCurve {
+        public:
+            // Throws std::invalid_argument unless pillars are strictly increasing, after the reference date, and
+            // every discount factor is positive
+            YieldCurve(const QuantLib::Date& reference_date,
+                       std::span<const serial_type> pillars,
+                       std::span<const double> discount_factors,
+                       CurveInterpolation interpolation = CurveInterpolation::LogLinearDiscount,
+                       const QuantLib::DayCounter& forward_basis = QuantLib::Actual365Fixed());
+
+            // New discount factors on the same pillars, without reallocating (what a bootstrapper does per tick)
+            // Same checks as the constructor, throws std::invalid_argument
+            void set_discount_factors(std::span<const double> discount_factors);
+
+            ModelType model_type() const { return ModelType(ModelType::YIELD_CURVE); }
+            CurveInterpolation interpolation() const { return interpolation_; }
+            QuantLib::Date reference_date() const { return QuantLib::Date(serials_.front()); }
+            const QuantLib::DayCounter& forward_basis() const { return forward_basis_; }
+
+            // Pillars as given, without the reference date
+            std::span<const serial_type> pillars() const { return std::span<const serial_type>(serials_).subspan(1); }
+            std::span<const double> log_discount_factors() const {
+                return std::span<const double>(log_df_).subspan(1);
+            }
+
+            // Dates before the reference date throw std::invalid_argument
+            double discount(serial_type date) const;
+            double discount(const QuantLib::Date& date) const { return discount(date.serialNumber()); }
+
+            // out[i] = discount(dates[i]), out must be at least dates.size() long
+            void discount(std::span<const serial_type> dates, std::span<double> out) const;
+
+            // Simply compounded forward rate over [start, end] in forward_basis()
+            double forward(serial_type start, serial_type end) const;
+
+            // out[i] = forward(start[i], end[i]), with the accruals from the column year-fraction kernels
+            void forward(std::span<const serial_type> start, std::span<const serial_type> end,
+                         std::span<double> out) const;
+
+            // Discount factors at the payment dates of a leg, or of every row of a ScheduleTable, in one call
+            void discount_payments(std::span<const ScheduleRow> leg, std::span<double> out) const;
+            void discount_payments(const ScheduleTable& table, std::span<double> out) const;
+
+        private:
+            // Log discount factors for a run of dates, the one loop every discount query ends up in
+            void log_discount(const serial_type* dates, double* out, std::size_t n) const;
+
+            // Index k of the segment (serials_[k-1], serials_[k]] holding s, segment_count() for s past the last pillar
+            std::size_t locate(serial_type s) const;
+
+            std::size_t segment_count() const { return serials_.size() - 1; }
+
+            CurveInterpolation interpolation_;
+            QuantLib::DayCounter forward_basis_;
+            YearFractionKernel forward_kernel_;
+
+            // Node 0 is the reference date
+            std::vector<serial_type> serials_;
+            std::vector<double> times_;
+            std::vector<double> log_df_;
+
+            // Per segment k (index k, entry 0 unused): the discrete forward -d(log DF)/dt over the segment and, for
+            // monotone convex, the instantaneous forwards at both ends less that discrete forward (g0, g1 in
+            // Hagan-West)
+            std::vector<double> forward_;
+            std::vector<double> g0_;
+            std::vector<double> g1_;
+            double tail_forward_ = 0.0;
+    };
+
+}
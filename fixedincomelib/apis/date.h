@@ -2,7 +2,12 @@
 
 #include "fixedincomelib/Date/utilities.h"
 #include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/format.h"
+#include "fixedincomelib/Date/schedulewriter.h"
+#include "fixedincomelib/Date/schedulecache.h"
 #include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/utils/instrumentation.h"
 
 #include <ql/time/date.hpp>
 #include <ql/time/period.hpp>
@@ -13,17 +18,18 @@
 #include <vector>
 #include <string>
 #include <string_view>
-#include <array>
-#include <algorithm>
-#include <sstream>
-#include <iomanip>
 
 namespace fixedincomelib { 
+    // Conventions are resolved through the process-wide ConventionRegistry (market/registry.h), so repeated calls
+    // with the same holiday convention / accrual basis reuse the same QuantLib objects instead of rebuilding them
+    // Each wrapper carries an instrumentation probe split into parse / conventions / quantlib / format stages
+    // (utils/instrumentation.h), compiled out unless FIXEDINCOMELIB_INSTRUMENTATION is on
+
     // Convert QuantLib Date object to string
+    // Same text as QuantLib::io::long_date, e.g. 'January 31st, 2025'
     std::string to_iso(const QuantLib::Date& d) {
-        std::ostringstream oss;
-        oss << QuantLib::io::long_date(d);
-        return oss.str();
+        char buf[long_date_max_size];
+        return std::string(buf, format_long_date(d, buf));
     }
 
     // Functions that take strings as inputs and returns a string as an output (mainly for viewing)
@@ -32,12 +38,17 @@ namespace fixedincomelib {
                             std::string holiday_convention = "NONE",
                             std::string business_day_convention = "NONE",
                             bool end_of_month = false) {
+        FIXEDINCOMELIB_PROBE(qfAddPeriod);
+        FIXEDINCOMELIB_STAGE(parse);
         Date start = Date(start_date);
         QuantLib::Period period = Period(QuantLib::PeriodParser::parse(std::string(term)));
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
-        QuantLib::BusinessDayConvention bdc = bdc_from_string(business_day_convention);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        QuantLib::BusinessDayConvention bdc = conventions().bdc(business_day_convention);
 
+        FIXEDINCOMELIB_STAGE(quantlib);
         Date end_date = add_period(start, period, cal, bdc, end_of_month);
+        FIXEDINCOMELIB_STAGE(format);
         return end_date.get_date_str();
     }
 
@@ -47,12 +58,16 @@ namespace fixedincomelib {
                      std::string accrual_basis = "NONE",
                      std::string business_day_convention = "NONE",
                      std::string holiday_convention = "NONE") {
+        FIXEDINCOMELIB_PROBE(qfAccrued);
+        FIXEDINCOMELIB_STAGE(parse);
         Date start = Date(start_date);
         Date end = Date(end_date);
-        QuantLib::DayCounter dc  = accrualbasis_from_string(accrual_basis);
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
-        QuantLib::BusinessDayConvention bdc = bdc_from_string(business_day_convention);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::DayCounter& dc = conventions().day_counter(accrual_basis);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        QuantLib::BusinessDayConvention bdc = conventions().bdc(business_day_convention);
 
+        FIXEDINCOMELIB_STAGE(quantlib);
         return accrued(start, end, dc, bdc, cal);
     }
 
@@ -60,46 +75,88 @@ namespace fixedincomelib {
     std::string qfMoveToBusinessDay(std::string input_date,
                                     std::string business_day_convention,
                                     std::string holiday_convention) {
+        FIXEDINCOMELIB_PROBE(qfMoveToBusinessDay);
+        FIXEDINCOMELIB_STAGE(parse);
         Date d = Date(input_date);
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
-        QuantLib::BusinessDayConvention bdc = bdc_from_string(business_day_convention);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        QuantLib::BusinessDayConvention bdc = conventions().bdc(business_day_convention);
 
+        FIXEDINCOMELIB_STAGE(quantlib);
         Date moved = move_to_business_day(d, cal, bdc);
+        FIXEDINCOMELIB_STAGE(format);
         return moved.get_date_str();
     }
 
     // qfIsBusinessDay(date, hol) -> bool
     inline bool qfIsBusinessDay(std::string input_date,
                                 std::string holiday_convention) {
+        FIXEDINCOMELIB_PROBE(qfIsBusinessDay);
+        FIXEDINCOMELIB_STAGE(parse);
         Date d = Date(input_date);
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        FIXEDINCOMELIB_STAGE(quantlib);
         return is_business_day(d, cal);
     }
 
     // qfIsHoliday(date, hol) -> bool
     inline bool qfIsHoliday(std::string input_date,
                             std::string holiday_convention) {
+        FIXEDINCOMELIB_PROBE(qfIsHoliday);
+        FIXEDINCOMELIB_STAGE(parse);
         Date d = Date(input_date);
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        FIXEDINCOMELIB_STAGE(quantlib);
         return is_holiday(d, cal);
     }
 
     // qfIsEndOfMonth(date, hol) -> bool
     inline bool qfIsEndOfMonth(std::string input_date,
                                std::string holiday_convention) {
+        FIXEDINCOMELIB_PROBE(qfIsEndOfMonth);
+        FIXEDINCOMELIB_STAGE(parse);
         Date d = Date(input_date);
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        FIXEDINCOMELIB_STAGE(quantlib);
         return is_end_of_month(d, cal);
     }
 
     // qfEndOfMonth(date, hol) -> ISO string
     inline std::string qfEndOfMonth(std::string input_date,
                                     std::string holiday_convention) {
+        FIXEDINCOMELIB_PROBE(qfEndOfMonth);
+        FIXEDINCOMELIB_STAGE(parse);
         Date d = Date(input_date);
-        QuantLib::Calendar cal = calendar_from_string(holiday_convention);
-        return end_of_month(d, cal).get_date_str();
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& cal = conventions().calendar(holiday_convention);
+        FIXEDINCOMELIB_STAGE(quantlib);
+        Date eom = end_of_month(d, cal);
+        FIXEDINCOMELIB_STAGE(format);
+        return eom.get_date_str();
     }
     
+    // qfAddHoliday(date, hol) / qfRemoveHoliday(date, hol), e.g. an unscheduled market closure
+    // The change is made on the registry's calendar, which every copy of it shares. The registry then rebuilds its
+    // bitmap calendars for it (so the batch APIs, ScheduleEngine and SchedulePipeline see the change too) and the
+    // schedules the process-wide ScheduleCache built with it are dropped, so qfMakeSchedule sees it as well.
+    inline void qfAddHoliday(std::string input_date,
+                             std::string holiday_convention) {
+        Date d = Date(input_date);
+        conventions().add_holiday(holiday_convention, d.get_date());
+    }
+
+    inline void qfRemoveHoliday(std::string input_date,
+                                std::string holiday_convention) {
+        Date d = Date(input_date);
+        conventions().remove_holiday(holiday_convention, d.get_date());
+    }
+
+    // Identical terms are served from the process-wide ScheduleCache; change holidays through qfAddHoliday /
+    // qfRemoveHoliday (or ConventionRegistry::add_holiday / remove_holiday) so cached schedules don't outlive the
+    // calendar
     std::string qfMakeSchedule(std::string start_date,
                                 std::string end_date,
                                 std::string accrual_period,
@@ -112,7 +169,11 @@ namespace fixedincomelib {
                                 std::string fixing_offset = "0D",
                                 std::string payment_offset = "0D",
                                 std::string payment_business_day_convention = "F",
-                                std::string payment_holiday_convention = "USGS") {
+                                std::string payment_holiday_convention = "USGS",
+                                std::string format = "TEXT") {
+        FIXEDINCOMELIB_PROBE(qfMakeSchedule);
+        FIXEDINCOMELIB_STAGE(parse);
+        const ScheduleFormat out_format = schedule_format_from_string(format);
         Date s(start_date);
         Date e(end_date);
     
@@ -120,14 +181,17 @@ namespace fixedincomelib {
         QuantLib::Period fix_off    = QuantLib::PeriodParser::parse(fixing_offset);
         QuantLib::Period pay_off    = QuantLib::PeriodParser::parse(payment_offset);
     
-        QuantLib::Calendar accrualCal = calendar_from_string(holiday_convention);
-        QuantLib::BusinessDayConvention accrualBdc = bdc_from_string(business_day_convention);
-        QuantLib::DayCounter dc = accrualbasis_from_string(accrual_basis);
+        FIXEDINCOMELIB_STAGE(conventions);
+        const QuantLib::Calendar& accrualCal = conventions().calendar(holiday_convention);
+        QuantLib::BusinessDayConvention accrualBdc = conventions().bdc(business_day_convention);
+        const QuantLib::DayCounter& dc = conventions().day_counter(accrual_basis);
     
-        QuantLib::Calendar payCal = calendar_from_string(payment_holiday_convention);
-        QuantLib::BusinessDayConvention payBdc = bdc_from_string(payment_business_day_convention);
+        const QuantLib::Calendar& payCal = conventions().calendar(payment_holiday_convention);
+        QuantLib::BusinessDayConvention payBdc = conventions().bdc(payment_business_day_convention);
     
-        std::vector<ScheduleRow> schedule = make_schedule(
+        FIXEDINCOMELIB_STAGE(quantlib);
+        // Identical terms are built once and shared through the process-wide ScheduleCache
+        ScheduleCache::Schedule schedule = schedule_cache().schedule(
             s, e, acc_period,
             accrualCal, accrualBdc, dc,
             rule,
@@ -139,58 +203,9 @@ namespace fixedincomelib {
             payCal
         );
     
-        // ---------- aligned output (returns a string) ----------
-        auto fmt_double = [](double x, int prec = 6) {
-            std::ostringstream oss;
-            oss << std::fixed << std::setprecision(prec) << x;
-            return oss.str();
-        };
-    
-        const std::vector<std::string> headers = {
-            "StartDate","EndDate","FixingDate","PaymentDate","Accrued"
-        };
-    
-        std::vector<std::array<std::string,5>> data;
-        data.reserve(schedule.size());
-    
-        for (const auto& r : schedule) {
-            data.push_back({
-                Date(r.startDate).get_date_str(),   // "dd-mm-yyyy"
-                Date(r.endDate).get_date_str(),
-                Date(r.fixingDate).get_date_str(),
-                Date(r.paymentDate).get_date_str(),
-                fmt_double(r.accrued, 6)
-            });
-        }
-    
-        std::array<std::size_t,5> w{};
-        for (int j = 0; j < 5; ++j) w[j] = headers[j].size();
-        for (const auto& row : data)
-            for (int j = 0; j < 5; ++j)
-                w[j] = std::max(w[j], row[j].size());
-    
-        std::ostringstream out;
-    
-        // header
-        for (int j = 0; j < 5; ++j)
-            out << std::left << std::setw(static_cast<int>(w[j] + 2)) << headers[j];
-        out << "\n";
-    
-        // separator
-        for (int j = 0; j < 5; ++j)
-            out << std::string(w[j], '-') << "  ";
-        out << "\n";
-    
-        // rows
-        for (const auto& row : data) {
-            for (int j = 0; j < 5; ++j) {
-                if (j == 4) out << std::right << std::setw(static_cast<int>(w[j] + 2)) << row[j];
-                else        out << std::left  << std::setw(static_cast<int>(w[j] + 2)) << row[j];
-            }
-            out << "\n";
-        }
-    
-        return out.str();
+        // Rows go straight into the chosen sink (aligned text by default, or CSV / JSON lines)
+        FIXEDINCOMELIB_STAGE(format);
+        return write_schedule(*schedule, out_format);
     }
 }
 
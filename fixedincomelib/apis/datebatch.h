@@ -0,0 +1,255 @@
+#pragma once
+
+#include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/bitmapcalendar.h"
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Date/yearfraction.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/utils/threadpool.h"
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+#include <ql/time/daycounter.hpp>
+#include <ql/utilities/dataparsers.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Column versions of the qf* functions in apis/date.h
+// Each call resolves its conventions once (through the ConventionRegistry, using the precomputed BitmapCalendar for
+// the holiday convention), then runs a tight loop over the rows writing into buffers owned by the caller. Dates go in
+// and come out as QuantLib serial numbers, or come in as 'DD-MM-YYYY' string_views which are parsed block by block
+// into a small stack buffer. Nothing in the row loop allocates. The bitmap is looked up again on every call, and
+// qfAddHoliday / qfRemoveHoliday rebuild it in the registry, so the next call agrees with the single-date functions.
+//
+// With no pool the rows run on the calling thread; with one they are split into contiguous chunks run on the pool's
+// workers, so repeated calls reuse its threads instead of starting new ones. Small batches always run inline. Not to
+// be called with a pool from one of that pool's own workers (ThreadPool::parallel_for throws std::logic_error).
+
+namespace fixedincomelib {
+    namespace batch_detail {
+        // Rows parsed per block in the string overloads, small enough for the stack and L1
+        inline constexpr std::size_t parse_block = 256;
+
+        // Below this many rows a chunk isn't worth handing to another thread
+        inline constexpr std::size_t min_rows_per_chunk = 16384;
+
+        // Calls body(begin, end) over [0, n), one chunk per pool worker, or inline when a split wouldn't pay
+        template <class Body>
+        void for_chunks(std::size_t n, ThreadPool* pool, Body&& body) {
+            if (pool == nullptr || pool->size() == 1 || n < 2 * min_rows_per_chunk) {
+                body(std::size_t(0), n);
+                return;
+            }
+            const std::size_t chunk = std::max(min_rows_per_chunk, (n + pool->size() - 1) / pool->size());
+            pool->parallel_for(n, chunk, [&](std::size_t begin, std::size_t end, unsigned) { body(begin, end); });
+        }
+
+        // Input columns are either serials or 'DD-MM-YYYY' strings, anything convertible to a span of those works
+        // (vectors, arrays, spans)
+        inline std::span<const serial_type> column(std::span<const serial_type> dates) { return dates; }
+        inline std::span<const std::string_view> column(std::span<const std::string_view> dates) { return dates; }
+
+        inline void require_output(std::size_t in, std::size_t out, const char* fn) {
+            if (out < in)
+                throw std::invalid_argument(std::string(fn) + ": output buffer is smaller than the input");
+        }
+
+        inline void parse_or_throw(std::span<const std::string_view> in, std::span<serial_type> out,
+                                   std::size_t offset, const char* fn) {
+            if (parse_date_column(in, out) == 0) return;
+            // Slow path only on error: find the first bad row so the message is useful
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                if (out[i] == 0)
+                    throw std::invalid_argument(std::string(fn) + ": invalid date '" + std::string(in[i]) +
+                                                "' at row " + std::to_string(offset + i) +
+                                                ", expected dd-mm-YYYY");
+            }
+        }
+
+        // Runs kernel(in_rows, out_rows) over the rows, in parallel chunks
+        template <class Out, class Kernel>
+        void run(std::span<const serial_type> in, std::span<Out> out, ThreadPool* pool, const char* fn,
+                 Kernel&& kernel) {
+            require_output(in.size(), out.size(), fn);
+            for_chunks(in.size(), pool, [&](std::size_t begin, std::size_t end) {
+                kernel(in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+            });
+        }
+
+        // Same for string input, each chunk parses parse_block rows at a time into a stack buffer
+        template <class Out, class Kernel>
+        void run(std::span<const std::string_view> in, std::span<Out> out, ThreadPool* pool, const char* fn,
+                 Kernel&& kernel) {
+            require_output(in.size(), out.size(), fn);
+            for_chunks(in.size(), pool, [&](std::size_t begin, std::size_t end) {
+                serial_type buf[parse_block];
+                for (std::size_t i = begin; i < end; i += parse_block) {
+                    const std::size_t n = std::min(parse_block, end - i);
+                    parse_or_throw(in.subspan(i, n), std::span<serial_type>(buf, n), i, fn);
+                    kernel(std::span<const serial_type>(buf, n), out.subspan(i, n));
+                }
+            });
+        }
+
+        // Two input columns (start/end dates)
+        template <class Out, class Kernel>
+        void run(std::span<const serial_type> a, std::span<const serial_type> b, std::span<Out> out,
+                 ThreadPool* pool, const char* fn, Kernel&& kernel) {
+            if (a.size() != b.size())
+                throw std::invalid_argument(std::string(fn) + ": input columns differ in length");
+            require_output(a.size(), out.size(), fn);
+            for_chunks(a.size(), pool, [&](std::size_t begin, std::size_t end) {
+                kernel(a.subspan(begin, end - begin), b.subspan(begin, end - begin), out.subspan(begin, end - begin));
+            });
+        }
+
+        template <class Out, class Kernel>
+        void run(std::span<const std::string_view> a, std::span<const std::string_view> b, std::span<Out> out,
+                 ThreadPool* pool, const char* fn, Kernel&& kernel) {
+            if (a.size() != b.size())
+                throw std::invalid_argument(std::string(fn) + ": input columns differ in length");
+            require_output(a.size(), out.size(), fn);
+            for_chunks(a.size(), pool, [&](std::size_t begin, std::size_t end) {
+                serial_type buf_a[parse_block], buf_b[parse_block];
+                for (std::size_t i = begin; i < end; i += parse_block) {
+                    const std::size_t n = std::min(parse_block, end - i);
+                    parse_or_throw(a.subspan(i, n), std::span<serial_type>(buf_a, n), i, fn);
+                    parse_or_throw(b.subspan(i, n), std::span<serial_type>(buf_b, n), i, fn);
+                    kernel(std::span<const serial_type>(buf_a, n), std::span<const serial_type>(buf_b, n),
+                           out.subspan(i, n));
+                }
+            });
+        }
+    }
+
+    // qfAddPeriodBatch(start_dates, term, hol, bdc, eom) -> end date serials
+    template <class Dates>
+    void qfAddPeriodBatch(const Dates& start_dates,
+                          std::string_view term,
+                          std::string_view holiday_convention,
+                          std::string_view business_day_convention,
+                          bool end_of_month,
+                          std::span<serial_type> out,
+                          ThreadPool* pool = nullptr) {
+        const QuantLib::Period period = QuantLib::PeriodParser::parse(std::string(term));
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+        const QuantLib::BusinessDayConvention bdc = conventions().bdc(business_day_convention);
+
+        batch_detail::run(batch_detail::column(start_dates), out, pool, "qfAddPeriodBatch",
+            [&](std::span<const serial_type> in, std::span<serial_type> res) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    res[i] = cal.advance(QuantLib::Date(in[i]), period, bdc, end_of_month).serialNumber();
+            });
+    }
+
+    // qfAccruedBatch(start_dates, end_dates, dc, bdc, hol) -> year fractions
+    template <class Dates>
+    void qfAccruedBatch(const Dates& start_dates,
+                        const Dates& end_dates,
+                        std::string_view accrual_basis,
+                        std::string_view business_day_convention,
+                        std::string_view holiday_convention,
+                        std::span<double> out,
+                        ThreadPool* pool = nullptr) {
+        const QuantLib::DayCounter& dc = conventions().day_counter(accrual_basis);
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+        const QuantLib::BusinessDayConvention bdc = conventions().bdc(business_day_convention);
+        const YearFractionKernel kernel = year_fraction_kernel(dc);
+
+        // End dates are adjusted a block at a time, then the year fractions run as one column kernel per block
+        batch_detail::run(batch_detail::column(start_dates), batch_detail::column(end_dates), out, pool,
+                          "qfAccruedBatch",
+            [&](std::span<const serial_type> s, std::span<const serial_type> e, std::span<double> res) {
+                serial_type adjusted[batch_detail::parse_block];
+                for (std::size_t b = 0; b < s.size(); b += batch_detail::parse_block) {
+                    const std::size_t n = std::min(batch_detail::parse_block, s.size() - b);
+                    for (std::size_t i = 0; i < n; ++i)
+                        adjusted[i] = cal.adjust(QuantLib::Date(e[b + i]), bdc).serialNumber();
+                    year_fractions(kernel, dc, s.subspan(b, n), std::span<const serial_type>(adjusted, n),
+                                   res.subspan(b, n));
+                }
+            });
+    }
+
+    // qfMoveToBusinessDayBatch(dates, bdc, hol) -> adjusted date serials
+    template <class Dates>
+    void qfMoveToBusinessDayBatch(const Dates& input_dates,
+                                  std::string_view business_day_convention,
+                                  std::string_view holiday_convention,
+                                  std::span<serial_type> out,
+                                  ThreadPool* pool = nullptr) {
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+        const QuantLib::BusinessDayConvention bdc = conventions().bdc(business_day_convention);
+
+        batch_detail::run(batch_detail::column(input_dates), out, pool, "qfMoveToBusinessDayBatch",
+            [&](std::span<const serial_type> in, std::span<serial_type> res) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    res[i] = cal.adjust(QuantLib::Date(in[i]), bdc).serialNumber();
+            });
+    }
+
+    // qfIsBusinessDayBatch(dates, hol) -> 1/0 flags (uint8_t rather than bool so the buffer is plain bytes)
+    template <class Dates>
+    void qfIsBusinessDayBatch(const Dates& input_dates,
+                              std::string_view holiday_convention,
+                              std::span<std::uint8_t> out,
+                              ThreadPool* pool = nullptr) {
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+
+        batch_detail::run(batch_detail::column(input_dates), out, pool, "qfIsBusinessDayBatch",
+            [&](std::span<const serial_type> in, std::span<std::uint8_t> res) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    res[i] = cal.is_business_day(QuantLib::Date(in[i]));
+            });
+    }
+
+    // qfIsHolidayBatch(dates, hol) -> 1/0 flags
+    template <class Dates>
+    void qfIsHolidayBatch(const Dates& input_dates,
+                          std::string_view holiday_convention,
+                          std::span<std::uint8_t> out,
+                          ThreadPool* pool = nullptr) {
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+
+        batch_detail::run(batch_detail::column(input_dates), out, pool, "qfIsHolidayBatch",
+            [&](std::span<const serial_type> in, std::span<std::uint8_t> res) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    res[i] = cal.is_holiday(QuantLib::Date(in[i]));
+            });
+    }
+
+    // qfIsEndOfMonthBatch(dates, hol) -> 1/0 flags
+    template <class Dates>
+    void qfIsEndOfMonthBatch(const Dates& input_dates,
+                             std::string_view holiday_convention,
+                             std::span<std::uint8_t> out,
+                             ThreadPool* pool = nullptr) {
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+
+        batch_detail::run(batch_detail::column(input_dates), out, pool, "qfIsEndOfMonthBatch",
+            [&](std::span<const serial_type> in, std::span<std::uint8_t> res) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    res[i] = cal.is_end_of_month(QuantLib::Date(in[i]));
+            });
+    }
+
+    // qfEndOfMonthBatch(dates, hol) -> last business day of each date's month, as serials
+    template <class Dates>
+    void qfEndOfMonthBatch(const Dates& input_dates,
+                           std::string_view holiday_convention,
+                           std::span<serial_type> out,
+                           ThreadPool* pool = nullptr) {
+        const BitmapCalendar& cal = conventions().bitmap_calendar(holiday_convention);
+
+        batch_detail::run(batch_detail::column(input_dates), out, pool, "qfEndOfMonthBatch",
+            [&](std::span<const serial_type> in, std::span<serial_type> res) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    res[i] = cal.end_of_month(QuantLib::Date(in[i])).serialNumber();
+            });
+    }
+}
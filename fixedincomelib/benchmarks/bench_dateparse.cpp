@@ -0,0 +1,94 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/serial.h"
+
+// Compares the old regex + std::stoi date parser with the hand-written scanner and the bulk column parser
+
+namespace {
+    using namespace fixedincomelib;
+
+    // The parser as it was before the scanner, kept here verbatim so we can keep measuring against it
+    QuantLib::Date regex_date_from_iso(std::string_view iso) {
+        static const std::regex re(R"(^(0[1-9]|[12]\d|3[01])-(0[1-9]|1[0-2])-(\d{4})$)");
+        if (!std::regex_match(std::string(iso), re))
+            throw std::invalid_argument("Expected date format dd-mm-YYYY");
+
+        int d = std::stoi(std::string(iso.substr(0,2)));
+        int m = std::stoi(std::string(iso.substr(3,2)));
+        int y = std::stoi(std::string(iso.substr(6,4)));
+        if (d > days_in_month(y, m))
+            throw std::invalid_argument("Invalid calendar date (day exceeds month length)");
+
+        return QuantLib::Date(d, QuantLib::Month(m), y);
+    }
+
+    template <class F>
+    double time_ns_per_item(std::size_t n, F&& f) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(n);
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    // Random valid dates, stored both as separate strings and as one newline separated buffer
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> year(1950, 2150), month(1, 12), day(1, 31);
+    std::vector<std::string> dates;
+    std::string column;
+    dates.reserve(n);
+    column.reserve(n * 11);
+    char buf[11];
+    for (std::size_t i = 0; i < n; ++i) {
+        int y = year(rng), m = month(rng);
+        int d = std::min(day(rng), days_in_month(y, m));
+        std::snprintf(buf, sizeof(buf), "%02d-%02d-%04d", d, m, y);
+        dates.emplace_back(buf, 10);
+        column.append(buf, 10);
+        column.push_back('\n');
+    }
+    std::vector<std::string_view> views(dates.begin(), dates.end());
+    std::vector<QuantLib::Date::serial_type> serials(n);
+
+    // Checksums keep the optimiser from dropping the loops
+    long long check_regex = 0, check_scan = 0, check_views = 0, check_column = 0;
+
+    double regex_ns = time_ns_per_item(n, [&] {
+        for (const auto& s : dates) check_regex += regex_date_from_iso(s).serialNumber();
+    });
+    double scan_ns = time_ns_per_item(n, [&] {
+        for (const auto& s : views) check_scan += Date(s).get_date().serialNumber();
+    });
+    double views_ns = time_ns_per_item(n, [&] {
+        parse_date_column(views, serials);
+        for (auto v : serials) check_views += v;
+    });
+    double column_ns = time_ns_per_item(n, [&] {
+        parse_date_column(column.data(), n, 11, serials);
+        for (auto v : serials) check_column += v;
+    });
+
+    if (check_regex != check_scan || check_scan != check_views || check_views != check_column) {
+        std::cerr << "ERROR: parsers disagree\n";
+        return 1;
+    }
+
+    std::cout << "=== Date parsing, " << n << " dates ===\n" << std::fixed << std::setprecision(2);
+    std::cout << "regex + stoi        : " << std::setw(8) << regex_ns  << " ns/date\n";
+    std::cout << "Date(string_view)   : " << std::setw(8) << scan_ns   << " ns/date  (x" << regex_ns / scan_ns   << ")\n";
+    std::cout << "column (views)      : " << std::setw(8) << views_ns  << " ns/date  (x" << regex_ns / views_ns  << ")\n";
+    std::cout << "column (fixed width): " << std::setw(8) << column_ns << " ns/date  (x" << regex_ns / column_ns << ")\n";
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/Date/serial.h"
+
+// Trades/sec of ScheduleEngine::generate against thread count, on a synthetic book of vanilla swaps
+
+namespace {
+    using namespace fixedincomelib;
+
+    std::vector<ScheduleSpec> make_book(std::size_t n) {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> start_offset(0, 3650), years(1, 30), pick(0, 3);
+        const char* calendars[] = {"USGS", "LON", "TARGET", "NYC+LON"};
+        const char* bases[] = {"ACT/360", "ACT/365", "30/360", "ACT/ACT"};
+        const QuantLib::Period tenors[] = {
+            QuantLib::Period(1, QuantLib::Months), QuantLib::Period(3, QuantLib::Months),
+            QuantLib::Period(6, QuantLib::Months), QuantLib::Period(1, QuantLib::Years)
+        };
+
+        std::vector<ScheduleSpec> book(n);
+        for (auto& spec : book) {
+            const QuantLib::Date start(serial_from_ymd(2020, 1, 1) + start_offset(rng));
+            spec.start_date = Date(start);
+            spec.end_date = Date(start + QuantLib::Period(years(rng), QuantLib::Years));
+            spec.accrual_period = tenors[pick(rng)];
+            spec.holiday_convention = calendars[pick(rng)];
+            spec.business_day_convention = "MF";
+            spec.accrual_basis = bases[pick(rng)];
+            spec.fix_in_arrear = pick(rng) == 0;
+            spec.fixing_offset = QuantLib::Period(-2, QuantLib::Days);
+            spec.payment_offset = QuantLib::Period(2, QuantLib::Days);
+            spec.payment_holiday_convention = spec.holiday_convention;
+        }
+        return book;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<ScheduleSpec> book = make_book(n);
+
+    // Warm the registry so the first timing doesn't include building the bitmap calendars
+    ScheduleEngine(1).generate(std::vector<ScheduleSpec>(book.begin(), book.begin() + std::min<std::size_t>(n, 1000)));
+
+    std::cout << "=== ScheduleEngine, " << n << " trades ===\n";
+    std::cout << "threads   trades/sec     speedup   efficiency\n";
+
+    // Powers of two, finishing on the hardware thread count
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < hw; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(hw);
+
+    std::vector<std::vector<ScheduleRow>> reference;
+    double single = 0.0;
+    for (unsigned threads : thread_counts) {
+        ScheduleEngine engine(threads);
+        auto t0 = std::chrono::steady_clock::now();
+        auto schedules = engine.generate(book);
+        auto t1 = std::chrono::steady_clock::now();
+        const double rate = static_cast<double>(n) / std::chrono::duration<double>(t1 - t0).count();
+
+        // Output must not depend on the thread count
+        if (reference.empty()) {
+            reference = std::move(schedules);
+            single = rate;
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (schedules[i].size() != reference[i].size() ||
+                    (!schedules[i].empty() && schedules[i].back().paymentDate != reference[i].back().paymentDate)) {
+                    std::cerr << "ERROR: trade " << i << " differs with " << threads << " threads\n";
+                    return 1;
+                }
+            }
+        }
+
+        std::cout << std::setw(7) << threads << std::fixed << std::setprecision(0) << std::setw(13) << rate
+                  << std::setprecision(2) << std::setw(12) << rate / single
+                  << std::setw(12) << rate / single / threads << "\n";
+    }
+
+    // End-of-day books repeat the same terms many times, model that with every distinct spec appearing 20 times
+    std::vector<ScheduleSpec> repeated;
+    repeated.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        repeated.push_back(book[i % std::max<std::size_t>(1, n / 20)]);
+
+    std::cout << "\n=== Memo cache, " << n << " trades, 1 in 20 distinct, " << hw << " threads ===\n";
+    double uncached_rate = 0.0;
+    for (bool cached : {false, true}) {
+        ScheduleCache cache(n);
+        ScheduleEngine engine(hw, cached ? &cache : nullptr);
+        auto t0 = std::chrono::steady_clock::now();
+        auto schedules = engine.generate(repeated);
+        auto t1 = std::chrono::steady_clock::now();
+        const double rate = static_cast<double>(n) / std::chrono::duration<double>(t1 - t0).count();
+        if (!cached) uncached_rate = rate;
+
+        std::cout << (cached ? "cached  " : "uncached") << std::fixed << std::setprecision(0) << std::setw(13) << rate
+                  << " trades/sec";
+        if (cached) {
+            const ScheduleCache::Stats st = cache.stats();
+            std::cout << std::setprecision(2) << "  (x" << rate / uncached_rate << ", hits=" << st.hits
+                      << " misses=" << st.misses << ")";
+        }
+        std::cout << "\n";
+    }
+
+    // Footprint of the same book as per-trade vectors of rows against the columnar ScheduleTable
+    ScheduleTable table = ScheduleEngine(hw).generate_table(book);
+    std::size_t aos_bytes = reference.size() * sizeof(std::vector<ScheduleRow>);
+    for (const auto& rows : reference)
+        aos_bytes += rows.capacity() * sizeof(ScheduleRow);
+    std::cout << "\n=== Footprint, " << table.row_count() << " rows ===\n" << std::setprecision(1)
+              << "vector<ScheduleRow> per trade: " << aos_bytes / 1048576.0 << " MB\n"
+              << "ScheduleTable                : " << table.memory_bytes() / 1048576.0 << " MB  (x"
+              << std::setprecision(2) << static_cast<double>(aos_bytes) / table.memory_bytes() << " smaller)\n";
+    return 0;
+}
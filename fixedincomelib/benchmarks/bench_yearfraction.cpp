@@ -0,0 +1,65 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Date/yearfraction.h"
+#include "fixedincomelib/market/basics.h"
+
+// Year fractions over a column of periods: one virtual DayCounter::yearFraction per row against the column kernels
+
+namespace {
+    using namespace fixedincomelib;
+
+    template <class F>
+    double time_ns_per_item(std::size_t n, F&& f) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(n);
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    // Coupon-like periods: start anywhere in 1950-2150, length up to a year either way
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> start(serial_from_ymd(1950, 1, 1), serial_from_ymd(2150, 1, 1));
+    std::uniform_int_distribution<int> length(-366, 366);
+    std::vector<serial_type> starts(n), ends(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        starts[i] = start(rng);
+        ends[i] = starts[i] + length(rng);
+    }
+    std::vector<double> scalar(n), column(n);
+
+    std::cout << "=== Year fractions, " << n << " periods (AVX2 kernels: "
+              << (year_fractions_use_avx2() ? "yes" : "no") << ") ===\n" << std::fixed << std::setprecision(2);
+    std::cout << "basis       yearFraction      kernel    speedup\n";
+
+    for (const char* basis : {"ACT/360", "ACT/365", "30/360", "ACT/ACT"}) {
+        const QuantLib::DayCounter dc = accrualbasis_from_string(basis);
+
+        double scalar_ns = time_ns_per_item(n, [&] {
+            for (std::size_t i = 0; i < n; ++i)
+                scalar[i] = dc.yearFraction(QuantLib::Date(starts[i]), QuantLib::Date(ends[i]));
+        });
+        double column_ns = time_ns_per_item(n, [&] {
+            year_fractions(dc, starts, ends, column);
+        });
+
+        if (scalar != column) {
+            std::cerr << "ERROR: " << basis << " kernel differs from QuantLib\n";
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(10) << basis << std::right
+                  << std::setw(10) << scalar_ns << " ns" << std::setw(9) << column_ns << " ns"
+                  << std::setw(10) << scalar_ns / column_ns << "x\n";
+    }
+    return 0;
+}
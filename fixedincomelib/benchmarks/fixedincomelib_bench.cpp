@@ -0,0 +1,805 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "fixedincomelib/benchmarks/harness.h"
+#include "fixedincomelib/apis/date.h"
+#include "fixedincomelib/apis/datebatch.h"
+#include "fixedincomelib/Date/basics.h"
+#include "fixedincomelib/Date/schedulebook.h"
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/Date/schedulefile.h"
+#include "fixedincomelib/Date/schedulewriter.h"
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/Model/bootstrap.h"
+#include "fixedincomelib/Model/curvesensitivity.h"
+#include "fixedincomelib/Model/overnightcompounding.h"
+#include "fixedincomelib/Model/sabr.h"
+#include "fixedincomelib/Model/sabrcalibration.h"
+#include "fixedincomelib/Model/scenarioengine.h"
+#include "fixedincomelib/Model/swappricer.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+#include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/market/fixingstore.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/utils/instrumentation.h"
+#include "fixedincomelib/utils/threadpool.h"
+
+// Microbenchmarks for every date/market API, meant to track the library's cost against our latency budget
+//
+//   fixedincomelib_bench                              run everything, print a table
+//   fixedincomelib_bench --json=results.jsonl         also write the results as JSON lines
+//   fixedincomelib_bench --baseline=baseline.jsonl    compare with a stored run, exit 1 on regressions
+//   fixedincomelib_bench --filter=make_schedule       only cases whose name contains the filter
+
+namespace {
+    using namespace fixedincomelib;
+    using bench::do_not_optimize;
+
+    void add_parsing(bench::Suite& suite) {
+        suite.add("parse/Date(string_view)", [] {
+            Date d(std::string_view("25-05-2025"));
+            do_not_optimize(d);
+        });
+        suite.add("parse/TermOrTerminationDate(date)", [] {
+            TermOrTerminationDate t(std::string_view("25-05-2025"));
+            do_not_optimize(t);
+        });
+        suite.add("parse/TermOrTerminationDate(tenor)", [] {
+            TermOrTerminationDate t(std::string_view("3M"));
+            do_not_optimize(t);
+        });
+
+        static std::vector<std::string_view> column(1024, "25-05-2025");
+        static std::vector<serial_type> serials(column.size());
+        suite.add("parse/parse_date_column x1024", [] {
+            parse_date_column(column, serials);
+            do_not_optimize(serials.front());
+        }, column.size());
+
+        suite.add("format/Date::get_date_str", [] {
+            std::string s = Date(QuantLib::Date(45802)).get_date_str();
+            do_not_optimize(s);
+        });
+    }
+
+    void add_conventions(bench::Suite& suite) {
+        suite.add("conventions/calendar_from_string(USGS)", [] {
+            QuantLib::Calendar c = calendar_from_string("USGS");
+            do_not_optimize(c);
+        });
+        suite.add("conventions/accrualbasis_from_string(ACT/360)", [] {
+            QuantLib::DayCounter dc = accrualbasis_from_string("ACT/360");
+            do_not_optimize(dc);
+        });
+        suite.add("conventions/bdc_from_string(MF)", [] {
+            QuantLib::BusinessDayConvention c = bdc_from_string("MF");
+            do_not_optimize(c);
+        });
+        suite.add("conventions/currency_from_string(USD)", [] {
+            QuantLib::Currency c = currency_from_string("USD");
+            do_not_optimize(c);
+        });
+        suite.add("conventions/get_currency_code", [] {
+            static const QuantLib::Currency usd = currency_from_string("USD");
+            std::string code = get_currency_code(usd);
+            do_not_optimize(code);
+        });
+        // What every trade pays to resolve its conventions: holiday calendar, business day convention, accrual basis
+        suite.add("conventions/id triple(usgs, mf, act/360)", [] {
+            auto cal = calendar_id("usgs");
+            auto bdc = bdc_id("mf");
+            auto dc = accrualbasis_id("act/360");
+            do_not_optimize(cal);
+            do_not_optimize(bdc);
+            do_not_optimize(dc);
+        });
+        suite.add("conventions/registry.calendar(USGS)", [] {
+            const QuantLib::Calendar& c = conventions().calendar("USGS");
+            do_not_optimize(c);
+        });
+        suite.add("conventions/registry.calendar(NYC+LON)", [] {
+            const QuantLib::Calendar& c = conventions().calendar("NYC+LON");
+            do_not_optimize(c);
+        });
+        suite.add("conventions/registry.day_counter(ACT/ACT)", [] {
+            const QuantLib::DayCounter& dc = conventions().day_counter("ACT/ACT");
+            do_not_optimize(dc);
+        });
+        suite.add("conventions/registry.bitmap_calendar(TARGET)", [] {
+            const BitmapCalendar& c = conventions().bitmap_calendar("TARGET");
+            do_not_optimize(c);
+        });
+    }
+
+    void add_qf(bench::Suite& suite) {
+        suite.add("qf/qfAddPeriod", [] {
+            std::string r = qfAddPeriod("25-05-2025", "3M", "USGS", "MF");
+            do_not_optimize(r);
+        });
+        suite.add("qf/qfAccrued", [] {
+            double r = qfAccrued("25-05-2025", "25-08-2025", "ACT/ACT", "MF", "USGS");
+            do_not_optimize(r);
+        });
+        suite.add("qf/qfMoveToBusinessDay", [] {
+            std::string r = qfMoveToBusinessDay("21-12-2025", "F", "USGS");
+            do_not_optimize(r);
+        });
+        suite.add("qf/qfIsBusinessDay", [] {
+            bool r = qfIsBusinessDay("21-12-2025", "USGS");
+            do_not_optimize(r);
+        });
+        suite.add("qf/qfIsHoliday", [] {
+            bool r = qfIsHoliday("01-01-2026", "USGS");
+            do_not_optimize(r);
+        });
+        suite.add("qf/qfIsEndOfMonth", [] {
+            bool r = qfIsEndOfMonth("31-12-2025", "USGS");
+            do_not_optimize(r);
+        });
+        suite.add("qf/qfEndOfMonth", [] {
+            std::string r = qfEndOfMonth("01-01-2025", "USGS");
+            do_not_optimize(r);
+        });
+        // Same terms every call, so after the first call this is the memo cache plus formatting
+        suite.add("qf/qfMakeSchedule(10Y 3M, cached)", [] {
+            std::string r = qfMakeSchedule("25-05-2025", "25-05-2035", "3M", "USGS", "MF", "ACT/360", "BACKWARD",
+                                           false, true, "-2D", "2D", "F", "USGS");
+            do_not_optimize(r);
+        });
+    }
+
+    void add_make_schedule(bench::Suite& suite) {
+        const Date start(std::string_view("25-05-2025"));
+        const Date end(std::string_view("25-05-2035"));
+        const QuantLib::DayCounter& dc = conventions().day_counter("ACT/360");
+
+        for (const char* tenor : {"1M", "3M", "6M", "1Y"}) {
+            for (const char* rule : {"BACKWARD", "FORWARD"}) {
+                for (const char* hol : {"USGS", "TARGET", "NYC+LON"}) {
+                    const QuantLib::Period period = QuantLib::PeriodParser::parse(tenor);
+                    const QuantLib::Calendar& cal = conventions().calendar(hol);
+                    const std::string name = std::string("make_schedule/10Y ") + tenor + " " + rule + " " + hol;
+                    suite.add(name, [=, &cal, &dc] {
+                        std::vector<ScheduleRow> rows = make_schedule(
+                            start, end, period, cal, QuantLib::ModifiedFollowing, dc, rule, false, false,
+                            QuantLib::Period(-2, QuantLib::Days), QuantLib::Period(2, QuantLib::Days),
+                            QuantLib::Following, cal);
+                        do_not_optimize(rows);
+                    });
+                }
+            }
+        }
+
+        // Whole books through the ScheduleEngine on one thread, cost per trade
+        for (std::size_t n : {1, 64, 4096}) {
+            std::vector<ScheduleSpec> book(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const QuantLib::Date s(serial_from_ymd(2025, 1, 1) + static_cast<serial_type>(i % 365));
+                book[i].start_date = Date(s);
+                book[i].end_date = Date(s + QuantLib::Period(5, QuantLib::Years));
+                book[i].accrual_period = QuantLib::Period(3, QuantLib::Months);
+                book[i].holiday_convention = "USGS";
+                book[i].business_day_convention = "MF";
+                book[i].accrual_basis = "ACT/360";
+            }
+            auto engine = std::make_shared<ScheduleEngine>(1);
+            suite.add("make_schedule/ScheduleEngine batch=" + std::to_string(n), [engine, book] {
+                auto schedules = engine->generate(book);
+                do_not_optimize(schedules);
+            }, n);
+        }
+    }
+
+    void add_batch(bench::Suite& suite) {
+        for (std::size_t n : {16, 1024, 65536}) {
+            auto dates = std::make_shared<std::vector<serial_type>>(n);
+            auto out = std::make_shared<std::vector<serial_type>>(n);
+            auto yf = std::make_shared<std::vector<double>>(n);
+            for (std::size_t i = 0; i < n; ++i)
+                (*dates)[i] = serial_from_ymd(2025, 1, 1) + static_cast<serial_type>(i % 3650);
+
+            const std::string suffix = " x" + std::to_string(n);
+            suite.add("batch/qfAddPeriodBatch" + suffix, [=] {
+                qfAddPeriodBatch(*dates, "3M", "USGS", "MF", false, *out);
+                do_not_optimize(out->front());
+            }, n);
+            suite.add("batch/qfMoveToBusinessDayBatch" + suffix, [=] {
+                qfMoveToBusinessDayBatch(*dates, "F", "USGS", *out);
+                do_not_optimize(out->front());
+            }, n);
+            suite.add("batch/qfAccruedBatch" + suffix, [=] {
+                qfAccruedBatch(*dates, *out, "ACT/ACT", "MF", "USGS", *yf);
+                do_not_optimize(yf->front());
+            }, n);
+        }
+
+        // The largest batch again on a pool with every hardware thread, the pool kept across calls
+        const std::size_t n = 65536;
+        auto pool = std::make_shared<ThreadPool>();
+        auto dates = std::make_shared<std::vector<serial_type>>(n);
+        auto out = std::make_shared<std::vector<serial_type>>(n);
+        auto yf = std::make_shared<std::vector<double>>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            (*dates)[i] = serial_from_ymd(2025, 1, 1) + static_cast<serial_type>(i % 3650);
+        suite.add("batch/qfAccruedBatch x65536 pool of " + std::to_string(pool->size()), [=] {
+            qfAccruedBatch(*dates, *out, "ACT/ACT", "MF", "USGS", *yf, pool.get());
+            do_not_optimize(yf->front());
+        }, n);
+    }
+
+    void add_curve(bench::Suite& suite) {
+        // 30 pillars out to 30Y, queried at a 10Y quarterly leg's payment dates and at random dates
+        const QuantLib::Date reference(15, QuantLib::January, 2025);
+        std::vector<serial_type> pillars;
+        std::vector<double> dfs;
+        for (int m : {1, 2, 3, 6, 9, 12, 18, 24, 36, 48, 60, 72, 84, 96, 108, 120, 144, 180, 240, 300, 360}) {
+            const QuantLib::Date d = reference + QuantLib::Period(m, QuantLib::Months);
+            pillars.push_back(d.serialNumber());
+            dfs.push_back(std::exp(-(0.04 + 0.0001 * m / 12.0) * (d - reference) / 365.0));
+        }
+
+        for (CurveInterpolation interpolation : {CurveInterpolation::LogLinearDiscount,
+                                                 CurveInterpolation::MonotoneConvex}) {
+            auto curve = std::make_shared<YieldCurve>(reference, pillars, dfs, interpolation,
+                                                      conventions().day_counter("ACT/360"));
+            const std::string prefix = interpolation == CurveInterpolation::MonotoneConvex ? "curve/monotone convex "
+                                                                                           : "curve/log-linear ";
+
+            suite.add(prefix + "discount", [curve] {
+                do_not_optimize(curve->discount(serial_from_ymd(2031, 7, 3)));
+            });
+
+            auto leg = std::make_shared<std::vector<ScheduleRow>>(make_schedule(
+                Date(std::string_view("20-03-2025")), Date(std::string_view("20-03-2035")),
+                QuantLib::Period(3, QuantLib::Months), conventions().calendar("USGS"), QuantLib::ModifiedFollowing,
+                conventions().day_counter("ACT/360")));
+            auto leg_dfs = std::make_shared<std::vector<double>>(leg->size());
+            suite.add(prefix + "discount_payments(10Y 3M leg)", [curve, leg, leg_dfs] {
+                curve->discount_payments(*leg, *leg_dfs);
+                do_not_optimize(leg_dfs->front());
+            }, leg->size());
+
+            for (bool sorted : {true, false}) {
+                const std::size_t n = 4096;
+                auto dates = std::make_shared<std::vector<serial_type>>(n);
+                for (std::size_t i = 0; i < n; ++i)
+                    (*dates)[i] = reference.serialNumber() + static_cast<serial_type>(i * 10950 / n);
+                if (!sorted) std::shuffle(dates->begin(), dates->end(), std::mt19937(7));
+                auto out = std::make_shared<std::vector<double>>(n);
+                suite.add(prefix + "discount batch x4096" + (sorted ? " sorted" : " shuffled"), [curve, dates, out] {
+                    curve->discount(*dates, *out);
+                    do_not_optimize(out->front());
+                }, n);
+            }
+        }
+
+        // Bootstrapping 3 deposits and 12 swaps to 30Y: from scratch, and per tick of one quote then curve()
+        std::vector<CurveInstrument> instruments;
+        for (int m : {1, 3, 6}) {
+            CurveInstrument d;
+            d.kind = CurveInstrument::Kind::Deposit;
+            d.tenor = QuantLib::Period(m, QuantLib::Months);
+            d.quote = 0.043;
+            instruments.push_back(d);
+        }
+        for (int y : {1, 2, 3, 4, 5, 6, 7, 8, 10, 15, 20, 30}) {
+            CurveInstrument sw;
+            sw.tenor = QuantLib::Period(y, QuantLib::Years);
+            sw.quote = 0.04 + 0.0001 * y;
+            instruments.push_back(sw);
+        }
+        suite.add("curve/bootstrap 15 instruments", [=] {
+            CurveBootstrapper bootstrapper(reference, instruments);
+            do_not_optimize(bootstrapper.curve().discount(serial_from_ymd(2040, 1, 1)));
+        });
+        for (std::size_t ticked : {std::size_t{1}, std::size_t{8}, instruments.size() - 1}) {
+            auto bootstrapper = std::make_shared<CurveBootstrapper>(reference, instruments);
+            bootstrapper->curve();
+            auto bump = std::make_shared<int>(0);
+            const double base = instruments[ticked].quote;
+            suite.add("curve/bootstrap tick " + std::to_string(ticked) + " of 15", [=] {
+                *bump = (*bump + 1) % 3;
+                bootstrapper->set_quote(ticked, base + 0.0001 * *bump);
+                do_not_optimize(bootstrapper->curve().discount(serial_from_ymd(2040, 1, 1)));
+            });
+        }
+    }
+
+    void add_dv01(bench::Suite& suite) {
+        // Bucketed DV01 of 200 fixed legs (2Y to 30Y, quarterly to annual) on a 40-pillar curve: one adjoint pass
+        // against a revaluation per pillar
+        const QuantLib::Date reference(15, QuantLib::January, 2025);
+        std::vector<serial_type> pillars;
+        std::vector<double> dfs;
+        for (int i = 1; i <= 40; ++i) {
+            const int months = i <= 12 ? 3 * i : 36 + 9 * (i - 12);
+            const QuantLib::Date d = reference + QuantLib::Period(months, QuantLib::Months);
+            pillars.push_back(d.serialNumber());
+            dfs.push_back(std::exp(-(0.04 + 0.0002 * i) * (d - reference) / 365.0));
+        }
+
+        auto schedules = std::make_shared<std::vector<std::vector<ScheduleRow>>>();
+        for (int i = 0; i < 200; ++i) {
+            const int years = 2 + i % 29, months = i % 3 == 0 ? 3 : i % 3 == 1 ? 6 : 12;
+            schedules->push_back(make_schedule(Date(std::string_view("20-03-2025")),
+                                               Date(QuantLib::Date(20, QuantLib::March, 2025 + years)),
+                                               QuantLib::Period(months, QuantLib::Months),
+                                               conventions().calendar("USGS"), QuantLib::ModifiedFollowing,
+                                               conventions().day_counter("ACT/360")));
+        }
+        auto legs = std::make_shared<std::vector<DiscountedLeg>>();
+        for (std::size_t i = 0; i < schedules->size(); ++i)
+            legs->push_back(DiscountedLeg{(*schedules)[i], 1e6, 0.035 + 0.0001 * static_cast<double>(i % 20), true});
+
+        for (CurveInterpolation interpolation : {CurveInterpolation::LogLinearDiscount,
+                                                 CurveInterpolation::MonotoneConvex}) {
+            auto curve = std::make_shared<YieldCurve>(reference, pillars, dfs, interpolation);
+            const std::string prefix = interpolation == CurveInterpolation::MonotoneConvex
+                                           ? "dv01/monotone convex 40 pillars 200 legs "
+                                           : "dv01/log-linear 40 pillars 200 legs ";
+            // The legs only point at the schedules, so the cases hold on to both
+            suite.add(prefix + "pv", [curve, legs, schedules] { do_not_optimize(present_value(*curve, *legs)); });
+            auto tape = std::make_shared<aad::Tape>();
+            suite.add(prefix + "adjoint", [curve, legs, schedules, tape] {
+                do_not_optimize(adjoint_dv01(*curve, *legs, *tape).dv01.front());
+            });
+            suite.add(prefix + "bump and revalue", [curve, legs, schedules] {
+                do_not_optimize(bumped_dv01(*curve, *legs).dv01.front());
+            });
+        }
+    }
+
+    void add_swaps(bench::Suite& suite) {
+        // 2000 swaps, annual fixed against quarterly float, 1Y to 30Y, OIS discounting and 3M projection. One op is
+        // one cashflow, so ops/s is cashflows per second on one core.
+        const QuantLib::Date reference(15, QuantLib::January, 2025);
+        auto make = [&](double level) {
+            std::vector<serial_type> pillars;
+            std::vector<double> dfs;
+            for (int m : {1, 3, 6, 12, 24, 36, 60, 84, 120, 180, 240, 360, 480}) {
+                const QuantLib::Date d = reference + QuantLib::Period(m, QuantLib::Months);
+                pillars.push_back(d.serialNumber());
+                dfs.push_back(std::exp(-(level + 0.0001 * m / 12.0) * (d - reference) / 365.0));
+            }
+            return std::make_shared<YieldCurve>(reference, pillars, dfs, CurveInterpolation::MonotoneConvex);
+        };
+        auto ois = make(0.040), projection = make(0.043);
+
+        auto schedules = std::make_shared<std::vector<std::vector<ScheduleRow>>>();
+        for (int years = 1; years <= 30; ++years)
+            for (int months : {12, 3})
+                schedules->push_back(make_schedule(Date(std::string_view("17-01-2025")),
+                                                   Date(QuantLib::Date(17, QuantLib::January, 2025 + years)),
+                                                   QuantLib::Period(months, QuantLib::Months),
+                                                   conventions().calendar("USGS"), QuantLib::ModifiedFollowing,
+                                                   conventions().day_counter("ACT/360")));
+
+        auto portfolio = std::make_shared<LegPortfolio>();
+        for (int i = 0; i < 2000; ++i) {
+            const std::size_t tenor = static_cast<std::size_t>(i % 30);
+            portfolio->add(SwapLeg{SwapLeg::Type::Fixed, (*schedules)[2 * tenor], 1e6, 0.04}, 0);
+            portfolio->add(SwapLeg{SwapLeg::Type::Float, (*schedules)[2 * tenor + 1], -1e6, 0.0}, 0, 1);
+        }
+        auto values = std::make_shared<std::vector<LegValue>>(portfolio->size());
+        suite.add("swaps/portfolio 2000 swaps", [=] {
+            const YieldCurve* curves[] = {ois.get(), projection.get()};
+            portfolio->price(curves, *values);
+            do_not_optimize(values->front());
+        }, portfolio->cashflow_count());
+
+        // One 10Y swap through price_swap, the rows read straight from the schedule
+        const SwapLeg fixed{SwapLeg::Type::Fixed, (*schedules)[18], 1e6, 0.04};
+        const SwapLeg floating{SwapLeg::Type::Float, (*schedules)[19], -1e6, 0.0};
+        suite.add("swaps/price_swap 10Y", [=, schedules = schedules] {
+            do_not_optimize(price_swap(fixed, floating, *ois, *projection).par_rate);
+        }, fixed.rows.size() + floating.rows.size());
+    }
+
+    void add_scenarios(bench::Suite& suite) {
+        // 1000 swaps (2000 legs) under 16 to 512 scenarios of two curves each, on 1 thread up to every hardware
+        // thread. One op is one cashflow under one scenario, so ops/s compares with swaps/portfolio.
+        const QuantLib::Date reference(15, QuantLib::January, 2025);
+        auto make = [&](double level, double slope) {
+            std::vector<serial_type> pillars;
+            std::vector<double> dfs;
+            for (int m : {1, 3, 6, 12, 24, 36, 60, 84, 120, 180, 240, 360, 480}) {
+                const QuantLib::Date d = reference + QuantLib::Period(m, QuantLib::Months);
+                pillars.push_back(d.serialNumber());
+                dfs.push_back(std::exp(-(level + slope * m / 12.0) * (d - reference) / 365.0));
+            }
+            return YieldCurve(reference, pillars, dfs, CurveInterpolation::MonotoneConvex);
+        };
+
+        // Trades start on any of the next 250 days, so the book's dates don't collapse onto a few schedules. The
+        // engine copies the cashflows in, the schedules aren't needed afterwards.
+        auto engine = std::make_shared<ScenarioEngine>();
+        for (std::size_t t = 0; t < 1000; ++t) {
+            const QuantLib::Date start = reference + static_cast<int>(2 + t % 250);
+            const Date end(start + QuantLib::Period(static_cast<int>(1 + t % 30), QuantLib::Years));
+            for (int months : {12, 3}) {
+                const std::vector<ScheduleRow> rows =
+                    make_schedule(Date(start), end, QuantLib::Period(months, QuantLib::Months),
+                                  conventions().calendar("USGS"), QuantLib::ModifiedFollowing,
+                                  conventions().day_counter("ACT/360"));
+                if (months == 12) engine->add(t, SwapLeg{SwapLeg::Type::Fixed, rows, 1e6, 0.04}, 0);
+                else engine->add(t, SwapLeg{SwapLeg::Type::Float, rows, -1e6, 0.0}, 0, 1);
+            }
+        }
+        const std::size_t cashflows = engine->legs().cashflow_count();
+
+        auto curves = std::make_shared<std::vector<YieldCurve>>();
+        for (int s = 0; s < 512; ++s) {
+            const double shift = 0.0001 * (s % 64 - 32), twist = 0.00001 * (s / 64 - 4);
+            curves->push_back(make(0.040 + shift, 0.0004 + twist));
+            curves->push_back(make(0.043 + shift, 0.0005 + twist));
+        }
+        auto sets = std::make_shared<std::vector<const YieldCurve*>>();
+        for (const YieldCurve& c : *curves) sets->push_back(&c);
+
+        // Scenario by scenario through the portfolio, the flow the engine replaces
+        auto values = std::make_shared<std::vector<LegValue>>(engine->legs().size());
+        suite.add("scenarios/128 scenarios one at a time", [engine, curves, sets, values] {
+            for (std::size_t s = 0; s < 128; ++s)
+                engine->legs().price(std::span<const YieldCurve* const>(*sets).subspan(2 * s, 2), *values);
+            do_not_optimize(values->front());
+        }, 128 * cashflows);
+
+        std::vector<unsigned> thread_counts = {1, 2, 4};
+        const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        if (hw > 4) thread_counts.push_back(hw);
+        for (unsigned threads : thread_counts) {
+            if (threads > hw) continue;
+            auto pool = std::make_shared<ThreadPool>(threads);
+            for (std::size_t scenarios : {16, 128, 512}) {
+                suite.add("scenarios/" + std::to_string(scenarios) + " scenarios pool of " + std::to_string(threads),
+                          [engine, curves, sets, pool, scenarios] {
+                              const ScenarioPvs pvs = engine->price(
+                                  std::span<const YieldCurve* const>(*sets).first(2 * scenarios), 2, *pool);
+                              do_not_optimize(pvs.values.front());
+                          }, scenarios * cashflows);
+            }
+        }
+    }
+
+    void add_compounding(bench::Suite& suite) {
+        // Ten years of SOFR fixings and 10000 compounded-in-arrears periods of one to twelve months, two lookups
+        // each against the product over every business day in the period
+        const BitmapCalendar& cal = conventions().bitmap_calendar("USGS");
+        const QuantLib::Date first(2, QuantLib::January, 2015);
+        std::vector<double> fixings(static_cast<std::size_t>(cal.business_days_between(
+            first, QuantLib::Date(2, QuantLib::January, 2025))));
+        for (std::size_t i = 0; i < fixings.size(); ++i) fixings[i] = 0.02 + 0.01 * std::sin(0.01 * i);
+        auto sofr = std::make_shared<OvernightCompounder>(cal, first, fixings);
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> day(30, 3000), months(1, 12);
+        auto starts = std::make_shared<std::vector<serial_type>>(), ends = std::make_shared<std::vector<serial_type>>();
+        for (int i = 0; i < 10000; ++i) {
+            const QuantLib::Date s = cal.adjust(first + day(rng));
+            starts->push_back(s.serialNumber());
+            ends->push_back(cal.adjust(s + QuantLib::Period(months(rng), QuantLib::Months)).serialNumber());
+        }
+        auto rates = std::make_shared<std::vector<double>>(starts->size());
+
+        for (const OvernightConvention& c : {OvernightConvention{}, OvernightConvention{2, 0, true},
+                                             OvernightConvention{5, 2, false}}) {
+            const std::string name = "compounding/10000 periods lookback " + std::to_string(c.lookback) +
+                                     " lockout " + std::to_string(c.lockout) + (c.observation_shift ? " shift" : "");
+            suite.add(name, [sofr, starts, ends, rates, c] {
+                sofr->compounded_rates(*starts, *ends, c, *rates);
+                do_not_optimize(rates->front());
+            }, starts->size());
+        }
+
+        auto series = std::make_shared<std::vector<double>>(fixings);
+        const serial_type first_rank = cal.rank(first.serialNumber());
+        suite.add("compounding/10000 periods daily product", [&cal, series, starts, ends, rates, first_rank] {
+            for (std::size_t i = 0; i < starts->size(); ++i) {
+                double growth = 1.0;
+                for (serial_type k = cal.rank((*starts)[i]); k < cal.rank((*ends)[i]); ++k)
+                    growth *= 1.0 + (*series)[static_cast<std::size_t>(k - first_rank)] *
+                                        static_cast<double>(cal.select(k + 1) - cal.select(k)) / 360.0;
+                (*rates)[i] = (growth - 1.0) * 360.0 / static_cast<double>((*ends)[i] - (*starts)[i]);
+            }
+            do_not_optimize(rates->front());
+        }, starts->size());
+    }
+
+    void add_fixings(bench::Suite& suite) {
+        // Twenty years of daily fixings, opened from the mapped store against reading the same fixings as text lines
+        const std::filesystem::path dir = std::filesystem::temp_directory_path();
+        const std::string store_path = (dir / "fixedincomelib_bench_sofr.fix").string();
+        const std::string text_path = (dir / "fixedincomelib_bench_sofr.csv").string();
+        const serial_type first = QuantLib::Date(2, QuantLib::January, 2006).serialNumber();
+        const serial_type last = QuantLib::Date(31, QuantLib::December, 2025).serialNumber();
+        {
+            FixingStoreWriter writer = FixingStoreWriter::create(store_path, "SOFR", first, last + 3650);
+            std::ofstream text(text_path);
+            for (serial_type d = first; d <= last; ++d) {
+                if (QuantLib::Date(d).weekday() % 7 <= 1) continue;
+                const double r = 0.02 + 0.01 * std::sin(0.001 * d);
+                writer.append(d, r);
+                text << Date(QuantLib::Date(d)).get_date_str() << ',' << r << '\n';
+            }
+        }
+
+        suite.add("fixings/open mapped store", [store_path] {
+            FixingStore store(store_path);
+            do_not_optimize(store.first_date());
+        });
+        suite.add("fixings/load text file", [text_path] {
+            std::ifstream in(text_path);
+            std::vector<serial_type> dates;
+            std::vector<double> rates;
+            std::string line;
+            while (std::getline(in, line)) {
+                const std::string_view date = std::string_view(line).substr(0, 10);
+                serial_type s;
+                parse_date_column(std::span<const std::string_view>(&date, 1), std::span<serial_type>(&s, 1));
+                dates.push_back(s);
+                rates.push_back(std::stod(line.substr(11)));
+            }
+            do_not_optimize(rates.back());
+        });
+
+        auto store = std::make_shared<FixingStore>(store_path);
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<serial_type> day(first, last);
+        auto dates = std::make_shared<std::vector<serial_type>>(10000);
+        for (serial_type& d : *dates) d = day(rng);
+        auto out = std::make_shared<std::vector<double>>(dates->size());
+        suite.add("fixings/lookup x10000", [store, dates, out] {
+            do_not_optimize(store->lookup(*dates, *out));
+        }, dates->size());
+    }
+
+    void add_schedule_file(bench::Suite& suite) {
+        // 10000 trades of 2Y-30Y quarterly schedules loaded back by the next batch stage: mapping the binary file and
+        // reading every row's columns, against parsing the same rows from the pipeline's CSV output
+        const std::filesystem::path dir = std::filesystem::temp_directory_path();
+        const std::string binary_path = (dir / "fixedincomelib_bench_schedules.sched").string();
+        const std::string text_path = (dir / "fixedincomelib_bench_schedules.csv").string();
+        std::vector<std::vector<ScheduleRow>> schedules;
+        for (int years = 2; years <= 30; ++years)
+            schedules.push_back(make_schedule(Date(std::string_view("17-03-2025")),
+                                              Date(QuantLib::Date(17, QuantLib::March, 2025 + years)),
+                                              QuantLib::Period(3, QuantLib::Months), conventions().calendar("USGS"),
+                                              QuantLib::ModifiedFollowing, conventions().day_counter("ACT/360")));
+        std::size_t rows = 0;
+        {
+            ScheduleFileWriter writer(binary_path);
+            std::string text = "TradeId,StartDate,EndDate,FixingDate,PaymentDate,Accrued\n";
+            CsvSink sink(text);
+            for (int t = 0; t < 10000; ++t) {
+                const std::string id = "T" + std::to_string(100000 + t);
+                const std::vector<ScheduleRow>& trade = schedules[static_cast<std::size_t>(t) % schedules.size()];
+                writer.append(id, trade);
+                for (const ScheduleRow& r : trade) {
+                    text.append(id);
+                    text.push_back(',');
+                    sink.row(r);
+                }
+                rows += trade.size();
+            }
+            writer.close();
+            std::ofstream(text_path, std::ios::binary).write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+
+        suite.add("schedule_file/map and read " + std::to_string(rows) + " rows", [binary_path] {
+            const ScheduleFile file(binary_path);
+            double accrued = 0.0;
+            std::int64_t payments = 0;
+            for (std::size_t t = 0; t < file.trade_count(); ++t) {
+                const ScheduleColumns c = file.trade(t);
+                for (std::size_t i = 0; i < c.size(); ++i) {
+                    accrued += c.accrued[i];
+                    payments += c.payment_dates[i];
+                }
+            }
+            do_not_optimize(accrued);
+            do_not_optimize(payments);
+        }, rows);
+
+        suite.add("schedule_file/parse CSV " + std::to_string(rows) + " rows", [text_path] {
+            std::ifstream in(text_path, std::ios::binary | std::ios::ate);
+            std::string text(static_cast<std::size_t>(in.tellg()), '\0');
+            in.seekg(0);
+            in.read(text.data(), static_cast<std::streamsize>(text.size()));
+            std::vector<std::string_view> ids;
+            std::vector<serial_type> dates;
+            std::vector<double> accrued;
+            std::size_t pos = text.find('\n') + 1;
+            while (pos < text.size()) {
+                const std::size_t comma = text.find(',', pos), end = text.find('\n', pos);
+                ids.push_back(std::string_view(text).substr(pos, comma - pos));
+                dates.resize(dates.size() + 4);
+                parse_date_column(text.data() + comma + 1, 4, 11, std::span<serial_type>(dates).last(4));
+                double a = 0.0;
+                std::from_chars(text.data() + comma + 45, text.data() + end, a);
+                accrued.push_back(a);
+                pos = end + 1;
+            }
+            do_not_optimize(accrued.back());
+        }, rows);
+    }
+
+    void add_schedule_book(bench::Suite& suite) {
+        // Bringing 4096 quarterly 2Y-10Y trades forward one business day, against regenerating them all as the
+        // morning batch does. The book starts over from a copy once a year has been rolled so it never runs down.
+        constexpr std::size_t n = 4096;
+        std::vector<ScheduleSpec> specs(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const QuantLib::Date s(serial_from_ymd(2024, 1, 1) + static_cast<serial_type>(i % 365));
+            specs[i].start_date = Date(s);
+            specs[i].end_date = Date(s + QuantLib::Period(2 + static_cast<int>(i % 9), QuantLib::Years));
+            specs[i].accrual_period = QuantLib::Period(3, QuantLib::Months);
+            specs[i].holiday_convention = "USGS";
+            specs[i].business_day_convention = "MF";
+            specs[i].accrual_basis = "ACT/360";
+            specs[i].fixing_offset = QuantLib::Period(-2, QuantLib::Days);
+        }
+        const QuantLib::Date first(2, QuantLib::January, 2025);
+        auto fresh = std::make_shared<ScheduleBook>();
+        for (std::size_t i = 0; i < n; ++i) fresh->upsert("T" + std::to_string(100000 + i), specs[i]);
+        fresh->roll(first);
+
+        auto book = std::make_shared<ScheduleBook>(*fresh);
+        auto today = std::make_shared<QuantLib::Date>(first);
+        suite.add("schedule_book/daily roll x" + std::to_string(n), [fresh, book, today, first] {
+            if (*today >= first + 365) {
+                *book = *fresh;
+                *today = first;
+            }
+            *today = conventions().calendar("USGS").advance(*today, 1, QuantLib::Days);
+            ScheduleBookChanges changes = book->roll(*today);
+            do_not_optimize(changes);
+        }, n);
+
+        auto engine = std::make_shared<ScheduleEngine>(1);
+        suite.add("schedule_book/regenerate x" + std::to_string(n), [engine, specs] {
+            auto schedules = engine->generate(specs);
+            do_not_optimize(schedules);
+        }, n);
+    }
+
+    void add_sabr(bench::Suite& suite) {
+        // One op is one vol, so ops/s in the table is vols/s
+        const SabrParameters p{0.03, 0.5, -0.3, 0.4, 0.01};
+        for (std::size_t n : {16, 64, 1024}) {
+            auto strikes = std::make_shared<std::vector<double>>(n);
+            auto out = std::make_shared<std::vector<double>>(n);
+            for (std::size_t i = 0; i < n; ++i) (*strikes)[i] = 0.002 + 0.08 * static_cast<double>(i) / n;
+            suite.add("sabr/implied_vols x" + std::to_string(n), [=] {
+                sabr_implied_vols(p, 0.03, 5.0, *strikes, *out);
+                do_not_optimize(out->front());
+            }, n);
+        }
+        suite.add("sabr/implied_vol scalar", [=] {
+            do_not_optimize(sabr_implied_vol(p, 0.03, 0.035, 5.0));
+        });
+
+        // A full cube, 14 expiries x 12 tenors x 64 strikes, on one thread and on a pool with every hardware thread
+        const std::vector<double> expiries = {0.083, 0.25, 0.5, 0.75, 1, 2, 3, 4, 5, 7, 10, 15, 20, 30};
+        const std::vector<double> tenors = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 20, 30};
+        std::vector<SabrParameters> nodes;
+        for (double e : expiries)
+            for (double t : tenors)
+                nodes.push_back({0.02 + 0.0005 * t, 0.5, -0.3 + 0.01 * e, 0.6 / std::sqrt(1.0 + e), 0.01});
+        auto model = std::make_shared<SabrModel>(expiries, tenors, nodes);
+        const std::size_t cells = expiries.size() * tenors.size(), per_cell = 64;
+        auto strikes = std::make_shared<std::vector<double>>(per_cell);
+        for (std::size_t i = 0; i < per_cell; ++i) (*strikes)[i] = -0.005 + 0.1 * static_cast<double>(i) / per_cell;
+        auto vols = std::make_shared<std::vector<double>>(cells * per_cell);
+
+        auto fill = [=](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; ++c) {
+                const double expiry = expiries[c / tenors.size()], tenor = tenors[c % tenors.size()];
+                model->implied_vol(*strikes, 0.035 + 0.0002 * tenor, expiry, tenor,
+                                   std::span(*vols).subspan(c * per_cell, per_cell));
+            }
+        };
+        const std::string cube = "sabr/cube " + std::to_string(cells) + "x" + std::to_string(per_cell);
+        suite.add(cube + " 1 thread", [=] {
+            fill(0, cells);
+            do_not_optimize(vols->front());
+        }, cells * per_cell);
+
+        auto pool = std::make_shared<ThreadPool>();
+        suite.add(cube + " pool of " + std::to_string(pool->size()), [=] {
+            pool->parallel_for(cells, 4, [&](std::size_t begin, std::size_t end, unsigned) { fill(begin, end); });
+            do_not_optimize(vols->front());
+        }, cells * per_cell);
+
+        // Calibrating the same cube to 17-strike smiles (one op is one node): every node from a cold start, as in
+        // the morning, then intraday with one node's quotes moved and every other node skipped
+        std::vector<SabrQuotes> smiles(cells);
+        for (std::size_t c = 0; c < cells; ++c) {
+            SabrQuotes& q = smiles[c];
+            const std::size_t e = c / tenors.size(), t = c % tenors.size();
+            q.forward = 0.035 + 0.0002 * tenors[t];
+            for (int i = -6; i <= 10; ++i) q.strikes.push_back(q.forward + 0.0025 * i);
+            for (double k : q.strikes) q.vols.push_back(sabr_implied_vol(nodes[c], q.forward, k, expiries[e]));
+        }
+        auto calibrate_all = [=](ThreadPool& on) {
+            SabrCalibrator calibrator(expiries, tenors, 0.5, 0.01);
+            for (std::size_t c = 0; c < cells; ++c)
+                calibrator.set_quotes(c / tenors.size(), c % tenors.size(), smiles[c]);
+            do_not_optimize(calibrator.calibrate(on).converged);
+        };
+        auto single = std::make_shared<ThreadPool>(1);
+        suite.add("sabr/calibrate " + std::to_string(cells) + " nodes cold 1 thread", [=] { calibrate_all(*single); },
+                  cells);
+        suite.add("sabr/calibrate " + std::to_string(cells) + " nodes cold pool of " + std::to_string(pool->size()),
+                  [=] { calibrate_all(*pool); }, cells);
+
+        auto intraday = std::make_shared<SabrCalibrator>(expiries, tenors, 0.5, 0.01);
+        for (std::size_t c = 0; c < cells; ++c) intraday->set_quotes(c / tenors.size(), c % tenors.size(), smiles[c]);
+        intraday->calibrate(*pool);
+        auto tick = std::make_shared<int>(0);
+        suite.add("sabr/calibrate 1 node moved", [=] {
+            SabrQuotes q = smiles[57];
+            *tick = (*tick + 1) % 3;
+            for (double& v : q.vols) v += 0.0005 * *tick;
+            intraday->set_quotes(57 / tenors.size(), 57 % tenors.size(), std::move(q));
+            do_not_optimize(intraday->calibrate(*pool).converged);
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const bench::Options options = bench::parse_options(argc, argv);
+
+        bench::Suite suite;
+        add_parsing(suite);
+        add_conventions(suite);
+        add_qf(suite);
+        add_make_schedule(suite);
+        add_batch(suite);
+        add_curve(suite);
+        add_dv01(suite);
+        add_swaps(suite);
+        add_scenarios(suite);
+        add_compounding(suite);
+        add_fixings(suite);
+        add_schedule_file(suite);
+        add_schedule_book(suite);
+        add_sabr(suite);
+
+        const std::vector<bench::Result> results = suite.run(options);
+        bench::print_table(results);
+
+        // With an instrumented build, where the time inside the qf* calls went over the whole run
+        if (instrumentation::enabled())
+            std::cout << "\n=== Instrumentation ===\n" << instrumentation::to_text(instrumentation::snapshot());
+
+        if (!options.json_path.empty())
+            bench::write_json(results, options.json_path);
+
+        if (!options.baseline_path.empty()) {
+            std::cout << "\n=== Against " << options.baseline_path << " (threshold "
+                      << options.threshold * 100.0 << "%) ===\n";
+            const std::size_t regressions =
+                bench::compare(results, bench::read_json(options.baseline_path), options.threshold);
+            if (regressions != 0) {
+                std::cerr << "ERROR: " << regressions << " regression(s) against the baseline\n";
+                return 1;
+            }
+        }
+        return 0;
+
+    } catch (const std::exception& ex) {
+        std::cerr << "ERROR: " << ex.what() << "\n";
+        return 2;
+    }
+}
@@ -0,0 +1,256 @@
+#include "fixedincomelib/benchmarks/harness.h"
+#include "fixedincomelib/utils/instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+// Global operator new replacement counting every allocation made by the bench executable
+// Only this target links it, the library itself is untouched. An instrumented library brings its own replacement
+// (utils/instrumentation.cpp), and then we count through that one instead.
+#if !FIXEDINCOMELIB_INSTRUMENTATION
+namespace {
+    std::atomic<std::uint64_t> allocations{0};
+
+    void* counted_alloc(std::size_t n) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+namespace fixedincomelib::bench {
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        double elapsed_ns(clock::time_point t0, clock::time_point t1) {
+            return std::chrono::duration<double, std::nano>(t1 - t0).count();
+        }
+
+        double time_iterations(const std::function<void()>& body, std::uint64_t iterations) {
+            const auto t0 = clock::now();
+            for (std::uint64_t i = 0; i < iterations; ++i) body();
+            return elapsed_ns(t0, clock::now());
+        }
+
+        // Median cost of reading the clock twice, taken off every singly timed call
+        double clock_overhead_ns() {
+            std::vector<double> reads(1001);
+            for (double& r : reads) {
+                const auto t0 = clock::now();
+                r = elapsed_ns(t0, clock::now());
+            }
+            std::nth_element(reads.begin(), reads.begin() + 500, reads.end());
+            return reads[500];
+        }
+
+        // q-quantile of sorted values, nearest rank
+        double percentile(const std::vector<double>& sorted, double q) {
+            const std::size_t k = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+            return sorted[std::min(sorted.size() - 1, k == 0 ? 0 : k - 1)];
+        }
+
+        // Value of "key": in one JSON line written by to_json, NaN if absent
+        double number_field(std::string_view line, std::string_view key) {
+            const std::string pattern = "\"" + std::string(key) + "\":";
+            const std::size_t at = line.find(pattern);
+            if (at == std::string_view::npos) return std::nan("");
+            return std::strtod(std::string(line.substr(at + pattern.size(), 32)).c_str(), nullptr);
+        }
+
+        std::string string_field(std::string_view line, std::string_view key) {
+            const std::string pattern = "\"" + std::string(key) + "\":\"";
+            const std::size_t at = line.find(pattern);
+            if (at == std::string_view::npos) return {};
+            const std::size_t begin = at + pattern.size();
+            return std::string(line.substr(begin, line.find('"', begin) - begin));
+        }
+    }
+
+    std::uint64_t allocation_count() {
+#if FIXEDINCOMELIB_INSTRUMENTATION
+        return instrumentation::thread_allocations();
+#else
+        return allocations.load(std::memory_order_relaxed);
+#endif
+    }
+
+    Options parse_options(int argc, char** argv) {
+        Options o;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            auto value = [&](std::string_view flag) -> std::string_view {
+                return arg.substr(flag.size());
+            };
+            if (arg.starts_with("--filter=")) o.filter = value("--filter=");
+            else if (arg.starts_with("--json=")) o.json_path = value("--json=");
+            else if (arg.starts_with("--baseline=")) o.baseline_path = value("--baseline=");
+            else if (arg.starts_with("--threshold=")) o.threshold = std::stod(std::string(value("--threshold=")));
+            else if (arg.starts_with("--samples=")) o.samples = std::max(1, std::stoi(std::string(value("--samples="))));
+            else if (arg.starts_with("--min-sample-ms=")) o.min_sample_ms = std::stod(std::string(value("--min-sample-ms=")));
+            else if (arg.starts_with("--tail-calls="))
+                o.tail_calls = std::max(1, std::stoi(std::string(value("--tail-calls="))));
+            else
+                throw std::invalid_argument("Unknown option: " + std::string(arg) +
+                                            " (expected --filter= --json= --baseline= --threshold= --samples= "
+                                            "--min-sample-ms= --tail-calls=)");
+        }
+        return o;
+    }
+
+    void Suite::add(std::string name, std::function<void()> body, std::uint64_t ops_per_call) {
+        cases_.push_back(Case{std::move(name), std::move(body), std::max<std::uint64_t>(1, ops_per_call)});
+    }
+
+    std::vector<Result> Suite::run(const Options& options) const {
+        std::vector<Result> results;
+        const double overhead_ns = clock_overhead_ns();
+        for (const Case& c : cases_) {
+            if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) continue;
+
+            // Warm up (first-use caches, page faults), then find how many iterations make a sample long enough
+            c.body();
+            std::uint64_t iterations = 1;
+            while (time_iterations(c.body, iterations) < options.min_sample_ms * 1e6 && iterations < (1ull << 30))
+                iterations *= 2;
+
+            std::vector<double> per_op(static_cast<std::size_t>(options.samples));
+            const double ops_per_sample = static_cast<double>(iterations * c.ops_per_call);
+            double total_ns = 0.0;
+            const std::uint64_t allocs_before = allocation_count();
+            for (double& sample : per_op) {
+                const double ns = time_iterations(c.body, iterations);
+                total_ns += ns;
+                sample = ns / ops_per_sample;
+            }
+            const std::uint64_t allocs = allocation_count() - allocs_before;
+            std::sort(per_op.begin(), per_op.end());
+
+            // Tail pass: as many single calls as the samples made (about the same time again), at least 200 so the
+            // p99 isn't simply the slowest one
+            const std::size_t calls = static_cast<std::size_t>(std::clamp<std::uint64_t>(
+                iterations * per_op.size(), 200, static_cast<std::uint64_t>(std::max(options.tail_calls, 200))));
+            std::vector<double> per_call(calls);
+            for (double& call : per_call) {
+                const auto t0 = clock::now();
+                c.body();
+                call = std::max(0.0, elapsed_ns(t0, clock::now()) - overhead_ns) / static_cast<double>(c.ops_per_call);
+            }
+            std::sort(per_call.begin(), per_call.end());
+
+            Result r;
+            r.name = c.name;
+            r.ops = iterations * c.ops_per_call * per_op.size();
+            r.ns_per_op = total_ns / static_cast<double>(r.ops);
+            r.p50_ns = percentile(per_op, 0.50);
+            r.p99_ns = percentile(per_call, 0.99);
+            r.allocs_per_op = static_cast<double>(allocs) / static_cast<double>(r.ops);
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    std::string to_json(const Result& r) {
+        std::ostringstream out;
+        out << std::setprecision(6) << "{\"name\":\"" << r.name << "\",\"ns_per_op\":" << r.ns_per_op
+            << ",\"p50_ns\":" << r.p50_ns << ",\"p99_ns\":" << r.p99_ns << ",\"allocs_per_op\":" << r.allocs_per_op
+            << ",\"ops\":" << r.ops << "}";
+        return out.str();
+    }
+
+    void write_json(const std::vector<Result>& results, const std::string& path) {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("Cannot write benchmark results to " + path);
+        for (const Result& r : results) out << to_json(r) << "\n";
+    }
+
+    std::vector<Result> read_json(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot read benchmark baseline " + path);
+        std::vector<Result> results;
+        std::string line;
+        while (std::getline(in, line)) {
+            Result r;
+            r.name = string_field(line, "name");
+            if (r.name.empty()) continue;
+            r.ns_per_op = number_field(line, "ns_per_op");
+            r.p50_ns = number_field(line, "p50_ns");
+            r.p99_ns = number_field(line, "p99_ns");
+            r.allocs_per_op = number_field(line, "allocs_per_op");
+            r.ops = static_cast<std::uint64_t>(number_field(line, "ops"));
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    void print_table(const std::vector<Result>& results) {
+        std::size_t width = 4;
+        for (const Result& r : results) width = std::max(width, r.name.size());
+
+        std::cout << std::left << std::setw(static_cast<int>(width + 2)) << "case" << std::right
+                  << std::setw(12) << "ns/op" << std::setw(12) << "p50" << std::setw(12) << "p99"
+                  << std::setw(12) << "allocs/op" << std::setw(14) << "ops/s" << "\n";
+        std::cout << std::fixed;
+        for (const Result& r : results) {
+            std::cout << std::left << std::setw(static_cast<int>(width + 2)) << r.name << std::right
+                      << std::setprecision(1) << std::setw(12) << r.ns_per_op << std::setw(12) << r.p50_ns
+                      << std::setw(12) << r.p99_ns << std::setprecision(2) << std::setw(12) << r.allocs_per_op
+                      << std::setprecision(3) << std::scientific << std::setw(14)
+                      << (r.ns_per_op > 0.0 ? 1e9 / r.ns_per_op : 0.0) << std::fixed << "\n";
+        }
+    }
+
+    std::size_t compare(const std::vector<Result>& current, const std::vector<Result>& baseline, double threshold) {
+        std::size_t width = 4, regressions = 0;
+        for (const Result& r : current) width = std::max(width, r.name.size());
+
+        std::cout << std::left << std::setw(static_cast<int>(width + 2)) << "case" << std::right
+                  << std::setw(12) << "base p50" << std::setw(12) << "p50" << std::setw(12) << "change"
+                  << std::setw(14) << "allocs/op" << "  status\n" << std::fixed;
+        for (const Result& r : current) {
+            auto it = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.name == r.name; });
+            std::cout << std::left << std::setw(static_cast<int>(width + 2)) << r.name << std::right;
+            if (it == baseline.end()) {
+                std::cout << std::setw(12) << "-" << std::setprecision(1) << std::setw(12) << r.p50_ns
+                          << std::setw(12) << "-" << std::setw(14) << "-" << "  new\n";
+                continue;
+            }
+
+            const double change = it->p50_ns > 0.0 ? r.p50_ns / it->p50_ns - 1.0 : 0.0;
+            const bool slower = change > threshold;
+            // Allow for rounding in the stored value, one extra allocation every other op is already a change
+            const bool allocates_more = r.allocs_per_op > it->allocs_per_op + 0.5;
+            const char* status = slower && allocates_more ? "REGRESSION (time, allocs)"
+                               : slower                   ? "REGRESSION (time)"
+                               : allocates_more           ? "REGRESSION (allocs)"
+                               : change < -threshold      ? "faster"
+                                                          : "ok";
+            if (slower || allocates_more) ++regressions;
+
+            std::ostringstream allocs;
+            allocs << std::fixed << std::setprecision(2) << it->allocs_per_op << "->" << r.allocs_per_op;
+            std::cout << std::setprecision(1) << std::setw(12) << it->p50_ns << std::setw(12) << r.p50_ns
+                      << std::showpos << std::setw(11) << change * 100.0 << "%" << std::noshowpos
+                      << std::setw(14) << allocs.str() << "  " << status << "\n";
+        }
+        return regressions;
+    }
+}
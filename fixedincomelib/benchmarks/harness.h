@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Small microbenchmark harness for the fixedincomelib_bench suite
+// Each case is timed in samples of a calibrated number of iterations, and we report the mean cost per op, the p50 of
+// the per-sample cost and heap allocations per op (counted by the operator new replacement in harness.cpp). A sample
+// averages away the tail, so the p99 comes from a second pass that times calls one at a time instead (at least 200
+// of them, so it isn't just the slowest call), less what reading the clock costs.
+// Results go out as JSON lines, one object per case, and can be compared against a stored baseline in the same
+// format.
+
+namespace fixedincomelib::bench {
+
+    // Keeps the optimiser from dropping a computation whose result is otherwise unused
+    template <class T>
+    inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    // Number of calls to the global operator new so far, in any thread
+    // (only in the calling thread when the library is built with FIXEDINCOMELIB_INSTRUMENTATION)
+    std::uint64_t allocation_count();
+
+    struct Result {
+        std::string name;
+        double ns_per_op = 0.0;      // total time / total ops
+        double p50_ns = 0.0;         // median over samples of the per-op cost
+        double p99_ns = 0.0;         // 99th percentile over single calls of the per-op cost
+        double allocs_per_op = 0.0;
+        std::uint64_t ops = 0;       // ops timed in total
+    };
+
+    struct Options {
+        std::string filter;          // only run cases whose name contains this
+        std::string json_path;       // write results here as JSON lines (stdout table only if empty)
+        std::string baseline_path;   // compare against this file and flag regressions
+        double threshold = 0.10;     // p50 slower than baseline by more than this fraction is a regression
+        int samples = 25;
+        double min_sample_ms = 2.0;  // iterations per sample are doubled until one sample takes at least this long
+        int tail_calls = 10000;      // calls timed singly for the p99: as many as the samples made, from 200 up to this
+    };
+
+    // Parses --filter= --json= --baseline= --threshold= --samples= --min-sample-ms= --tail-calls=, throws on anything
+    // else
+    Options parse_options(int argc, char** argv);
+
+    class Suite {
+        public:
+            // body() performs ops_per_call operations (e.g. a batch call over n dates counts as n ops)
+            void add(std::string name, std::function<void()> body, std::uint64_t ops_per_call = 1);
+
+            std::vector<Result> run(const Options& options) const;
+
+        private:
+            struct Case {
+                std::string name;
+                std::function<void()> body;
+                std::uint64_t ops_per_call;
+            };
+            std::vector<Case> cases_;
+    };
+
+    std::string to_json(const Result& r);
+    void write_json(const std::vector<Result>& results, const std::string& path);
+    std::vector<Result> read_json(const std::string& path);
+
+    // Prints a comparison table and returns the number of regressions
+    // A case regresses if its p50 is slower than the baseline by more than threshold, or if it allocates more per op
+    std::size_t compare(const std::vector<Result>& current, const std::vector<Result>& baseline, double threshold);
+
+    void print_table(const std::vector<Result>& results);
+
+}
@@ -1,4 +1,7 @@
 #include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/Date/business252.h"
+#include "fixedincomelib/utils/instrumentation.h"
+#include "fixedincomelib/utils/perfecthash.h"
 
 // concrete currencies
 #include <ql/currencies/america.hpp>
@@ -24,42 +27,82 @@
 #include <ql/time/daycounters/actual365fixed.hpp>
 #include <ql/time/daycounters/actual360.hpp>
 #include <ql/time/daycounters/thirty360.hpp>
-#include <ql/time/daycounters/business252.hpp>
 
-#include <cctype>
+#include <array>
 #include <stdexcept>
 
 // Instead of wrapper classes for str -> QuantLib conversions, we simply define primitive types 
 // If we do need objects to add to a collection then wrapper classes may be more appropriate
 
 namespace fixedincomelib {
+    namespace {
+        // Every code each parser accepts, matched case-insensitively
+        // These used to be an uppercased std::string copy compared against each literal in turn
+        constexpr PerfectHashTable<CurrencyId, 6> currency_codes({{
+            {"USD", CurrencyId::USD},
+            {"CAD", CurrencyId::CAD},
+            {"GBP", CurrencyId::GBP},
+            {"EUR", CurrencyId::EUR},
+            {"JPY", CurrencyId::JPY},
+            {"AUD", CurrencyId::AUD},
+        }});
+
+        constexpr PerfectHashTable<QuantLib::BusinessDayConvention, 4> bdc_codes({{
+            {"MF", QuantLib::ModifiedFollowing},
+            {"F", QuantLib::Following},
+            {"P", QuantLib::Preceding},
+            {"NONE", QuantLib::Preceding},
+        }});
+
+        constexpr PerfectHashTable<CalendarId, 7> calendar_codes({{
+            {"NONE", CalendarId::None},
+            {"NYC", CalendarId::NYC},
+            {"USGS", CalendarId::USGS},
+            {"LON", CalendarId::LON},
+            {"TOK", CalendarId::TOK},
+            {"SYD", CalendarId::SYD},
+            {"TARGET", CalendarId::TARGET},
+        }});
+
+        constexpr PerfectHashTable<DayCounterId, 6> accrualbasis_codes({{
+            {"NONE", DayCounterId::None},
+            {"ACT/365", DayCounterId::Act365},
+            {"ACT/ACT", DayCounterId::ActAct},
+            {"ACT/360", DayCounterId::Act360},
+            {"30/360", DayCounterId::Thirty360},
+            {"BUSINESS252", DayCounterId::Business252},
+        }});
+    }
+
+    std::optional<CurrencyId> currency_id(std::string_view s) { return currency_codes.find(s); }
+    std::optional<CalendarId> calendar_id(std::string_view s) { return calendar_codes.find(s); }
+    std::optional<DayCounterId> accrualbasis_id(std::string_view s) { return accrualbasis_codes.find(s); }
+    std::optional<QuantLib::BusinessDayConvention> bdc_id(std::string_view s) { return bdc_codes.find(s); }
+
     /*
     Parsing Functions for Currency
     */
+    const QuantLib::Currency& prebuilt_currency(CurrencyId id) {
+        static const std::array<QuantLib::Currency, static_cast<std::size_t>(CurrencyId::count)> currencies = {
+            QuantLib::USDCurrency(),
+            QuantLib::CADCurrency(),
+            QuantLib::GBPCurrency(),
+            QuantLib::EURCurrency(),
+            QuantLib::JPYCurrency(),
+            QuantLib::AUDCurrency(),
+        };
+        return currencies[static_cast<std::size_t>(id)];
+    }
+
     QuantLib::Currency currency_from_string(std::string_view ccy) {
-        // Copy string_view into string and convert the chars to uppercase 
-        std::string up(ccy); 
-        for (auto ch : up) // Modify each character in our string by converting it to uppercase 
-            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch))); //std::upper expects unsigned char (for safety)
-        
-        if (up == "USD")    
-            return QuantLib::USDCurrency();
-        else if (up == "CAD")
-            return QuantLib::CADCurrency();
-        else if (up == "GBP")
-            return QuantLib::GBPCurrency();
-        else if (up == "EUR")
-            return QuantLib::EURCurrency();
-        else if (up == "JPY")
-            return QuantLib::JPYCurrency();
-        else if (up == "AUD")
-            return QuantLib::AUDCurrency();
-        else
-            throw std::invalid_argument("Unsupported currency: " + std::string(ccy));
+        FIXEDINCOMELIB_PROBE(currency_from_string);
+        if (const std::optional<CurrencyId> id = currency_id(ccy))
+            return prebuilt_currency(*id);
+        throw std::invalid_argument("Unsupported currency: " + std::string(ccy));
     }
 
     // Simple accessor to get currency code 
-    std::string get_currency_code(QuantLib::Currency ccy) {
+    std::string get_currency_code(const QuantLib::Currency& ccy) {
         return ccy.code();
     }
 
@@ -67,17 +110,10 @@ namespace fixedincomelib {
     Parsing Functions for Currency Business Day Conventions
     */
     QuantLib::BusinessDayConvention bdc_from_string(std::string_view s) {
-        std::string up(s);
-        for (auto& ch : up) 
-            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-        if (up == "MF") 
-            return QuantLib::ModifiedFollowing;
-        else if (up == "F")  
-            return QuantLib::Following;
-        else if (up == "P" || up == "NONE") 
-            return QuantLib::Preceding;
-        else
-            throw std::invalid_argument("Unsupported business day convention: " + std::string(s));
+        FIXEDINCOMELIB_PROBE(bdc_from_string);
+        if (const std::optional<QuantLib::BusinessDayConvention> bdc = bdc_id(s))
+            return *bdc;
+        throw std::invalid_argument("Unsupported business day convention: " + std::string(s));
     }
 
     // Accessor to get string from BusinessDayConvention 
@@ -97,58 +133,97 @@ namespace fixedincomelib {
     /*
     Parsing Functions for Holiday Conventions
     */
-    QuantLib::Calendar calendar_from_string(std::string_view s) {
-        std::string up(s);
-        for (auto& ch : up) 
-            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-    
-        if (up == "NONE")  
-            return QuantLib::NullCalendar();
-        else if (up == "NYC")    
-            return QuantLib::UnitedStates(QuantLib::UnitedStates::LiborImpact);
-        // We use FederalReserve, but many people use GovernmentBond for USD rates.
-        else if (up == "USGS")   
-            return QuantLib::UnitedStates(QuantLib::UnitedStates::FederalReserve);
-        else if (up == "LON")    
-            return QuantLib::UnitedKingdom(QuantLib::UnitedKingdom::Exchange);
-        else if (up == "TOK")    
-            return QuantLib::Japan();
-        else if (up == "SYD")    
-            return QuantLib::Australia();
-        else if (up == "TARGET") { //ql.TARGET() is used as a generic EUR settlement calendar
-            return QuantLib::JointCalendar(
-                QuantLib::TARGET(),
-                QuantLib::France(),
-                QuantLib::Germany(),
-                QuantLib::Italy(),
-                QuantLib::JointCalendarRule::JoinHolidays
-            ); // union of all holidays in the joint calender
+    // Each calendar is built the first time it is asked for (a function-local static per case)
+    const QuantLib::Calendar& prebuilt_calendar(CalendarId id) {
+        switch (id) {
+            case CalendarId::None: {
+                static const QuantLib::Calendar cal = QuantLib::NullCalendar();
+                return cal;
+            }
+            case CalendarId::NYC: {
+                static const QuantLib::Calendar cal = QuantLib::UnitedStates(QuantLib::UnitedStates::LiborImpact);
+                return cal;
+            }
+            // We use FederalReserve, but many people use GovernmentBond for USD rates.
+            case CalendarId::USGS: {
+                static const QuantLib::Calendar cal = QuantLib::UnitedStates(QuantLib::UnitedStates::FederalReserve);
+                return cal;
+            }
+            case CalendarId::LON: {
+                static const QuantLib::Calendar cal = QuantLib::UnitedKingdom(QuantLib::UnitedKingdom::Exchange);
+                return cal;
+            }
+            case CalendarId::TOK: {
+                static const QuantLib::Calendar cal = QuantLib::Japan();
+                return cal;
+            }
+            case CalendarId::SYD: {
+                static const QuantLib::Calendar cal = QuantLib::Australia();
+                return cal;
+            }
+            case CalendarId::TARGET: { //ql.TARGET() is used as a generic EUR settlement calendar
+                static const QuantLib::Calendar cal = QuantLib::JointCalendar(
+                    QuantLib::TARGET(),
+                    QuantLib::France(),
+                    QuantLib::Germany(),
+                    QuantLib::Italy(),
+                    QuantLib::JointCalendarRule::JoinHolidays
+                ); // union of all holidays in the joint calender
+                return cal;
+            }
+            case CalendarId::count:
+                break;
         }
-        else
-            throw std::invalid_argument("Unsupported holiday convention: " + std::string(s));
+        throw std::invalid_argument("Invalid calendar id");
+    }
+
+    QuantLib::Calendar calendar_from_string(std::string_view s) {
+        FIXEDINCOMELIB_PROBE(calendar_from_string);
+        if (const std::optional<CalendarId> id = calendar_id(s))
+            return prebuilt_calendar(*id);
+        throw std::invalid_argument("Unsupported holiday convention: " + std::string(s));
     }
     
     /*
     Parsing Functions for Day Counter (Accrual Basis)
     */
+    const QuantLib::DayCounter& prebuilt_day_counter(DayCounterId id) {
+        switch (id) {
+            case DayCounterId::None: {
+                static const QuantLib::DayCounter dc = QuantLib::SimpleDayCounter(); // For theoretical calculations
+                return dc;
+            }
+            case DayCounterId::Act365: {
+                static const QuantLib::DayCounter dc = QuantLib::Actual365Fixed();
+                return dc;
+            }
+            case DayCounterId::ActAct: {
+                static const QuantLib::DayCounter dc = QuantLib::ActualActual(QuantLib::ActualActual::ISDA);
+                return dc;
+            }
+            case DayCounterId::Act360: {
+                static const QuantLib::DayCounter dc = QuantLib::Actual360();
+                return dc;
+            }
+            case DayCounterId::Thirty360: {
+                static const QuantLib::DayCounter dc = QuantLib::Thirty360(QuantLib::Thirty360::ISDA);
+                return dc;
+            }
+            case DayCounterId::Business252: {
+                // Business days counted on a bitmap of the Brazil calendar (O(1) per accrual), built once on first use
+                static const QuantLib::DayCounter dc = BitmapBusiness252();
+                return dc;
+            }
+            case DayCounterId::count:
+                break;
+        }
+        throw std::invalid_argument("Invalid day counter id");
+    }
+
     QuantLib::DayCounter accrualbasis_from_string(std::string_view s) {
-        std::string up(s);
-        for (auto& ch : up) 
-            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-
-        if (up == "NONE")
-            return QuantLib::SimpleDayCounter(); // For theoretical calculations
-        else if (up == "ACT/365")
-            return QuantLib::Actual365Fixed(); 
-        else if (up == "ACT/ACT")
-            return QuantLib::ActualActual(QuantLib::ActualActual::ISDA);
-        else if (up == "ACT/360")
-            return QuantLib::Actual360();
-        else if (up == "30/360")
-            return QuantLib::Thirty360(QuantLib::Thirty360::ISDA);
-        else if (up == "BUSINESS252")
-            return QuantLib::Business252();
-        else
-            throw std::invalid_argument("Unsupported Day Counter: " + std::string(s));
+        FIXEDINCOMELIB_PROBE(accrualbasis_from_string);
+        if (const std::optional<DayCounterId> id = accrualbasis_id(s))
+            return prebuilt_day_counter(*id);
+        throw std::invalid_argument("Unsupported Day Counter: " + std::string(s));
     }
-}
\ No newline at end of file
+}
@@ -5,11 +5,32 @@
 #include <ql/time/businessdayconvention.hpp>
 #include <ql/time/daycounter.hpp>
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 
 namespace fixedincomelib {
 
+    // The codes the parsers below understand, as IDs into tables of prebuilt QuantLib objects
+    // The *_id lookups match case-insensitively through compile-time perfect hash tables (utils/perfecthash.h) and
+    // never allocate; an unknown code gives nullopt. The prebuilt_* accessors build each object on first use and
+    // hand out the same one from then on.
+    enum class CurrencyId : std::uint8_t { USD, CAD, GBP, EUR, JPY, AUD, count };
+    enum class CalendarId : std::uint8_t { None, NYC, USGS, LON, TOK, SYD, TARGET, count };
+    enum class DayCounterId : std::uint8_t { None, Act365, ActAct, Act360, Thirty360, Business252, count };
+
+    std::optional<CurrencyId> currency_id(std::string_view s);
+    std::optional<CalendarId> calendar_id(std::string_view s);
+    std::optional<DayCounterId> accrualbasis_id(std::string_view s);
+    // Business day conventions are already an enum, so they map straight to QuantLib's
+    std::optional<QuantLib::BusinessDayConvention> bdc_id(std::string_view s);
+
+    const QuantLib::Currency& prebuilt_currency(CurrencyId id);
+    const QuantLib::Calendar& prebuilt_calendar(CalendarId id);
+    const QuantLib::DayCounter& prebuilt_day_counter(DayCounterId id);
+
+    // Same lookups returning the object, throw std::invalid_argument on an unknown code
     QuantLib::Currency currency_from_string(std::string_view ccy);
     std::string get_currency_code(const QuantLib::Currency& ccy);
 
@@ -0,0 +1,161 @@
+#include "fixedincomelib/market/fixingstore.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace fixedincomelib {
+    namespace {
+        static_assert(std::endian::native == std::endian::little, "fixing stores are written little-endian");
+
+        // Header fields by offset
+        constexpr std::size_t version_at = 8, first_at = 12, slots_at = 16, name_at = 24;
+
+        std::size_t words_for(std::size_t slots) { return (slots + 63) / 64; }
+        std::size_t bitmap_offset(std::size_t slots) { return fixing_store::header_size + 8 * slots; }
+        std::size_t file_size(std::size_t slots) { return bitmap_offset(slots) + 8 * words_for(slots); }
+
+        // Checks the header and the file length against it
+        void read_header(const char* data, std::size_t size, const std::string& path, serial_type& first,
+                         std::size_t& slots) {
+            if (size < fixing_store::header_size ||
+                std::memcmp(data, fixing_store::magic, sizeof(fixing_store::magic)) != 0)
+                throw std::runtime_error(path + " is not a fixing store");
+            std::uint32_t version;
+            std::int32_t first32;
+            std::uint64_t slots64;
+            std::memcpy(&version, data + version_at, sizeof(version));
+            std::memcpy(&first32, data + first_at, sizeof(first32));
+            std::memcpy(&slots64, data + slots_at, sizeof(slots64));
+            if (version != fixing_store::version)
+                throw std::runtime_error(path + " is fixing store version " + std::to_string(version) + ", expected " +
+                                         std::to_string(fixing_store::version));
+            if (slots64 == 0 || slots64 > static_cast<std::uint64_t>(std::numeric_limits<std::int32_t>::max()) ||
+                size != file_size(static_cast<std::size_t>(slots64)))
+                throw std::runtime_error(path + " is truncated or has a corrupt header");
+            first = static_cast<serial_type>(first32);
+            slots = static_cast<std::size_t>(slots64);
+        }
+
+        std::optional<serial_type> last_set(const std::uint64_t* bits, std::size_t words, serial_type first) {
+            for (std::size_t w = words; w-- > 0;)
+                if (bits[w] != 0)
+                    return first + static_cast<serial_type>(w * 64 + 63 - std::countl_zero(bits[w]));
+            return std::nullopt;
+        }
+    }
+
+    FixingStore::FixingStore(const std::string& path) : file_(path) {
+        read_header(file_.data(), file_.size(), path, first_, slots_);
+        // The map is page aligned and the header is 64 bytes, so both arrays are aligned for their type
+        values_ = reinterpret_cast<const double*>(file_.data() + fixing_store::header_size);
+        bits_ = reinterpret_cast<const std::uint64_t*>(file_.data() + bitmap_offset(slots_));
+    }
+
+    std::string_view FixingStore::index_name() const {
+        const char* name = file_.data() + name_at;
+        return std::string_view(name, static_cast<std::size_t>(
+                                          std::find(name, name + fixing_store::max_index_name, '\0') - name));
+    }
+
+    std::size_t FixingStore::lookup(std::span<const serial_type> dates, std::span<double> out) const {
+        if (out.size() < dates.size())
+            throw std::invalid_argument("FixingStore::lookup: output is shorter than the dates");
+        const double missing = std::numeric_limits<double>::quiet_NaN();
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < dates.size(); ++i) {
+            const bool present = has_fixing(dates[i]);
+            out[i] = present ? values_[static_cast<std::size_t>(dates[i] - first_)] : missing;
+            found += present;
+        }
+        return found;
+    }
+
+    std::size_t FixingStore::count() const {
+        std::size_t n = 0;
+        for (std::size_t w = 0; w < words_for(slots_); ++w) n += static_cast<std::size_t>(std::popcount(bits_[w]));
+        return n;
+    }
+
+    std::optional<serial_type> FixingStore::last_date() const {
+        return last_set(bits_, words_for(slots_), first_);
+    }
+
+    FixingStoreWriter FixingStoreWriter::create(const std::string& path, std::string_view index, serial_type first,
+                                                serial_type last) {
+        if (last < first) throw std::invalid_argument("FixingStoreWriter: empty date range");
+        if (index.size() > fixing_store::max_index_name)
+            throw std::invalid_argument("FixingStoreWriter: index name " + std::string(index) + " is too long");
+
+        FixingStoreWriter writer;
+        writer.path_ = path;
+        writer.first_ = first;
+        writer.slots_ = static_cast<std::size_t>(last - first) + 1;
+        writer.file_.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!writer.file_) throw std::runtime_error("Cannot create " + path);
+
+        char header[fixing_store::header_size] = {};
+        const std::int32_t first32 = static_cast<std::int32_t>(first);
+        const std::uint64_t slots64 = writer.slots_;
+        std::memcpy(header, fixing_store::magic, sizeof(fixing_store::magic));
+        std::memcpy(header + version_at, &fixing_store::version, sizeof(fixing_store::version));
+        std::memcpy(header + first_at, &first32, sizeof(first32));
+        std::memcpy(header + slots_at, &slots64, sizeof(slots64));
+        std::memcpy(header + name_at, index.data(), index.size());
+        writer.file_.write(header, sizeof(header));
+        // Writing the last byte sizes the file; everything in between stays a hole until a fixing lands in it
+        writer.file_.seekp(static_cast<std::streamoff>(file_size(writer.slots_) - 1));
+        writer.file_.put('\0');
+        writer.file_.flush();
+        if (!writer.file_) throw std::runtime_error("Cannot write " + path);
+        return writer;
+    }
+
+    FixingStoreWriter::FixingStoreWriter(const std::string& path)
+        : path_(path), file_(path, std::ios::in | std::ios::out | std::ios::binary) {
+        if (!file_) throw std::runtime_error("Cannot open " + path);
+        file_.seekg(0, std::ios::end);
+        const std::size_t size = static_cast<std::size_t>(file_.tellg());
+        char header[fixing_store::header_size] = {};
+        file_.seekg(0);
+        file_.read(header, static_cast<std::streamsize>(std::min(size, sizeof(header))));
+        read_header(header, size, path, first_, slots_);
+
+        std::vector<std::uint64_t> bits(words_for(slots_));
+        file_.seekg(static_cast<std::streamoff>(bitmap_offset(slots_)));
+        file_.read(reinterpret_cast<char*>(bits.data()), static_cast<std::streamsize>(8 * bits.size()));
+        if (!file_) throw std::runtime_error("Cannot read " + path);
+        last_ = last_set(bits.data(), bits.size(), first_);
+    }
+
+    void FixingStoreWriter::append(serial_type date, double value) {
+        if (date < first_ || date >= end_date())
+            throw std::invalid_argument("FixingStoreWriter::append: serial " + std::to_string(date) +
+                                        " is outside the store's range");
+        if (last_ && date <= *last_)
+            throw std::invalid_argument("FixingStoreWriter::append: serial " + std::to_string(date) +
+                                        " is not after the last fixing");
+        if (!std::isfinite(value)) throw std::invalid_argument("FixingStoreWriter::append: fixing is not finite");
+
+        const std::size_t i = static_cast<std::size_t>(date - first_);
+        file_.seekp(static_cast<std::streamoff>(fixing_store::header_size + 8 * i));
+        file_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        file_.flush();
+
+        // The bit last, byte-wise (the bitmap words are little-endian, so bit i is bit i % 8 of byte i / 8)
+        const std::streamoff at = static_cast<std::streamoff>(bitmap_offset(slots_) + i / 8);
+        char byte = 0;
+        file_.seekg(at);
+        file_.read(&byte, 1);
+        byte = static_cast<char>(byte | (1 << (i % 8)));
+        file_.seekp(at);
+        file_.put(byte);
+        file_.flush();
+        if (!file_) throw std::runtime_error("Cannot append to " + path_);
+        last_ = date;
+    }
+}
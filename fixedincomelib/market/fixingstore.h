@@ -0,0 +1,102 @@
+#pragma once
+
+#include "fixedincomelib/Date/serial.h"
+#include "fixedincomelib/utils/mappedfile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace fixedincomelib {
+
+    // Binary file of one index's historical fixings, laid out so a reader can use it straight off a memory map
+    //   header (64 bytes)   magic, version, index name, serial of slot 0, number of slots
+    //   values              one double per calendar day from slot 0, whatever is in a slot without a fixing is ignored
+    //   presence bitmap     one bit per slot, set when the slot holds a fixing
+    // A fixing is found at value[date - first], so a lookup is an offset and a bit test. The whole date range is laid
+    // out when the file is created; the unwritten part is a sparse hole on disk, so a store covering decades costs
+    // the pages of the dates that actually have fixings. Numbers are in the machine's byte order (little-endian on
+    // everything we build for), the version is bumped whenever the layout changes.
+    namespace fixing_store {
+        inline constexpr char magic[8] = {'F', 'I', 'L', 'F', 'I', 'X', 'S', '\0'};
+        inline constexpr std::uint32_t version = 1;
+        inline constexpr std::size_t header_size = 64;
+        inline constexpr std::size_t max_index_name = 31;
+    }
+
+    // Read-only view of a fixing store. Startup is one mmap and a header check, no parsing; the pages are shared
+    // between every process that maps the file and are read in as they are touched. Lookups are const and can run
+    // concurrently. Fixings appended after the store was opened are seen once the writer has flushed them (the map
+    // shares the page cache), but not dates past the number of slots the file had when it was opened.
+    class FixingStore {
+        public:
+            // Throws std::runtime_error if the file can't be mapped or isn't a fixing store of this version
+            explicit FixingStore(const std::string& path);
+
+            std::string_view index_name() const;
+            serial_type first_date() const { return first_; }
+            // One past the last date the store has room for
+            serial_type end_date() const { return first_ + static_cast<serial_type>(slots_); }
+
+            bool has_fixing(serial_type date) const {
+                const std::size_t i = static_cast<std::size_t>(date - first_);
+                return date >= first_ && i < slots_ && ((bits_[i >> 6] >> (i & 63)) & 1u) != 0;
+            }
+            std::optional<double> fixing(serial_type date) const {
+                if (!has_fixing(date)) return std::nullopt;
+                return values_[static_cast<std::size_t>(date - first_)];
+            }
+
+            // out[i] is the fixing on dates[i], or NaN where there is none; returns the number found
+            // Throws std::invalid_argument if out is shorter than dates
+            std::size_t lookup(std::span<const serial_type> dates, std::span<double> out) const;
+
+            // Number of fixings and the latest date with one (nullopt for an empty store), both scan the bitmap
+            std::size_t count() const;
+            std::optional<serial_type> last_date() const;
+
+        private:
+            MappedFile file_;
+            serial_type first_ = 0;
+            std::size_t slots_ = 0;
+            const double* values_ = nullptr;
+            const std::uint64_t* bits_ = nullptr;
+    };
+
+    // Appends the daily fixing to a store, the only way the file changes once created
+    // Each append writes the value, then its presence bit, then flushes, so a reader never sees a bit set ahead of
+    // its value. A fixing can only go on a date after the latest one already in the store. One writer per file.
+    class FixingStoreWriter {
+        public:
+            // Creates (or truncates) a store for index with room for [first, last]
+            // Throws std::invalid_argument on an empty range or a name over fixing_store::max_index_name characters,
+            // std::runtime_error if the file can't be written
+            static FixingStoreWriter create(const std::string& path, std::string_view index, serial_type first,
+                                            serial_type last);
+
+            // Opens an existing store to append to it; throws std::runtime_error as FixingStore does
+            explicit FixingStoreWriter(const std::string& path);
+
+            // Throws std::invalid_argument for a date outside the store's range or not after last_date(), or a value
+            // that isn't finite; std::runtime_error if the write fails
+            void append(serial_type date, double value);
+
+            serial_type first_date() const { return first_; }
+            serial_type end_date() const { return first_ + static_cast<serial_type>(slots_); }
+            std::optional<serial_type> last_date() const { return last_; }
+
+        private:
+            FixingStoreWriter() = default;
+
+            std::string path_;
+            std::fstream file_;
+            serial_type first_ = 0;
+            std::size_t slots_ = 0;
+            std::optional<serial_type> last_;
+    };
+
+}
@@ -0,0 +1,165 @@
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/Date/schedulecache.h"
+
+#include <ql/time/calendars/jointcalendar.hpp>
+
+#include <cctype>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace fixedincomelib {
+    namespace {
+        // Keys are stored uppercased with whitespace removed, so " nyc + Lon" and "NYC+LON" share an entry
+        // Short keys are normalised into the caller's stack buffer, only unusually long ones allocate
+        constexpr std::size_t max_inline_key = 64;
+
+        std::string_view normalise_key(std::string_view s, char (&buf)[max_inline_key], std::string& overflow) {
+            std::size_t n = 0;
+            bool fits = true;
+            for (char ch : s) {
+                if (std::isspace(static_cast<unsigned char>(ch))) continue;
+                const char up = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+                if (fits && n < max_inline_key) {
+                    buf[n++] = up;
+                } else {
+                    if (fits) overflow.assign(buf, n);
+                    fits = false;
+                    overflow.push_back(up);
+                }
+            }
+            return fits ? std::string_view(buf, n) : std::string_view(overflow);
+        }
+
+        // "NYC+LON" -> JointCalendar(NYC, LON), single names go straight to calendar_from_string
+        QuantLib::Calendar build_calendar(std::string_view key) {
+            if (key.find('+') == std::string_view::npos)
+                return calendar_from_string(key);
+
+            std::vector<QuantLib::Calendar> parts;
+            std::size_t begin = 0;
+            while (begin <= key.size()) {
+                std::size_t end = key.find('+', begin);
+                if (end == std::string_view::npos) end = key.size();
+                if (end == begin)
+                    throw std::invalid_argument("Empty component in holiday convention: " + std::string(key));
+                parts.push_back(calendar_from_string(key.substr(begin, end - begin)));
+                begin = end + 1;
+            }
+            return QuantLib::JointCalendar(parts, QuantLib::JointCalendarRule::JoinHolidays);
+        }
+
+        // Shared lookup-or-build logic for both caches
+        template <class T, class Cache, class Build>
+        const T& lookup(std::shared_mutex& mutex, Cache& cache, std::string_view s, Build&& build) {
+            char buf[max_inline_key];
+            std::string overflow;
+            const std::string_view key = normalise_key(s, buf, overflow);
+
+            {
+                std::shared_lock lock(mutex);
+                auto it = cache.find(key);
+                if (it != cache.end()) return it->second;
+            }
+
+            // Build outside the lock, invalid names throw here and never reach the cache
+            T value = build(key);
+
+            std::unique_lock lock(mutex);
+            // Another thread may have raced us here, in which case we keep theirs
+            return cache.try_emplace(std::string(key), std::move(value)).first->second;
+        }
+    }
+
+    ConventionRegistry& ConventionRegistry::instance() {
+        static ConventionRegistry registry;
+        return registry;
+    }
+
+    // Plain codes ("USGS", "act/360") come straight from the prebuilt tables in market/basics.cpp without taking the
+    // lock, the caches only see joint calendars and names that need normalising (e.g. " usgs")
+    const QuantLib::Calendar& ConventionRegistry::calendar(std::string_view s) {
+        if (const std::optional<CalendarId> id = calendar_id(s))
+            return prebuilt_calendar(*id);
+        return lookup<QuantLib::Calendar>(mutex_, calendars_, s, build_calendar);
+    }
+
+    const QuantLib::DayCounter& ConventionRegistry::day_counter(std::string_view s) {
+        if (const std::optional<DayCounterId> id = accrualbasis_id(s))
+            return prebuilt_day_counter(*id);
+        return lookup<QuantLib::DayCounter>(mutex_, day_counters_, s,
+                                            [](std::string_view key) { return accrualbasis_from_string(key); });
+    }
+
+    const BitmapCalendar& ConventionRegistry::bitmap_calendar(std::string_view s) {
+        // Plain codes remember their cache entry by id, so after the first call there is no lock or map lookup
+        const std::optional<CalendarId> id = calendar_id(s);
+        std::atomic<const BitmapCalendar*>* slot = id ? &bitmap_by_id_[static_cast<std::size_t>(*id)] : nullptr;
+        if (slot) {
+            if (const BitmapCalendar* cached = slot->load(std::memory_order_acquire)) return *cached;
+        }
+
+        char buf[max_inline_key];
+        std::string overflow;
+        const std::string_view key = normalise_key(s, buf, overflow);
+        for (;;) {
+            std::uint64_t seen = 0;
+            {
+                // The slot is only written under the lock, so a holiday change can't be overtaken by a stale store
+                std::shared_lock lock(mutex_);
+                auto it = bitmap_calendars_.find(key);
+                if (it != bitmap_calendars_.end()) {
+                    if (slot) slot->store(&it->second, std::memory_order_release);
+                    return it->second;
+                }
+                seen = generation_.load(std::memory_order_relaxed);
+            }
+
+            // Build outside the lock, invalid names throw here and never reach the cache
+            BitmapCalendar built(calendar(key));
+
+            std::unique_lock lock(mutex_);
+            // A holiday change while we were building may not be in the bitmap, build it again
+            if (generation_.load(std::memory_order_relaxed) != seen) continue;
+            // Another thread may have raced us here, in which case we keep theirs
+            const BitmapCalendar& cal = bitmap_calendars_.try_emplace(std::string(key), std::move(built)).first->second;
+            if (slot) slot->store(&cal, std::memory_order_release);
+            return cal;
+        }
+    }
+
+    template <class Change>
+    void ConventionRegistry::change_holidays(std::string_view s, Change&& change) {
+        // Copies share the holiday sets with the registry's calendar (and with every joint calendar built on it)
+        QuantLib::Calendar cal = calendar(s);
+        {
+            std::unique_lock lock(mutex_);
+            change(cal);
+
+            // A JointCalendar's name lists its components' names, so a substring match catches the joints too
+            const std::string name = cal.name();
+            for (auto it = bitmap_calendars_.begin(); it != bitmap_calendars_.end();) {
+                auto next = std::next(it);
+                if (it->second.calendar().name().find(name) != std::string::npos)
+                    retired_bitmaps_.push_back(bitmap_calendars_.extract(it));
+                it = next;
+            }
+            for (auto& slot : bitmap_by_id_) slot.store(nullptr, std::memory_order_release);
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+        }
+        schedule_cache().invalidate(cal);
+    }
+
+    void ConventionRegistry::add_holiday(std::string_view s, const QuantLib::Date& d) {
+        change_holidays(s, [&](QuantLib::Calendar& cal) { cal.addHoliday(d); });
+    }
+
+    void ConventionRegistry::remove_holiday(std::string_view s, const QuantLib::Date& d) {
+        change_holidays(s, [&](QuantLib::Calendar& cal) { cal.removeHoliday(d); });
+    }
+
+    std::size_t ConventionRegistry::size() const {
+        std::shared_lock lock(mutex_);
+        return calendars_.size() + day_counters_.size() + bitmap_calendars_.size();
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/Date/bitmapcalendar.h"
+
+#include <ql/time/calendar.hpp>
+#include <ql/time/businessdayconvention.hpp>
+#include <ql/time/date.hpp>
+#include <ql/time/daycounter.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Process-wide cache of the QuantLib convention objects built by the *_from_string parsers
+    // Each calendar/day counter is built once on first use and handed out by const reference afterwards, so the
+    // per-trade path does no object construction and no shared_ptr refcount traffic. References stay valid for the
+    // lifetime of the process (unordered_map never moves its nodes).
+    //
+    // Calendars also accept joint expressions such as "NYC+LON", which are built as a JointCalendar joining the
+    // holidays of every component (a date is a business day only if it is one in every component).
+    //
+    // Holidays are changed through add_holiday/remove_holiday, which keep everything derived from a calendar in step
+    // with it: bitmap calendars built before the change are retired (references to them stay valid but stale) and
+    // generation() moves on, so anything holding handles from the registry knows to look them up again.
+    class ConventionRegistry {
+        public:
+            // The single shared instance, constructed on first use (thread-safe since C++11)
+            static ConventionRegistry& instance();
+
+            const QuantLib::Calendar& calendar(std::string_view s = "NONE");
+            const QuantLib::DayCounter& day_counter(std::string_view s = "NONE");
+
+            // Precomputed bitmap form of calendar(s) over BitmapCalendar's default range, built on first use
+            // The reference stays valid for the lifetime of the process, but after a holiday change it is a snapshot
+            // of the old holidays; look it up again once generation() has moved on
+            const BitmapCalendar& bitmap_calendar(std::string_view s = "NONE");
+
+            // Adds/removes a holiday on calendar(s), then retires the bitmap calendars of it and of every joint
+            // calendar containing it, moves generation() on and drops the schedules the process-wide ScheduleCache
+            // built with it
+            // Throws std::invalid_argument for an unknown calendar
+            void add_holiday(std::string_view s, const QuantLib::Date& d);
+            void remove_holiday(std::string_view s, const QuantLib::Date& d);
+
+            // Number of holiday changes made through the registry so far
+            std::uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+            // Business day conventions are plain enums, nothing to cache
+            QuantLib::BusinessDayConvention bdc(std::string_view s = "NONE") const { return bdc_from_string(s); }
+
+            // Number of cached calendars + day counters + bitmap calendars (mainly for tests and diagnostics)
+            // Plain codes are served from the prebuilt tables and only count once they have a bitmap calendar
+            std::size_t size() const;
+
+        private:
+            ConventionRegistry() = default;
+
+            template <class Change>
+            void change_holidays(std::string_view s, Change&& change);
+
+            // Transparent hash so lookups can use a string_view without building a std::string key
+            struct KeyHash {
+                using is_transparent = void;
+                std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+            };
+
+            template <class T>
+            using Cache = std::unordered_map<std::string, T, KeyHash, std::equal_to<>>;
+
+            // Readers take the shared lock, the first request for a new key takes the exclusive one to insert it
+            mutable std::shared_mutex mutex_;
+            Cache<QuantLib::Calendar> calendars_;
+            Cache<QuantLib::DayCounter> day_counters_;
+            Cache<BitmapCalendar> bitmap_calendars_;
+            // Entries of bitmap_calendars_ for the plain codes, by CalendarId
+            std::array<std::atomic<const BitmapCalendar*>, static_cast<std::size_t>(CalendarId::count)> bitmap_by_id_{};
+            // Bitmap calendars replaced after a holiday change, kept in their nodes so old references stay valid
+            std::vector<Cache<BitmapCalendar>::node_type> retired_bitmaps_;
+            // Moved on under the exclusive lock
+            std::atomic<std::uint64_t> generation_{0};
+    };
+
+    // Shorthand used by the api layer
+    inline ConventionRegistry& conventions() { return ConventionRegistry::instance(); }
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "fixedincomelib/Date/utilities.h"
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+// Check counting shared by the test executables
+// Each group of checks gets a Checker; a test passes every group to its Report, which prints the counts and turns
+// any mismatch into a failing exit code.
+
+namespace fixedincomelib::test {
+
+    struct Checker {
+        std::string name;
+        long checks = 0;
+        long mismatches = 0;
+
+        void expect(bool ok, const std::string& what) {
+            ++checks;
+            if (ok) return;
+            // Only print the first few so a systematic bug doesn't flood the output
+            if (++mismatches <= 5) std::cerr << "  mismatch [" << name << "] " << what << "\n";
+        }
+
+        // For checks in hot loops: the message is only built if the check fails
+        template <std::invocable Describe>
+        void expect(bool ok, Describe&& describe) {
+            if (ok) {
+                ++checks;
+                return;
+            }
+            expect(false, std::string(describe()));
+        }
+
+        void expect_near(double got, double want, double tol, const std::string& what) {
+            expect(std::abs(got - want) <= tol, what + ": got " + std::to_string(got) + ", want " +
+                                                    std::to_string(want));
+        }
+
+        // Passes only if f throws an E (or something derived from it)
+        template <class E = std::invalid_argument, class F>
+        void expect_throws(F&& f, const std::string& what) {
+            bool threw = false;
+            try {
+                f();
+            } catch (const E&) {
+                threw = true;
+            }
+            expect(threw, what + " should throw");
+        }
+    };
+
+    // Collects the groups' counts; main ends with return report.finish()
+    struct Report {
+        long failures = 0;
+
+        void operator()(const Checker& check) {
+            std::cout << check.name << ": " << check.checks << " checks, " << check.mismatches << " mismatches\n";
+            failures += check.mismatches;
+        }
+
+        int finish() const {
+            if (failures != 0) {
+                std::cerr << "FAILED with " << failures << " mismatches\n";
+                return 1;
+            }
+            std::cout << "\nAll tests completed.\n";
+            return 0;
+        }
+    };
+
+    // Field for field, accrued compared exactly
+    inline bool same(const ScheduleRow& a, const ScheduleRow& b) {
+        return a.startDate == b.startDate && a.endDate == b.endDate && a.fixingDate == b.fixingDate &&
+               a.paymentDate == b.paymentDate && a.accrued == b.accrued;
+    }
+
+    inline bool same(std::span<const ScheduleRow> a, std::span<const ScheduleRow> b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (!same(a[i], b[i])) return false;
+        return true;
+    }
+
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+#include <ql/time/calendars/jointcalendar.hpp>
+
+#include "fixedincomelib/Date/bitmapcalendar.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/tests/checker.h"
+
+// Parity test: every BitmapCalendar answer must match the QuantLib calendar it was built from, for every day in the
+// range and a margin either side of it (where it falls back to QuantLib)
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+
+    template <class T>
+    void expect_at(Checker& check, const T& got, const T& want, const QuantLib::Date& d, const char* what) {
+        check.expect(got == want, [&] { return std::string(what) + " at " + Date(d).get_date_str(); });
+    }
+
+    void compare(Checker& check, const BitmapCalendar& bitmap, const QuantLib::Calendar& cal,
+                 const QuantLib::Date& from, const QuantLib::Date& to) {
+        const QuantLib::BusinessDayConvention conventions[] = {
+            QuantLib::Following, QuantLib::ModifiedFollowing, QuantLib::Preceding, QuantLib::ModifiedPreceding,
+            QuantLib::Unadjusted, QuantLib::HalfMonthModifiedFollowing, QuantLib::Nearest
+        };
+
+        for (QuantLib::Date d = from; d <= to; ++d) {
+            expect_at(check, bitmap.is_business_day(d), cal.isBusinessDay(d), d, "is_business_day");
+            expect_at(check, bitmap.calendar().isBusinessDay(d), cal.isBusinessDay(d), d, "calendar().isBusinessDay");
+            expect_at(check, bitmap.is_end_of_month(d), cal.isEndOfMonth(d), d, "is_end_of_month");
+            expect_at(check, bitmap.end_of_month(d), cal.endOfMonth(d), d, "end_of_month");
+
+            for (auto c : conventions)
+                expect_at(check, bitmap.adjust(d, c), cal.adjust(d, c), d, "adjust");
+
+            for (int n : {0, 1, 2, 5, 22, -1, -2, -5, -22})
+                expect_at(check, bitmap.advance(d, n, QuantLib::Days), cal.advance(d, n, QuantLib::Days), d,
+                          "advance days");
+
+            for (int n : {1, 3, 6, 12, -3})
+                for (bool eom : {false, true})
+                    for (auto c : {QuantLib::Following, QuantLib::ModifiedFollowing, QuantLib::Unadjusted})
+                        expect_at(check, bitmap.advance(d, n, QuantLib::Months, c, eom),
+                                  cal.advance(d, n, QuantLib::Months, c, eom), d, "advance months");
+
+            expect_at(check, bitmap.advance(d, 2, QuantLib::Weeks), cal.advance(d, 2, QuantLib::Weeks), d,
+                      "advance weeks");
+            expect_at(check, bitmap.business_days_between(d, d + 45), cal.businessDaysBetween(d, d + 45), d,
+                      "business_days_between");
+        }
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    // A shorter range than the default keeps the test quick, and lets us check both sides of the fallback
+    const QuantLib::Date first(1, QuantLib::January, 2000);
+    const QuantLib::Date last(31, QuantLib::December, 2040);
+    const QuantLib::Date from(1, QuantLib::November, 1999);
+    const QuantLib::Date to(28, QuantLib::February, 2041);
+
+    std::cout << "=== BitmapCalendar parity against QuantLib ===\n";
+
+    Report report;
+
+    for (std::string name : {"NONE", "NYC", "USGS", "LON", "TOK", "SYD", "TARGET"}) {
+        Checker check{name};
+        QuantLib::Calendar cal = calendar_from_string(name);
+        compare(check, BitmapCalendar(cal, first, last), cal, from, to);
+        report(check);
+    }
+
+    // Joint calendars built from the bitmaps against QuantLib's JointCalendar
+    QuantLib::Calendar nyc = calendar_from_string("NYC");
+    QuantLib::Calendar lon = calendar_from_string("LON");
+    BitmapCalendar nyc_bitmap(nyc, first, last), lon_bitmap(lon, first, last);
+    {
+        Checker check{"NYC+LON (JoinHolidays)"};
+        compare(check, BitmapCalendar::join_holidays(nyc_bitmap, lon_bitmap),
+                QuantLib::JointCalendar(nyc, lon, QuantLib::JointCalendarRule::JoinHolidays), from, to);
+        report(check);
+    }
+    {
+        Checker check{"NYC|LON (JoinBusinessDays)"};
+        compare(check, BitmapCalendar::join_business_days(nyc_bitmap, lon_bitmap),
+                QuantLib::JointCalendar(nyc, lon, QuantLib::JointCalendarRule::JoinBusinessDays), from, to);
+        report(check);
+    }
+
+    // The bitmap-backed QuantLib::Calendar is a drop-in for make_schedule
+    {
+        Checker check{"make_schedule"};
+        QuantLib::Calendar usgs = calendar_from_string("USGS");
+        BitmapCalendar usgs_bitmap(usgs, first, last);
+        QuantLib::DayCounter dc = accrualbasis_from_string("ACT/360");
+        auto want = make_schedule(Date("25-05-2025"), Date("30-01-2035"), QuantLib::Period(3, QuantLib::Months),
+                                  usgs, QuantLib::ModifiedFollowing, dc, "BACKWARD", false, true,
+                                  QuantLib::Period(-2, QuantLib::Days), QuantLib::Period(2, QuantLib::Days),
+                                  QuantLib::Following, usgs);
+        auto got = make_schedule(Date("25-05-2025"), Date("30-01-2035"), QuantLib::Period(3, QuantLib::Months),
+                                 usgs_bitmap.calendar(), QuantLib::ModifiedFollowing, dc, "BACKWARD", false, true,
+                                 QuantLib::Period(-2, QuantLib::Days), QuantLib::Period(2, QuantLib::Days),
+                                 QuantLib::Following, usgs_bitmap.calendar());
+        expect_at(check, got.size(), want.size(), first, "row count");
+        for (std::size_t i = 0; i < std::min(got.size(), want.size()); ++i) {
+            expect_at(check, got[i].startDate, want[i].startDate, want[i].startDate, "startDate");
+            expect_at(check, got[i].endDate, want[i].endDate, want[i].startDate, "endDate");
+            expect_at(check, got[i].fixingDate, want[i].fixingDate, want[i].startDate, "fixingDate");
+            expect_at(check, got[i].paymentDate, want[i].paymentDate, want[i].startDate, "paymentDate");
+            expect_at(check, got[i].accrued, want[i].accrued, want[i].startDate, "accrued");
+        }
+        report(check);
+    }
+
+    return report.finish();
+}
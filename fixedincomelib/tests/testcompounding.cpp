@@ -0,0 +1,159 @@
+#include <iostream>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/Model/overnightcompounding.h"
+#include "fixedincomelib/tests/checker.h"
+
+// Overnight compounding checks: every convention against the day-by-day product walked on the QuantLib calendar,
+// batch calls and append() agreeing with single queries, and the errors for missing fixings and bad conventions
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+
+    // The textbook definition, one business day at a time
+    double naive_rate(const QuantLib::Calendar& cal, const std::map<serial_type, double>& fixings, double basis,
+                      const QuantLib::Date& start, const QuantLib::Date& end, const OvernightConvention& c) {
+        QuantLib::Date from = start, to = end;
+        if (c.observation_shift) {
+            from = cal.advance(start, -c.lookback, QuantLib::Days);
+            to = cal.advance(end, -c.lookback, QuantLib::Days);
+        }
+        std::vector<double> rates, weights;
+        for (QuantLib::Date d = from; d < to; ++d) {
+            if (!cal.isBusinessDay(d)) continue;
+            const QuantLib::Date fixing = c.observation_shift ? d : cal.advance(d, -c.lookback, QuantLib::Days);
+            rates.push_back(fixings.at(fixing.serialNumber()));
+            weights.push_back(static_cast<double>(cal.advance(d, 1, QuantLib::Days) - d));
+        }
+        const std::size_t m = rates.size();
+        for (std::size_t i = m - static_cast<std::size_t>(c.lockout); i < m; ++i)
+            rates[i] = rates[m - static_cast<std::size_t>(c.lockout) - 1];
+        double growth = 1.0;
+        for (std::size_t i = 0; i < m; ++i) growth *= 1.0 + rates[i] * weights[i] / basis;
+        return (growth - 1.0) * basis / static_cast<double>(to - from);
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== Overnight compounding ===\n";
+
+    Report report;
+
+    const BitmapCalendar& bitmap = conventions().bitmap_calendar("USGS");
+    const QuantLib::Calendar& cal = conventions().calendar("USGS");
+
+    // Two years of made-up SOFR from 02-01-2024
+    const QuantLib::Date first(2, QuantLib::January, 2024);
+    std::vector<double> fixings;
+    std::map<serial_type, double> by_date;
+    for (QuantLib::Date d = first; d < QuantLib::Date(2, QuantLib::January, 2026); ++d) {
+        if (!cal.isBusinessDay(d)) continue;
+        const double r = 0.053 - 0.00002 * static_cast<double>(fixings.size()) +
+                         0.0004 * std::sin(0.3 * static_cast<double>(fixings.size()));
+        by_date[d.serialNumber()] = r;
+        fixings.push_back(r);
+    }
+    const OvernightCompounder sofr(bitmap, first, fixings);
+    const std::vector<ScheduleRow> quarterly =
+        make_schedule(Date("15-02-2024"), Date("15-11-2025"), QuantLib::Period(3, QuantLib::Months), cal,
+                      QuantLib::ModifiedFollowing, accrualbasis_from_string("ACT/360"));
+
+    {
+        Checker check{"Conventions"};
+        check.expect(sofr.size() == fixings.size() && sofr.first_fixing() == first, "size and first fixing");
+        check.expect(sofr.last_fixing().serialNumber() == by_date.rbegin()->first, "last fixing");
+
+        const OvernightConvention conventions[] = {
+            {0, 0, false}, {2, 0, false}, {5, 0, false}, {2, 0, true}, {5, 0, true},
+            {0, 2, false}, {2, 2, false}, {5, 3, true}, {0, 1, true},
+        };
+        for (const OvernightConvention& c : conventions) {
+            const std::string tag = "lookback " + std::to_string(c.lookback) + " lockout " +
+                                    std::to_string(c.lockout) + (c.observation_shift ? " shifted" : "");
+            for (const ScheduleRow& row : quarterly)
+                check.expect_near(sofr.compounded_rate(row.startDate.serialNumber(), row.endDate.serialNumber(), c),
+                                  naive_rate(cal, by_date, 360.0, row.startDate, row.endDate, c), 1e-13,
+                                  tag + " from " + Date(row.startDate).get_date_str());
+            // A single overnight period and a long one
+            const QuantLib::Date d(3, QuantLib::June, 2024), e(3, QuantLib::June, 2025);
+            check.expect_near(sofr.compounded_rate(d.serialNumber(), e.serialNumber(), c),
+                              naive_rate(cal, by_date, 360.0, d, e, c), 1e-13, tag + " over a year");
+            if (c.lockout == 0)
+                check.expect_near(sofr.compounded_rate(d.serialNumber(), (d + 1).serialNumber(), c),
+                                  naive_rate(cal, by_date, 360.0, d, d + 1, c), 1e-13, tag + " overnight");
+        }
+
+        // A flat fixing compounds to the closed form
+        const OvernightCompounder flat(bitmap, first, std::vector<double>(fixings.size(), 0.05), 365.0);
+        const QuantLib::Date d(1, QuantLib::March, 2024), e(3, QuantLib::June, 2024);
+        double growth = 1.0;
+        for (QuantLib::Date x = d; x < e; x = cal.advance(x, 1, QuantLib::Days))
+            growth *= 1.0 + 0.05 * static_cast<double>(cal.advance(x, 1, QuantLib::Days) - x) / 365.0;
+        check.expect_near(flat.compounded_rate(d.serialNumber(), e.serialNumber()),
+                          (growth - 1.0) * 365.0 / static_cast<double>(e - d), 1e-14, "flat fixing, ACT/365");
+        report(check);
+    }
+
+    {
+        Checker check{"Batch and append"};
+        const OvernightConvention c{2, 0, true};
+        std::vector<serial_type> starts, ends;
+        for (const ScheduleRow& row : quarterly) {
+            starts.push_back(row.startDate.serialNumber());
+            ends.push_back(row.endDate.serialNumber());
+        }
+        std::vector<double> by_columns(quarterly.size()), by_rows(quarterly.size());
+        sofr.compounded_rates(starts, ends, c, by_columns);
+        sofr.compounded_rates(quarterly, c, by_rows);
+        for (std::size_t i = 0; i < quarterly.size(); ++i) {
+            const double single = sofr.compounded_rate(starts[i], ends[i], c);
+            check.expect(by_columns[i] == single && by_rows[i] == single, "period " + std::to_string(i));
+        }
+
+        // Fixings published one day at a time end up in the same tables
+        OvernightCompounder live(bitmap, first, std::span<const double>(fixings).first(100));
+        for (std::size_t i = 100; i < fixings.size(); ++i) live.append(fixings[i]);
+        check.expect(live.size() == sofr.size(), "appended size");
+        for (const ScheduleRow& row : quarterly)
+            check.expect(live.compounded_rate(row.startDate.serialNumber(), row.endDate.serialNumber(), {3, 1}) ==
+                             sofr.compounded_rate(row.startDate.serialNumber(), row.endDate.serialNumber(), {3, 1}),
+                         "appended fixings from " + Date(row.startDate).get_date_str());
+        report(check);
+    }
+
+    {
+        Checker check{"Errors"};
+        const serial_type jan = QuantLib::Date(2, QuantLib::January, 2024).serialNumber();
+        const serial_type apr = QuantLib::Date(2, QuantLib::April, 2024).serialNumber();
+        check.expect_throws<std::out_of_range>([&] { sofr.compounded_rate(jan, apr, {2, 0, false}); },
+                                               "lookback before the first fixing");
+        check.expect_throws<std::out_of_range>([&] { sofr.compounded_rate(jan, apr, {2, 0, true}); },
+                                               "shift before the first fixing");
+        check.expect_throws<std::out_of_range>(
+            [&] { sofr.compounded_rate(apr, QuantLib::Date(2, QuantLib::April, 2026).serialNumber()); },
+            "period past the last fixing");
+        check.expect_throws([&] { sofr.compounded_rate(apr, apr); }, "empty period");
+        check.expect_throws([&] { sofr.compounded_rate(jan, apr, {11, 0, false}); }, "lookback past max_lookback");
+        check.expect_throws([&] { sofr.compounded_rate(apr, apr + 1, {0, 1, false}); }, "lockout of the only day");
+        check.expect_throws([&] { OvernightCompounder(bitmap, QuantLib::Date(6, QuantLib::January, 2024), fixings); },
+                            "first fixing on a Saturday");
+        check.expect_throws([&] { OvernightCompounder(bitmap, first, fixings, 0.0); }, "zero basis");
+        report(check);
+    }
+
+    return report.finish();
+}
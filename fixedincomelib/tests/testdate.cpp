@@ -1,14 +1,52 @@
 
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <utility>
 #include <vector>
 
+#include <ql/shared_ptr.hpp>
 #include <ql/time/date.hpp>
+#include <ql/time/daycounter.hpp>
 #include <ql/time/period.hpp>
 
 // your library headers (adjust paths to match your project)
 #include "fixedincomelib/apis/date.h"
+#include "fixedincomelib/apis/datebatch.h"
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/Date/schedulepipeline.h"
+#include "fixedincomelib/utils/instrumentation.h"
+#include "fixedincomelib/utils/threadpool.h"
 // #include "fixedincomelib/Date/basics.h"
 
+namespace {
+    // ACT/360 under another name that runs a hook on its first year fraction, to land a ScheduleCache::invalidate()
+    // in the middle of a build
+    class HookedAct360 : public QuantLib::DayCounter {
+        private:
+            class Impl : public QuantLib::DayCounter::Impl {
+                public:
+                    explicit Impl(std::function<void()> hook): hook_(std::move(hook)) {}
+
+                    std::string name() const override { return "Hooked ACT/360"; }
+
+                    QuantLib::Time yearFraction(const QuantLib::Date& d1, const QuantLib::Date& d2,
+                                                const QuantLib::Date&, const QuantLib::Date&) const override {
+                        if (hook_) std::exchange(hook_, nullptr)();
+                        return (d2 - d1) / 360.0;
+                    }
+
+                private:
+                    mutable std::function<void()> hook_;
+            };
+
+        public:
+            explicit HookedAct360(std::function<void()> hook) {
+                impl_ = QuantLib::ext::make_shared<Impl>(std::move(hook));
+            }
+    };
+}
 
 int main() {
     using namespace fixedincomelib;
@@ -113,6 +151,305 @@ int main() {
 
         std::cout << output << "\n";
 
+        // --------- 9) Batch APIs -----------
+        // The column versions must agree row for row with the single-date functions above
+        std::vector<std::string_view> batch_dates = {
+            "25-05-2025", "21-12-2025", "01-01-2026", "31-12-2025", "01-01-2025", "28-02-2027", "29-02-2028"
+        };
+        std::vector<QuantLib::Date::serial_type> batch_serials(batch_dates.size()), batch_out(batch_dates.size());
+        std::vector<double> batch_yf(batch_dates.size());
+        std::vector<std::uint8_t> batch_flags(batch_dates.size());
+        parse_date_column(batch_dates, batch_serials);
+
+        int batch_mismatches = 0;
+        auto check = [&](bool ok) { if (!ok) ++batch_mismatches; };
+
+        // Batch calls resolve the registry's bitmap calendar afresh, so they have to follow a holiday change the
+        // same way the single-date functions do (on LON, so the USGS schedule from 8 stays cached for 11)
+        auto against_single_date = [&](const std::string& cal) {
+            qfAddPeriodBatch(batch_dates, term, cal, bdc, end_of_month, batch_out);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(Date(QuantLib::Date(batch_out[i])).get_date_str() ==
+                      qfAddPeriod(std::string(batch_dates[i]), term, cal, bdc, end_of_month));
+
+            qfAccruedBatch(batch_serials, batch_out, accrual_basis, bdc, cal, batch_yf);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(batch_yf[i] == qfAccrued(std::string(batch_dates[i]),
+                                               Date(QuantLib::Date(batch_out[i])).get_date_str(),
+                                               accrual_basis, bdc, cal));
+
+            qfMoveToBusinessDayBatch(batch_serials, bdc, cal, batch_out);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(Date(QuantLib::Date(batch_out[i])).get_date_str() ==
+                      qfMoveToBusinessDay(std::string(batch_dates[i]), bdc, cal));
+
+            qfIsBusinessDayBatch(batch_dates, cal, batch_flags);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(bool(batch_flags[i]) == qfIsBusinessDay(std::string(batch_dates[i]), cal));
+
+            qfIsHolidayBatch(batch_serials, cal, batch_flags);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(bool(batch_flags[i]) == qfIsHoliday(std::string(batch_dates[i]), cal));
+
+            qfIsEndOfMonthBatch(batch_serials, cal, batch_flags);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(bool(batch_flags[i]) == qfIsEndOfMonth(std::string(batch_dates[i]), cal));
+
+            qfEndOfMonthBatch(batch_dates, cal, batch_out);
+            for (std::size_t i = 0; i < batch_dates.size(); ++i)
+                check(Date(QuantLib::Date(batch_out[i])).get_date_str() ==
+                      qfEndOfMonth(std::string(batch_dates[i]), cal));
+        };
+        against_single_date(hol);
+        against_single_date("LON");
+        qfAddHoliday("29-02-2028", "LON");
+        against_single_date("LON");
+        check(!qfIsBusinessDay("29-02-2028", "LON") && qfEndOfMonth("29-02-2028", "LON") == "28-02-2028");
+        qfRemoveHoliday("29-02-2028", "LON");
+        against_single_date("LON");
+        check(qfIsBusinessDay("29-02-2028", "LON"));
+
+        // A batch big enough to be split, on a pool, agrees with the same batch run inline
+        ThreadPool batch_pool(3);
+        std::vector<std::string_view> many_dates;
+        for (std::size_t i = 0; i < 50000; ++i) many_dates.push_back(batch_dates[i % batch_dates.size()]);
+        std::vector<QuantLib::Date::serial_type> many_serials(many_dates.size()), inline_out(many_dates.size()),
+            pool_out(many_dates.size());
+        std::vector<double> inline_yf(many_dates.size()), pool_yf(many_dates.size());
+        qfAddPeriodBatch(many_dates, term, hol, bdc, end_of_month, inline_out);
+        qfAddPeriodBatch(many_dates, term, hol, bdc, end_of_month, pool_out, &batch_pool);
+        check(inline_out == pool_out);
+        parse_date_column(many_dates, many_serials);
+        qfAccruedBatch(many_serials, inline_out, accrual_basis, bdc, hol, inline_yf);
+        qfAccruedBatch(many_serials, inline_out, accrual_basis, bdc, hol, pool_yf, &batch_pool);
+        check(inline_yf == pool_yf);
+
+        std::cout << "\n[Batch]\n";
+        std::cout << batch_dates.size() << " dates, mismatches against single-date APIs = " << batch_mismatches << "\n";
+        if (batch_mismatches != 0) {
+            std::cerr << "ERROR: batch APIs disagree with single-date APIs\n";
+            return 1;
+        }
+
+        // --------- 10) Schedule output formats -----------
+        // The same schedule as 8) through the CSV and JSON lines sinks
+        for (const char* format : {"CSV", "JSONL"}) {
+            std::cout << "\n[CreateSchedule " << format << "]\n";
+            std::cout << qfMakeSchedule(sched_start, sched_end, acc_period, acc_hol, acc_bdc, acc_basis, rule,
+                                        sched_eom, fix_in_arrear, fixing_offset, payment_offset, pay_bdc, pay_cal,
+                                        format);
+        }
+        // JSON has no NaN or infinity, a row without a usable accrual goes out as null
+        {
+            const QuantLib::Date d(1, QuantLib::August, 2025);
+            const std::vector<ScheduleRow> odd = {ScheduleRow{d, d, d, d, std::numeric_limits<double>::quiet_NaN()},
+                                                  ScheduleRow{d, d, d, d, std::numeric_limits<double>::infinity()}};
+            const std::string json = write_schedule(odd, ScheduleFormat::JsonLines);
+            const std::string want = "{\"StartDate\":\"01-08-2025\",\"EndDate\":\"01-08-2025\","
+                                     "\"FixingDate\":\"01-08-2025\",\"PaymentDate\":\"01-08-2025\","
+                                     "\"Accrued\":null}\n";
+            if (json != want + want) {
+                std::cerr << "ERROR: non-finite accruals written as " << json << "\n";
+                return 1;
+            }
+        }
+
+        // --------- 11) Schedule cache -----------
+        // 8) and both formats in 10) share one set of terms, so only the first call built the schedule
+        const ScheduleCache::Stats cache_stats = schedule_cache().stats();
+        std::cout << "\n[ScheduleCache]\n";
+        std::cout << "hits=" << cache_stats.hits << " misses=" << cache_stats.misses
+                  << " evictions=" << cache_stats.evictions << " size=" << cache_stats.size << "\n";
+        if (cache_stats.hits != 2 || cache_stats.misses != 1) {
+            std::cerr << "ERROR: repeated schedules were not served from the cache\n";
+            return 1;
+        }
+
+        // A holiday on the first payment date (01-08-2025) has to move it rather than come back from the cache, and
+        // taking the holiday out again has to bring the original rows back. A ScheduleEngine sharing the cache runs
+        // first each time, so its bitmap calendars from the registry have to follow the holiday too, or it would put
+        // stale rows in the cache under the same terms
+        {
+            auto csv = [&] {
+                return qfMakeSchedule(sched_start, sched_end, acc_period, acc_hol, acc_bdc, acc_basis, rule, sched_eom,
+                                      fix_in_arrear, fixing_offset, payment_offset, pay_bdc, pay_cal, "CSV");
+            };
+            ScheduleSpec spec;
+            spec.start_date = Date(sched_start);
+            spec.end_date = Date(sched_end);
+            spec.accrual_period = QuantLib::PeriodParser::parse(acc_period);
+            spec.holiday_convention = acc_hol;
+            spec.business_day_convention = acc_bdc;
+            spec.accrual_basis = acc_basis;
+            spec.rule = rule;
+            spec.end_of_month = sched_eom;
+            spec.fix_in_arrear = fix_in_arrear;
+            spec.fixing_offset = QuantLib::PeriodParser::parse(fixing_offset);
+            spec.payment_offset = QuantLib::PeriodParser::parse(payment_offset);
+            spec.payment_business_day_convention = pay_bdc;
+            spec.payment_holiday_convention = pay_cal;
+            auto first_payment = [&] {
+                return ScheduleEngine(1, &schedule_cache()).generate({spec}).front().front().paymentDate;
+            };
+
+            const std::string before = csv();
+            const QuantLib::Date paid = first_payment();
+            qfAddHoliday("01-08-2025", pay_cal);
+            const QuantLib::Date moved = first_payment();
+            const std::string holiday = csv();
+            qfRemoveHoliday("01-08-2025", pay_cal);
+            const QuantLib::Date restored = first_payment();
+            const std::string after = csv();
+
+            std::istringstream rows(holiday);
+            std::string first_row;
+            std::getline(rows, first_row);
+            std::getline(rows, first_row);
+            std::cout << "holiday on 01-08-2025 => " << first_row << "\n";
+            if (holiday == before || after != before) {
+                std::cerr << "ERROR: the schedule cache outlived a holiday change\n";
+                return 1;
+            }
+            if (paid != QuantLib::Date(1, QuantLib::August, 2025) || moved == paid || restored != paid ||
+                first_row.find(Date(moved).get_date_str()) == std::string::npos) {
+                std::cerr << "ERROR: ScheduleEngine used a calendar from before the holiday change\n";
+                return 1;
+            }
+
+            // A joint calendar goes with any of its components
+            ScheduleCache cache(16, 1);
+            const QuantLib::DayCounter& act360 = conventions().day_counter("ACT/360");
+            for (const char* cal : {"NYC+LON", "TOK"})
+                cache.schedule(Date(sched_start), Date(sched_end), QuantLib::Period(6, QuantLib::Months),
+                               conventions().calendar(cal), QuantLib::Following, act360);
+            if (cache.invalidate(conventions().calendar("LON")) != 1 || cache.stats().size != 1) {
+                std::cerr << "ERROR: ScheduleCache::invalidate missed a joint calendar\n";
+                return 1;
+            }
+
+            // A build that an invalidate() overtakes is handed back but not cached
+            cache.clear();
+            const QuantLib::Calendar& tok = conventions().calendar("TOK");
+            const HookedAct360 hooked([&] { cache.invalidate(tok); });
+            auto build = [&] {
+                return cache.schedule(Date(sched_start), Date(sched_end), QuantLib::Period(6, QuantLib::Months), tok,
+                                      QuantLib::Following, hooked);
+            };
+            const std::size_t rows_built = build()->size();
+            const std::size_t cached_after_race = cache.stats().size;
+            if (rows_built == 0 || cached_after_race != 0 || build()->size() != rows_built || cache.stats().size != 1) {
+                std::cerr << "ERROR: ScheduleCache cached a schedule built across invalidate()\n";
+                return 1;
+            }
+        }
+
+        // --------- 12) Instrumentation -----------
+        // Only checked in a build with FIXEDINCOMELIB_INSTRUMENTATION, every probe reads zero otherwise
+        std::cout << "\n[Instrumentation]\n";
+        if (instrumentation::enabled()) {
+            instrumentation::reset();
+            qfAddPeriod(start_date, term, hol, bdc, end_of_month);
+            qfAddPeriod(start_date, term, hol, bdc, end_of_month);
+            const instrumentation::Snapshot snap = instrumentation::snapshot();
+            const instrumentation::ProbeStats& add = snap[instrumentation::Probe::qfAddPeriod];
+            std::cout << instrumentation::to_text(snap);
+            if (add.calls != 2 || snap[instrumentation::Probe::stage_format].calls != 2 ||
+                add.percentile_ns(0.99) < add.percentile_ns(0.50)) {
+                std::cerr << "ERROR: instrumentation probes did not record the calls\n";
+                return 1;
+            }
+        } else {
+            std::cout << "compiled out\n";
+        }
+
+        // --------- 13) Trade file pipeline -----------
+        // The schedule of 8) again as a trade file line (columns in any order, defaults for the missing ones), next
+        // to a trade without an id and a bad line that is skipped
+        {
+            const std::string trades =
+                "trade_id,start_date,end_date,accrual_period,holiday_convention,business_day_convention,"
+                "accrual_basis,fix_in_arrear,fixing_offset,payment_offset,payment_business_day_convention,"
+                "payment_holiday_convention\n"
+                "SWP1,25-05-2025,30-01-2027,6M,USGS,F,ACT/360,TRUE,1D,2D,F,USGS\r\n"
+                ",25-05-2025,25-05-2026,1Y,NONE,F,ACT/365,N,0D,0D,F,NONE\n"
+                "BAD,31-02-2025,25-05-2026,1Y,USGS,F,ACT/365,N,0D,0D,F,USGS\n";
+
+            SchedulePipelineOptions options;
+            options.threads = 2;
+            options.skip_invalid = true;
+            SchedulePipeline pipeline(options);
+            std::ostringstream out;
+            const SchedulePipelineStats stats = pipeline.run(trades, out);
+
+            std::cout << "\n[SchedulePipeline]\n" << out.str();
+            std::cout << "trades=" << stats.trades << " rows=" << stats.rows << " invalid=" << stats.invalid << "\n";
+
+            // Trade SWP1 has to match qfMakeSchedule's CSV rows for the same terms
+            auto matches_make_schedule = [&](const std::string& output) {
+                std::string expected, got;
+                std::istringstream csv(qfMakeSchedule(sched_start, sched_end, acc_period, acc_hol, acc_bdc, acc_basis,
+                                                      rule, sched_eom, fix_in_arrear, fixing_offset, payment_offset,
+                                                      pay_bdc, pay_cal, "CSV"));
+                std::string line;
+                std::getline(csv, line);   // header
+                while (std::getline(csv, line)) expected += "SWP1," + line + "\n";
+                std::istringstream written(output);
+                while (std::getline(written, line))
+                    if (line.starts_with("SWP1,")) got += line + "\n";
+                return got == expected;
+            };
+            if (!matches_make_schedule(out.str()) || stats.trades != 2 || stats.invalid != 1) {
+                std::cerr << "ERROR: trade file pipeline disagrees with qfMakeSchedule\n";
+                return 1;
+            }
+
+            // Again once a holiday moves SWP1's first payment, and once it is taken out, on a single worker that
+            // already holds its calendars from an earlier run and has to look them up again
+            options.threads = 1;
+            SchedulePipeline single(options);
+            std::ostringstream warm_up;
+            single.run(trades, warm_up);
+            for (bool holiday : {true, false}) {
+                if (holiday)
+                    qfAddHoliday("01-08-2025", pay_cal);
+                else
+                    qfRemoveHoliday("01-08-2025", pay_cal);
+                std::ostringstream again;
+                single.run(trades, again);
+                if (!matches_make_schedule(again.str()) || (again.str() == out.str()) == holiday) {
+                    std::cerr << "ERROR: trade file pipeline kept a calendar from before a holiday change\n";
+                    return 1;
+                }
+            }
+        }
+
+        // --------- 14) Convention codes -----------
+        // Every code resolves in any case (currencies used to match upper case only) and lookalikes don't
+        {
+            std::size_t resolved = 0, rejected = 0;
+            auto check_code = [&](bool found) { found ? ++resolved : ++rejected; };
+            for (const char* code : {"usd", "Cad", "gbP", "eur", "JPY", "aud"})
+                check_code(currency_id(code).has_value());
+            for (const char* code : {"mf", "f", "p", "None"})
+                check_code(bdc_id(code).has_value());
+            for (const char* code : {"none", "nyc", "Usgs", "lon", "tok", "syd", "target"})
+                check_code(calendar_id(code).has_value());
+            for (const char* code : {"none", "act/365", "Act/Act", "ACT/360", "30/360", "business252"})
+                check_code(accrualbasis_id(code).has_value());
+            const std::size_t known = resolved;
+            for (const char* code : {"", "US", "USDX", "MFF", "ACT360", "TARGET2", "NYC+LON"})
+                check_code(calendar_id(code).has_value() || currency_id(code).has_value() ||
+                           bdc_id(code).has_value() || accrualbasis_id(code).has_value());
+
+            std::cout << "\n[Conventions]\n";
+            std::cout << "codes resolved=" << resolved << " rejected=" << rejected
+                      << " currency_from_string(\"eur\")=" << get_currency_code(currency_from_string("eur")) << "\n";
+            if (known != 23 || resolved != 23 || rejected != 7) {
+                std::cerr << "ERROR: convention code lookup\n";
+                return 1;
+            }
+        }
+
         std::cout << "\nAll tests completed.\n";
         return 0;
 
@@ -159,5 +496,40 @@ StartDate   EndDate     FixingDate  PaymentDate  Accrued
 30-07-2026  01-02-2027  02-02-2027  03-02-2027     0.516667
 
 
+[Batch]
+7 dates, mismatches against single-date APIs = 0
+
+[CreateSchedule CSV]
+StartDate,EndDate,FixingDate,PaymentDate,Accrued
+27-05-2025,30-07-2025,31-07-2025,01-08-2025,0.17777777777777778
+30-07-2025,30-01-2026,02-02-2026,03-02-2026,0.5111111111111111
+30-01-2026,30-07-2026,31-07-2026,03-08-2026,0.5027777777777778
+30-07-2026,01-02-2027,02-02-2027,03-02-2027,0.5166666666666667
+
+[CreateSchedule JSONL]
+{"StartDate":"27-05-2025","EndDate":"30-07-2025","FixingDate":"31-07-2025","PaymentDate":"01-08-2025","Accrued":0.17777777777777778}
+{"StartDate":"30-07-2025","EndDate":"30-01-2026","FixingDate":"02-02-2026","PaymentDate":"03-02-2026","Accrued":0.5111111111111111}
+{"StartDate":"30-01-2026","EndDate":"30-07-2026","FixingDate":"31-07-2026","PaymentDate":"03-08-2026","Accrued":0.5027777777777778}
+{"StartDate":"30-07-2026","EndDate":"01-02-2027","FixingDate":"02-02-2027","PaymentDate":"03-02-2027","Accrued":0.5166666666666667}
+
+[ScheduleCache]
+hits=2 misses=1 evictions=0 size=1
+holiday on 01-08-2025 => 27-05-2025,30-07-2025,31-07-2025,04-08-2025,0.17777777777777778
+
+[Instrumentation]
+compiled out
+
+[SchedulePipeline]
+TradeId,StartDate,EndDate,FixingDate,PaymentDate,Accrued
+SWP1,27-05-2025,30-07-2025,31-07-2025,01-08-2025,0.17777777777777778
+SWP1,30-07-2025,30-01-2026,02-02-2026,03-02-2026,0.5111111111111111
+SWP1,30-01-2026,30-07-2026,31-07-2026,03-08-2026,0.5027777777777778
+SWP1,30-07-2026,01-02-2027,02-02-2027,03-02-2027,0.5166666666666667
+3,25-05-2025,25-05-2026,25-05-2025,25-05-2026,1
+trades=2 rows=5 invalid=1
+
+[Conventions]
+codes resolved=23 rejected=7 currency_from_string("eur")=EUR
+
 All tests completed.
 */
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+
+#include "fixedincomelib/market/fixingstore.h"
+#include "fixedincomelib/tests/checker.h"
+
+// Fixing store checks: appended fixings read back from a fresh map, from one opened before the appends, and through
+// a reopened writer; batch lookups with missing dates; and the files and appends that must be rejected
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+
+    // Made-up fixing on weekdays only, so the store has gaps
+    bool has_fixing(serial_type d) { return QuantLib::Date(d).weekday() % 7 > 1; }
+    double fixing(serial_type d) { return 0.01 + 1e-6 * static_cast<double>(d % 1000); }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== Fixing store ===\n";
+
+    Report report;
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string path = (dir / "fixedincomelib_testfixingstore.fix").string();
+    const serial_type first = QuantLib::Date(1, QuantLib::January, 2020).serialNumber();
+    const serial_type last = QuantLib::Date(31, QuantLib::December, 2030).serialNumber();
+    const serial_type mid = QuantLib::Date(1, QuantLib::July, 2023).serialNumber();
+
+    {
+        Checker check{"Append and read"};
+        FixingStoreWriter writer = FixingStoreWriter::create(path, "SOFR", first, last);
+        const FixingStore before(path);
+        check.expect(before.count() == 0 && !before.last_date(), "new store is empty");
+        check.expect(before.index_name() == "SOFR", "index name");
+        check.expect(before.first_date() == first && before.end_date() == last + 1, "date range");
+
+        for (serial_type d = first; d < mid; ++d)
+            if (has_fixing(d)) writer.append(d, fixing(d));
+
+        const FixingStore store(path);
+        std::size_t expected = 0;
+        for (serial_type d = first - 10; d < last + 10; ++d) {
+            const bool present = d >= first && d < mid && has_fixing(d);
+            expected += present;
+            const auto f = store.fixing(d);
+            check.expect(store.has_fixing(d) == present && f.has_value() == present && (!f || *f == fixing(d)),
+                         "fixing on serial " + std::to_string(d));
+        }
+        check.expect(store.count() == expected, "count");
+        check.expect(store.last_date() == writer.last_date() && writer.last_date() < mid, "last date");
+
+        // The store mapped before the appends sees them too
+        check.expect(before.count() == expected && before.fixing(first + 1) == store.fixing(first + 1),
+                     "appends visible to an open reader");
+        report(check);
+    }
+
+    {
+        Checker check{"Batch lookup"};
+        const FixingStore store(path);
+        std::vector<serial_type> dates;
+        for (serial_type d = first - 5; d < mid + 5; d += 3) dates.push_back(d);
+        dates.push_back(last + 100);
+        std::vector<double> out(dates.size());
+        std::size_t found = 0;
+        for (serial_type d : dates) found += store.has_fixing(d);
+        check.expect(store.lookup(dates, out) == found, "number found");
+        for (std::size_t i = 0; i < dates.size(); ++i) {
+            const auto f = store.fixing(dates[i]);
+            check.expect(f ? out[i] == *f : std::isnan(out[i]), "lookup " + std::to_string(i));
+        }
+        check.expect_throws([&] { store.lookup(dates, std::span<double>(out).first(1)); }, "short output");
+        report(check);
+    }
+
+    {
+        Checker check{"Reopen and reject"};
+        FixingStoreWriter writer(path);
+        const serial_type last_fixing = *FixingStore(path).last_date();
+        check.expect(writer.last_date() == last_fixing, "reopened writer finds the last fixing");
+        check.expect_throws([&] { writer.append(last_fixing, 0.02); }, "same date twice");
+        check.expect_throws([&] { writer.append(last_fixing - 1, 0.02); }, "earlier date");
+        check.expect_throws([&] { writer.append(last + 1, 0.02); }, "past the end of the store");
+        check.expect_throws([&] { writer.append(last_fixing + 1, std::nan("")); }, "NaN fixing");
+        writer.append(last, 0.03);
+        check.expect(FixingStore(path).fixing(last) == 0.03, "fixing on the last slot");
+        check.expect_throws([&] { FixingStoreWriter::create(path, "SOFR", last, first); }, "empty range");
+        check.expect_throws([&] { FixingStoreWriter::create(path, std::string(32, 'X'), first, last); },
+                            "long index name");
+
+        const std::string bad = (dir / "fixedincomelib_testfixingstore.bad").string();
+        std::ofstream(bad, std::ios::binary) << "not a fixing store";
+        check.expect_throws<std::runtime_error>([&] { FixingStore store(bad); }, "wrong magic");
+        {
+            FixingStoreWriter::create(bad, "ESTR", first, first + 100);
+            std::filesystem::resize_file(bad, 200);
+        }
+        check.expect_throws<std::runtime_error>([&] { FixingStore store(bad); }, "truncated file");
+        check.expect_throws<std::runtime_error>([&] { FixingStore store((dir / "no_such_store.fix").string()); },
+                                                "missing file");
+        std::filesystem::remove(bad);
+        report(check);
+    }
+    std::filesystem::remove(path);
+
+    return report.finish();
+}
@@ -0,0 +1,267 @@
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fixedincomelib/Model/sabr.h"
+#include "fixedincomelib/Model/sabrcalibration.h"
+#include "fixedincomelib/tests/checker.h"
+
+// SABR checks: the vectorized kernel against a plain long double transcription of Hagan's formula (through the ATM
+// limit, where the direct z / x(z) cancels), batch against scalar, interpolation of the parameter cube, and
+// calibration (analytic gradient against finite differences, recovering known parameters, warm starts and skips)
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+
+    // Hagan et al. (2002), eq. (2.17a), term by term in long double
+    double reference_vol(const SabrParameters& p, double forward, double strike, double expiry) {
+        using ld = long double;
+        const ld f = static_cast<ld>(forward) + p.shift, k = static_cast<ld>(strike) + p.shift;
+        const ld b1 = 1.0L - p.beta;
+        const ld fk_b = std::pow(f * k, b1 / 2.0L);
+        const ld l = std::log(f / k);
+        const ld z = static_cast<ld>(p.nu) / p.alpha * fk_b * l;
+        // x(z) through log1p, with sqrt(1 - 2 rho z + z^2) - 1 rearranged so nothing cancels near the money
+        const ld root = std::sqrt(1.0L - 2.0L * p.rho * z + z * z);
+        const ld x = std::log1p(((z * z - 2.0L * p.rho * z) / (root + 1.0L) + z) / (1.0L - p.rho));
+        const ld z_over_x = z == 0.0L ? 1.0L : z / x;
+        const ld denominator = fk_b * (1.0L + b1 * b1 * l * l / 24.0L + std::pow(b1 * l, 4.0L) / 1920.0L);
+        const ld time = 1.0L + (b1 * b1 * p.alpha * p.alpha / (24.0L * fk_b * fk_b) +
+                                0.25L * p.rho * p.beta * p.nu * p.alpha / fk_b +
+                                (2.0L - 3.0L * p.rho * p.rho) * p.nu * p.nu / 24.0L) * expiry;
+        return static_cast<double>(p.alpha / denominator * z_over_x * time);
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== SABR (kernel " << (sabr_use_avx2() ? "AVX2" : "baseline") << ") ===\n";
+
+    Report report;
+
+    const std::vector<SabrParameters> sets = {
+        {0.030, 0.5, -0.30, 0.40, 0.00},
+        {0.010, 0.0, 0.20, 0.30, 0.02},    // normal-like, shifted for negative rates
+        {0.200, 1.0, -0.60, 0.80, 0.00},   // lognormal
+        {0.050, 0.7, 0.90, 1.50, 0.01},
+        {0.025, 0.3, 0.00, 0.00, 0.00},    // nu = 0: CEV
+    };
+
+    {
+        Checker check{"Kernel against Hagan"};
+        for (const SabrParameters& p : sets) {
+            for (double forward : {-0.005, 0.001, 0.025, 0.06}) {
+                if (forward + p.shift <= 0.0) continue;
+                // Far wings, then ever closer to the money, right through the series cutoff
+                std::vector<double> strikes;
+                for (double m : {0.2, 0.5, 0.8, 0.95, 1.05, 1.5, 3.0})
+                    strikes.push_back((forward + p.shift) * m - p.shift);
+                for (double h = 1e-2; h > 1e-12; h /= 3.0) {
+                    strikes.push_back((forward + p.shift) * (1.0 + h) - p.shift);
+                    strikes.push_back((forward + p.shift) * (1.0 - h) - p.shift);
+                }
+                strikes.push_back(forward);
+
+                for (double expiry : {0.25, 5.0, 30.0}) {
+                    std::vector<double> vols(strikes.size());
+                    sabr_implied_vols(p, forward, expiry, strikes, vols);
+                    for (std::size_t i = 0; i < strikes.size(); ++i) {
+                        const double want = reference_vol(p, forward, strikes[i], expiry);
+                        check.expect_near(vols[i], want, 1e-13 * want,
+                                          "K=" + std::to_string(strikes[i]) + " F=" + std::to_string(forward));
+                        check.expect(vols[i] == sabr_implied_vol(p, forward, strikes[i], expiry), "batch == scalar");
+                    }
+                }
+            }
+        }
+
+        const SabrParameters p = sets[0];
+        const double atm = sabr_implied_vol(p, 0.03, 0.03, 1.0);
+        const double b1 = 1.0 - p.beta, fb = std::pow(0.03, b1);
+        check.expect_near(atm, p.alpha / fb * (1.0 + (b1 * b1 * p.alpha * p.alpha / (24.0 * fb * fb) +
+                                                      0.25 * p.rho * p.beta * p.nu * p.alpha / fb +
+                                                      (2.0 - 3.0 * p.rho * p.rho) * p.nu * p.nu / 24.0)),
+                          1e-15, "ATM closed form");
+        check.expect(std::isnan(sabr_implied_vol(p, 0.03, -0.01, 1.0)), "strike below -shift is NaN");
+        // A forward at or below -shift gives NaN for every strike, on both the scalar and the column path
+        const SabrParameters shifted = sets[1];
+        const std::vector<double> smile = {-0.005, 0.0, 0.01, 0.03};
+        std::vector<double> vols(smile.size());
+        for (double forward : {-shifted.shift, -shifted.shift - 0.01}) {
+            sabr_implied_vols(shifted, forward, 1.0, smile, vols);
+            for (std::size_t i = 0; i < smile.size(); ++i)
+                check.expect(std::isnan(vols[i]) && std::isnan(sabr_implied_vol(shifted, forward, smile[i], 1.0)),
+                             "forward " + std::to_string(forward) + " strike " + std::to_string(smile[i]) + " is NaN");
+        }
+        report(check);
+    }
+
+    {
+        Checker check{"SabrModel cube"};
+        const std::vector<double> expiries = {1.0, 5.0, 10.0};
+        const std::vector<double> tenors = {2.0, 10.0};
+        std::vector<SabrParameters> nodes;
+        for (std::size_t e = 0; e < expiries.size(); ++e)
+            for (std::size_t t = 0; t < tenors.size(); ++t)
+                nodes.push_back({0.02 + 0.001 * e, 0.5, -0.2 + 0.1 * t, 0.3 + 0.05 * e, 0.01});
+        SabrModel model(expiries, tenors, nodes);
+
+        check.expect(model.model_type() == ModelType::IR_SABR, "model_type");
+        const SabrParameters at_node = model.parameters(5.0, 10.0);
+        check.expect(at_node.alpha == nodes[3].alpha && at_node.rho == nodes[3].rho && at_node.nu == nodes[3].nu,
+                     "parameters on a node");
+        const SabrParameters mid = model.parameters(3.0, 6.0);
+        check.expect_near(mid.alpha, 0.0205, 1e-15, "bilinear alpha");
+        check.expect_near(mid.rho, -0.15, 1e-15, "bilinear rho");
+        check.expect_near(mid.nu, 0.325, 1e-15, "bilinear nu");
+        const SabrParameters outside = model.parameters(40.0, 0.5);
+        check.expect(outside.alpha == nodes[4].alpha && outside.rho == nodes[4].rho, "flat outside the grid");
+
+        const std::vector<double> strikes = {0.01, 0.02, 0.03, 0.04};
+        std::vector<double> vols(strikes.size());
+        model.implied_vol(strikes, 0.025, 3.0, 6.0, vols);
+        for (std::size_t i = 0; i < strikes.size(); ++i)
+            check.expect(vols[i] == sabr_implied_vol(mid, 0.025, strikes[i], 3.0), "model vol uses interpolated set");
+        const double below = -mid.shift - 0.001;
+        model.implied_vol(strikes, below, 3.0, 6.0, vols);
+        for (std::size_t i = 0; i < strikes.size(); ++i)
+            check.expect(std::isnan(vols[i]) && std::isnan(model.implied_vol(strikes[i], below, 3.0, 6.0)),
+                         "model vol with a forward below -shift is NaN");
+
+        check.expect_throws([&] { model.set_node(0, 0, {0.02, 0.5, 1.0, 0.3, 0.0}); }, "rho = 1");
+        check.expect_throws([&] { model.set_node(0, 0, {-0.02, 0.5, 0.0, 0.3, 0.0}); }, "negative alpha");
+        check.expect_throws([&] { SabrModel(std::vector<double>{5.0, 1.0}, tenors, nodes); }, "unsorted expiries");
+        check.expect_throws([&] { SabrModel(expiries, tenors, std::span(nodes).first(5)); }, "too few nodes");
+        report(check);
+    }
+
+    {
+        Checker check{"Vol gradient"};
+        for (const SabrParameters& p : sets) {
+            if (p.nu == 0.0) continue;   // d/dnu one-sided there
+            for (double m : {0.3, 0.7, 0.99, 1.0, 1.0 + 1e-6, 1.02, 1.6, 4.0}) {
+                const double forward = 0.03, strike = (forward + p.shift) * m - p.shift, expiry = 4.0;
+                double d_alpha, d_rho, d_nu;
+                const double vol = sabr_implied_vol_gradient(p, forward, strike, expiry, d_alpha, d_rho, d_nu);
+                check.expect_near(vol, sabr_implied_vol(p, forward, strike, expiry), 1e-12 * vol, "vol");
+
+                // Central differences, h^2 error well under the tolerance
+                auto bumped = [&](double SabrParameters::*field, double h) {
+                    SabrParameters up = p, down = p;
+                    up.*field += h;
+                    down.*field -= h;
+                    return (sabr_implied_vol(up, forward, strike, expiry) -
+                            sabr_implied_vol(down, forward, strike, expiry)) / (2.0 * h);
+                };
+                const std::string at = " at K/F=" + std::to_string(m);
+                const double scale = vol / p.alpha;
+                check.expect_near(d_alpha, bumped(&SabrParameters::alpha, 1e-6 * p.alpha), 1e-6 * scale,
+                                  "d_alpha" + at);
+                check.expect_near(d_rho, bumped(&SabrParameters::rho, 1e-6), 1e-6 * vol, "d_rho" + at);
+                check.expect_near(d_nu, bumped(&SabrParameters::nu, 1e-6), 1e-6 * vol, "d_nu" + at);
+            }
+        }
+        report(check);
+    }
+
+    {
+        Checker check{"Calibration"};
+        const std::vector<double> expiries = {1.0, 5.0, 10.0};
+        const std::vector<double> tenors = {2.0, 10.0};
+        const double beta = 0.5, shift = 0.01;
+        auto truth = [&](std::size_t e, std::size_t t, double bump) {
+            return SabrParameters{0.03 + 0.002 * e + bump, beta, -0.3 + 0.2 * t + bump, 0.5 - 0.1 * e + bump, shift};
+        };
+        auto smile = [&](const SabrParameters& p, std::size_t e, std::size_t t) {
+            SabrQuotes q;
+            q.forward = 0.02 + 0.005 * t;
+            for (double k = q.forward - 0.015; k < q.forward + 0.03; k += 0.0025) q.strikes.push_back(k);
+            for (double k : q.strikes) q.vols.push_back(sabr_implied_vol(p, q.forward, k, expiries[e]));
+            return q;
+        };
+
+        ThreadPool pool(2);
+        SabrCalibrator calibrator(expiries, tenors, beta, shift);
+        // Every node but (1, 1) first, that one then has fitted neighbours to start from
+        for (std::size_t e = 0; e < expiries.size(); ++e)
+            for (std::size_t t = 0; t < tenors.size(); ++t)
+                if (e != 1 || t != 1) calibrator.set_quotes(e, t, smile(truth(e, t, 0.0), e, t));
+
+        SabrCalibrationReport first = calibrator.calibrate(pool);
+        check.expect(first.calibrated == 5 && first.converged == 5 && first.skipped == 0, "first run fits 5 nodes");
+        check.expect(first.nodes[3].status == SabrNodeReport::Status::NoQuotes, "node without quotes");
+        check.expect(first.wall_seconds > 0.0 && first.threads == 2, "wall time and threads");
+        for (std::size_t e = 0; e < expiries.size(); ++e) {
+            for (std::size_t t = 0; t < tenors.size(); ++t) {
+                if (e == 1 && t == 1) continue;
+                const SabrNodeReport& r = first.nodes[e * tenors.size() + t];
+                const std::string at = " at (" + std::to_string(e) + ", " + std::to_string(t) + ")";
+                check.expect(r.start == SabrNodeReport::Start::Guess, "cold start" + at);
+                check.expect(r.rms_error < 1e-10, "fits exact quotes" + at);
+                const SabrParameters fitted = calibrator.model().node(e, t), want = truth(e, t, 0.0);
+                check.expect_near(fitted.alpha, want.alpha, 1e-8, "alpha" + at);
+                check.expect_near(fitted.rho, want.rho, 1e-6, "rho" + at);
+                check.expect_near(fitted.nu, want.nu, 1e-6, "nu" + at);
+                check.expect(fitted.beta == beta && fitted.shift == shift, "beta and shift held" + at);
+            }
+        }
+
+        // The missing node starts from its neighbours, nothing else is refitted
+        calibrator.set_quotes(1, 1, smile(truth(1, 1, 0.0), 1, 1));
+        SabrCalibrationReport second = calibrator.calibrate(pool);
+        check.expect(second.calibrated == 1 && second.skipped == 5, "only the new node is fitted");
+        check.expect(second.nodes[3].start == SabrNodeReport::Start::Neighbour, "neighbour start");
+        check.expect(second.nodes[3].status == SabrNodeReport::Status::Converged, "neighbour start converges");
+        check.expect_near(calibrator.model().node(1, 1).rho, truth(1, 1, 0.0).rho, 1e-6, "neighbour start rho");
+
+        // Same quotes again change nothing, a small move on one node is a warm refit
+        calibrator.set_quotes(2, 0, smile(truth(2, 0, 0.0), 2, 0));
+        check.expect(!calibrator.pending(2, 0), "unchanged quotes aren't pending");
+        calibrator.set_quotes(2, 0, smile(truth(2, 0, 0.001), 2, 0));
+        check.expect(calibrator.pending(2, 0), "changed quotes are pending");
+        SabrCalibrationReport third = calibrator.calibrate(pool);
+        const SabrNodeReport& moved = third.nodes[4];
+        check.expect(third.calibrated == 1 && moved.start == SabrNodeReport::Start::Previous, "warm refit");
+        check.expect(moved.iterations < first.nodes[4].iterations, "warm refit takes fewer iterations");
+        check.expect_near(calibrator.model().node(2, 0).nu, truth(2, 0, 0.001).nu, 1e-6, "warm refit nu");
+
+        // A previous cube seeds a new calibrator
+        SabrCalibrator tomorrow(calibrator.model());
+        tomorrow.set_quotes(0, 0, smile(truth(0, 0, 0.0), 0, 0));
+        check.expect(tomorrow.calibrate(pool).nodes[0].start == SabrNodeReport::Start::Previous, "seeded from a cube");
+
+        // With both tolerances at zero nothing can converge: a fit that stalls or runs out of iterations is kept but
+        // isn't counted as converged
+        SabrCalibrationOptions strict;
+        strict.gradient_tolerance = 0.0;
+        strict.step_tolerance = 0.0;
+        strict.max_iterations = 1000;
+        SabrCalibrator unreachable(expiries, tenors, beta, shift, strict);
+        SabrQuotes noisy = smile(truth(0, 0, 0.0), 0, 0);
+        for (std::size_t i = 0; i < noisy.vols.size(); ++i) noisy.vols[i] *= i % 2 ? 1.01 : 0.99;
+        unreachable.set_quotes(0, 0, noisy);
+        const SabrCalibrationReport stalled = unreachable.calibrate(pool);
+        check.expect(stalled.calibrated == 1 && stalled.converged == 0, "no tolerance met, not converged");
+        check.expect(stalled.nodes[0].status == SabrNodeReport::Status::MaxIterations, "stalled fit is flagged");
+        check.expect(stalled.nodes[0].iterations < strict.max_iterations && stalled.nodes[0].rms_error < 0.01,
+                     "stalled before the iteration limit, with a usable fit");
+
+        SabrQuotes two = smile(truth(0, 0, 0.0), 0, 0);
+        two.strikes.resize(2);
+        two.vols.resize(2);
+        check.expect_throws([&] { calibrator.set_quotes(0, 0, two); }, "two strikes");
+        SabrQuotes low = smile(truth(0, 0, 0.0), 0, 0);
+        low.strikes.front() = -0.02;
+        check.expect_throws([&] { calibrator.set_quotes(0, 0, low); }, "strike below -shift");
+        check.expect_throws<std::out_of_range>([&] { calibrator.set_quotes(3, 0, smile(truth(0, 0, 0.0), 0, 0)); },
+                                               "node off the grid");
+        report(check);
+    }
+
+    return report.finish();
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/schedulebook.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/tests/checker.h"
+
+// Schedule book checks: after every roll the held rows and fixed counts match a full regeneration filtered to the
+// as-of date, the report accounts for every row that was paid or fixed and for every term, calendar and membership
+// change, and trades that didn't change are left out of it
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+    using test::same;
+
+    // What the book should hold: the full schedule less the rows paid by as_of, and how many of those are fixed
+    struct Expected {
+        std::vector<ScheduleRow> rows;
+        std::size_t fixed = 0;
+    };
+
+    Expected expected(const ScheduleSpec& s, const QuantLib::Date& as_of) {
+        ConventionRegistry& c = conventions();
+        Expected e;
+        for (const ScheduleRow& r : make_schedule(s.start_date, s.end_date, s.accrual_period,
+                                                  c.calendar(s.holiday_convention), c.bdc(s.business_day_convention),
+                                                  c.day_counter(s.accrual_basis), s.rule, s.end_of_month,
+                                                  s.fix_in_arrear, s.fixing_offset, s.payment_offset,
+                                                  c.bdc(s.payment_business_day_convention),
+                                                  c.calendar(s.payment_holiday_convention))) {
+            if (r.paymentDate <= as_of) continue;
+            e.rows.push_back(r);
+            if (r.fixingDate <= as_of) ++e.fixed;
+        }
+        return e;
+    }
+
+    bool matches(const ScheduleBook::Trade& t, const Expected& e) {
+        if (t.rows.size() != e.rows.size() || t.fixed != e.fixed) return false;
+        for (std::size_t i = 0; i < e.rows.size(); ++i)
+            if (!same(t.rows[i], e.rows[i])) return false;
+        return true;
+    }
+
+    std::map<std::string, ScheduleChange> by_id(const ScheduleBookChanges& changes) {
+        std::map<std::string, ScheduleChange> out;
+        for (const ScheduleChange& c : changes.trades) out[c.trade_id] = c;
+        return out;
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== Schedule book ===\n";
+
+    Report report;
+
+    // Monthly to annual, fixing in advance and in arrears, with and without a payment lag; some already running,
+    // some forward starting and a few maturing inside the test window
+    std::map<std::string, ScheduleSpec> specs;
+    for (int i = 0; i < 24; ++i) {
+        ScheduleSpec s;
+        const int months = i % 4 == 0 ? 1 : i % 4 == 1 ? 3 : i % 4 == 2 ? 6 : 12;
+        s.start_date = Date(QuantLib::Date(10 + i % 7, QuantLib::Month(1 + i % 12), 2024 + i % 3));
+        s.end_date = Date(QuantLib::Date(10 + i % 7, QuantLib::Month(1 + i % 12), 2025 + i % 3 + (i % 5) * 2));
+        s.accrual_period = QuantLib::Period(months, QuantLib::Months);
+        s.holiday_convention = i % 3 == 2 ? "LON" : "USGS";
+        s.business_day_convention = "MF";
+        s.accrual_basis = "ACT/360";
+        s.fix_in_arrear = i % 3 == 0;
+        s.fixing_offset = QuantLib::Period(s.fix_in_arrear ? -2 : -5, QuantLib::Days);
+        s.payment_offset = QuantLib::Period(i % 2 == 0 ? 2 : 0, QuantLib::Days);
+        s.payment_holiday_convention = "USGS";
+        specs["IRS-" + std::to_string(100 + i)] = s;
+    }
+
+    ScheduleBook book;
+    for (const auto& [id, s] : specs) book.upsert(id, s);
+    QuantLib::Date today(2, QuantLib::January, 2025);
+
+    auto check_book = [&](Checker& check, const std::string& tag) {
+        for (const auto& [id, s] : specs)
+            check.expect(matches(book.trade(id), expected(s, today)), tag + " " + id + " rows");
+    };
+
+    {
+        Checker check{"First roll"};
+        const ScheduleBookChanges changes = book.roll(today);
+        check.expect(changes.trades.size() == specs.size() && changes.regenerated == specs.size(), "every trade added");
+        bool added = true;
+        for (const ScheduleChange& c : changes.trades)
+            added = added && c.kind == ScheduleChange::Kind::Added && c.live == book.trade(c.trade_id).rows.size();
+        check.expect(added, "kinds and live counts");
+        check.expect(changes.calendars.empty(), "no calendar changes");
+        check_book(check, "first roll");
+
+        const ScheduleBookChanges again = book.roll(today);
+        check.expect(again.trades.empty() && again.regenerated == 0, "rolling to the same date changes nothing");
+        report(check);
+    }
+
+    {
+        Checker check{"Daily roll"};
+        std::map<std::string, Expected> before;
+        for (const auto& [id, s] : specs) before[id] = expected(s, today);
+        bool matured = false;
+
+        for (int day = 0; day < 500; ++day) {
+            today += 1;
+            const ScheduleBookChanges changes = book.roll(today);
+            const std::string tag = Date(today).get_date_str();
+            check.expect(changes.regenerated == 0 && changes.calendars.empty(), tag + " nothing regenerated");
+            const auto reported = by_id(changes);
+            for (const auto& [id, s] : specs) {
+                const Expected now = expected(s, today);
+                const Expected& was = before[id];
+                const std::size_t paid = was.rows.size() - now.rows.size();
+                const std::size_t still_fixed = was.fixed - std::min(was.fixed, paid);
+                const auto it = reported.find(id);
+                if (paid == 0 && now.fixed == still_fixed) {
+                    check.expect(it == reported.end(), tag + " " + id + " unchanged but reported");
+                } else {
+                    const bool ok = it != reported.end() && it->second.kind == ScheduleChange::Kind::Rolled &&
+                                    it->second.paid == paid && it->second.newly_fixed == now.fixed - still_fixed &&
+                                    it->second.live == now.rows.size();
+                    check.expect(ok, tag + " " + id + " report");
+                    matured = matured || now.rows.empty();
+                }
+                check.expect(matches(book.trade(id), now), tag + " " + id + " rows");
+                before[id] = now;
+            }
+        }
+        check.expect(matured, "a trade matured in the window");
+        report(check);
+    }
+
+    {
+        Checker check{"Term changes"};
+        const std::string id = "IRS-105";
+        check.expect(!book.upsert(id, specs[id]), "same terms");
+        // Same terms spelt differently (the registry normalises names), then a roll that has to find its calendars
+        ScheduleSpec respelt = specs[id];
+        respelt.holiday_convention = " " + respelt.holiday_convention + " ";
+        respelt.payment_holiday_convention = "usgs";
+        check.expect(!book.upsert(id, respelt), "same terms, different spelling");
+        check.expect(book.roll(today).regenerated == 0, "roll after a respelt upsert");
+        ScheduleSpec longer = specs[id];
+        longer.end_date = Date(QuantLib::Date(15, QuantLib::June, 2035));
+        check.expect(book.upsert(id, longer), "new end date");
+        specs[id] = longer;
+
+        ScheduleSpec fresh = specs["IRS-101"];
+        fresh.start_date = Date(QuantLib::Date(1, QuantLib::March, 2026));
+        check.expect(book.upsert("IRS-999", fresh), "new trade");
+        specs["IRS-999"] = fresh;
+
+        const ScheduleBookChanges changes = book.roll(today);
+        const auto reported = by_id(changes);
+        check.expect(changes.regenerated == 2 && reported.size() == 2, "only the two trades regenerated");
+        check.expect(reported.count(id) && reported.at(id).kind == ScheduleChange::Kind::TermsChanged, "terms changed");
+        check.expect(reported.count("IRS-999") && reported.at("IRS-999").kind == ScheduleChange::Kind::Added, "added");
+        check_book(check, "after term changes");
+        report(check);
+    }
+
+    {
+        Checker check{"Calendar changes"};
+        // A holiday on the last payment date of a live trade on the USGS calendar
+        std::string target;
+        for (const auto& [id, s] : specs)
+            if (target.empty() && s.holiday_convention == "USGS" && !book.trade(id).rows.empty()) target = id;
+        const QuantLib::Date holiday = book.trade(target).rows.back().paymentDate;
+        QuantLib::Calendar usgs = conventions().calendar("USGS");
+        usgs.addHoliday(holiday);
+
+        std::map<std::string, Expected> before;
+        for (const auto& [id, s] : specs) before[id] = Expected{book.trade(id).rows, book.trade(id).fixed};
+        ScheduleBookChanges changes = book.roll(today);
+        check.expect(changes.calendars == std::vector<std::string>{usgs.name()}, "USGS changed");
+        check.expect(changes.regenerated > 0 && changes.regenerated < specs.size(), "only trades over that year");
+        const auto reported = by_id(changes);
+        for (const auto& [id, s] : specs) {
+            const bool moved = !matches(book.trade(id), before[id]);
+            check.expect(moved == (reported.count(id) != 0), id + " reported iff its rows moved");
+            check.expect(!moved || reported.at(id).kind == ScheduleChange::Kind::CalendarChanged, id + " kind");
+        }
+        check.expect(reported.count(target) != 0, "the trade paying on the new holiday");
+        check_book(check, "after the holiday");
+
+        usgs.removeHoliday(holiday);
+        changes = book.roll(today);
+        check.expect(changes.calendars == std::vector<std::string>{usgs.name()} && !changes.trades.empty(), "undone");
+        check_book(check, "after undoing it");
+        check.expect(book.roll(today).calendars.empty(), "settled");
+        report(check);
+    }
+
+    {
+        Checker check{"Removals"};
+        check.expect(book.remove("IRS-110"), "remove a trade");
+        check.expect(!book.remove("IRS-110"), "remove it again");
+        ScheduleSpec unseen = specs["IRS-111"];
+        book.upsert("IRS-888", unseen);
+        book.remove("IRS-888");
+        specs.erase("IRS-110");
+
+        const ScheduleBookChanges changes = book.roll(today);
+        check.expect(changes.trades.size() == 1 && changes.trades[0].trade_id == "IRS-110" &&
+                         changes.trades[0].kind == ScheduleChange::Kind::Removed,
+                     "only the rolled trade is reported");
+        check.expect(book.size() == specs.size() && !book.contains("IRS-110"), "size");
+        check_book(check, "after removals");
+        check.expect_throws<std::out_of_range>([&] { book.trade("IRS-110"); }, "removed trade");
+        check.expect_throws<std::invalid_argument>([&] { book.roll(today - 1); }, "rolling backwards");
+        ScheduleSpec bad = unseen;
+        bad.holiday_convention = "NOT-A-CALENDAR";
+        check.expect_throws<std::invalid_argument>([&] { book.upsert("IRS-777", bad); }, "unknown calendar");
+        check.expect(!book.contains("IRS-777"), "nothing added");
+        report(check);
+    }
+
+    return report.finish();
+}
@@ -0,0 +1,167 @@
+#include <iostream>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/schedulecache.h"
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/utils/threadpool.h"
+#include "fixedincomelib/tests/checker.h"
+
+// ScheduleEngine and ThreadPool checks: a mixed book generated on one and on several threads (with and without a
+// cache) matches make_schedule trade for trade, parallel_for runs every item exactly once, and errors thrown by a
+// body, including a nested parallel_for on the same pool, come back out of parallel_for. A long-lived engine follows
+// a holiday change made through the registry
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+    using test::same;
+
+    std::vector<ScheduleRow> reference(const ScheduleSpec& s) {
+        ConventionRegistry& c = conventions();
+        return make_schedule(s.start_date, s.end_date, s.accrual_period, c.calendar(s.holiday_convention),
+                             c.bdc(s.business_day_convention), c.day_counter(s.accrual_basis), s.rule, s.end_of_month,
+                             s.fix_in_arrear, s.fixing_offset, s.payment_offset,
+                             c.bdc(s.payment_business_day_convention), c.calendar(s.payment_holiday_convention));
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== ScheduleEngine and ThreadPool ===\n";
+
+    Report report;
+
+    // 1M to 1Y over 1Y to 30Y on several calendars, both rules, with and without offsets; every fifth trade repeats
+    // an earlier one so the cache gets hits
+    std::vector<ScheduleSpec> specs;
+    const char* calendars[] = {"USGS", "LON", "TARGET", "NYC+LON"};
+    for (int i = 0; i < 600; ++i) {
+        if (i % 5 == 4) {
+            specs.push_back(specs[static_cast<std::size_t>(i / 2)]);
+            continue;
+        }
+        ScheduleSpec s;
+        const int months = i % 4 == 0 ? 1 : i % 4 == 1 ? 3 : i % 4 == 2 ? 6 : 12;
+        s.start_date = Date(QuantLib::Date(1 + i % 28, QuantLib::Month(1 + i % 12), 2020 + i % 10));
+        s.end_date = Date(s.start_date.get_date() + QuantLib::Period(1 + i % 30, QuantLib::Years));
+        s.accrual_period = QuantLib::Period(months, QuantLib::Months);
+        s.holiday_convention = calendars[i % 4];
+        s.business_day_convention = i % 3 == 0 ? "F" : "MF";
+        s.accrual_basis = i % 2 == 0 ? "ACT/360" : "ACT/365";
+        s.rule = i % 7 == 0 ? "FORWARD" : "BACKWARD";
+        s.fix_in_arrear = i % 3 == 1;
+        s.fixing_offset = QuantLib::Period(i % 2 == 0 ? -2 : 0, QuantLib::Days);
+        s.payment_offset = QuantLib::Period(i % 3 == 0 ? 2 : 0, QuantLib::Days);
+        s.payment_holiday_convention = calendars[(i + 1) % 4];
+        specs.push_back(s);
+    }
+    std::vector<std::vector<ScheduleRow>> want;
+    for (const ScheduleSpec& s : specs) want.push_back(reference(s));
+
+    {
+        Checker check{"ScheduleEngine"};
+        for (unsigned threads : {1u, 4u}) {
+            for (bool cached : {false, true}) {
+                ScheduleCache cache(256, 4);
+                ScheduleEngine engine(threads, cached ? &cache : nullptr);
+                const std::string tag = std::to_string(threads) + " threads" + (cached ? ", cached" : "");
+                check.expect(engine.threads() == threads, tag + " worker count");
+                // Twice, so the second run goes through warmed-up per-worker conventions (and cache entries)
+                for (int run = 0; run < 2; ++run) {
+                    const std::vector<std::vector<ScheduleRow>> got = engine.generate(specs);
+                    check.expect(got.size() == specs.size(), tag + " one schedule per trade");
+                    for (std::size_t i = 0; i < got.size() && i < want.size(); ++i)
+                        check.expect(same(got[i], want[i]), tag + " trade " + std::to_string(i));
+                }
+                if (cached) check.expect(cache.stats().hits > 0, tag + " cache hits");
+            }
+        }
+        ScheduleEngine engine(2);
+        check.expect(engine.generate({}).empty(), "empty book");
+
+        // Workers that already hold calendars have to pick up a holiday change on the next run
+        engine.generate(specs);
+        const QuantLib::Date paid = want[0].front().paymentDate;
+        const std::string pay_cal = specs[0].payment_holiday_convention;
+        for (bool holiday : {true, false}) {
+            if (holiday)
+                conventions().add_holiday(pay_cal, paid);
+            else
+                conventions().remove_holiday(pay_cal, paid);
+            const std::vector<std::vector<ScheduleRow>> got = engine.generate(specs);
+            const std::string tag = holiday ? "after a holiday is added" : "after it is removed";
+            check.expect((got[0].front().paymentDate != paid) == holiday, tag + ", first payment");
+            bool equal = true;
+            for (std::size_t i = 0; equal && i < specs.size(); ++i) equal = same(got[i], reference(specs[i]));
+            check.expect(equal, tag + ", whole book");
+        }
+
+        std::vector<ScheduleSpec> bad = {specs[0], specs[1]};
+        bad[1].holiday_convention = "NOT-A-CALENDAR";
+        check.expect_throws([&] { engine.generate(bad); }, "unknown calendar");
+        report(check);
+    }
+
+    {
+        Checker check{"ThreadPool"};
+        ThreadPool pool(4);
+        for (std::size_t n : {0, 1, 7, 1000}) {
+            for (std::size_t grain : {0, 1, 3, 64, 5000}) {
+                std::vector<std::atomic<int>> seen(n);
+                std::atomic<bool> bad_worker = false;
+                pool.parallel_for(n, grain, [&](std::size_t begin, std::size_t end, unsigned worker) {
+                    if (worker >= pool.size() || begin >= end || end > n) bad_worker = true;
+                    for (std::size_t i = begin; i < end && i < n; ++i) seen[i].fetch_add(1);
+                });
+                bool once = true;
+                for (const std::atomic<int>& s : seen) once = once && s.load() == 1;
+                const std::string tag = "n=" + std::to_string(n) + " grain=" + std::to_string(grain);
+                check.expect(once, tag + " every item exactly once");
+                check.expect(!bad_worker, tag + " chunk bounds and worker ids");
+            }
+        }
+
+        // The first error comes back out, every worker still leaves the generation, and the pool keeps working
+        std::atomic<int> ran = 0;
+        check.expect_throws<std::runtime_error>([&] {
+            pool.parallel_for(100, 1, [&](std::size_t begin, std::size_t, unsigned) {
+                ran.fetch_add(1);
+                if (begin % 10 == 3) throw std::runtime_error("chunk " + std::to_string(begin));
+            });
+        }, "a throwing body");
+        check.expect(ran.load() == 100, "the other chunks still ran");
+        std::atomic<std::size_t> sum = 0;
+        pool.parallel_for(100, 7, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t i = begin; i < end; ++i) sum.fetch_add(i);
+        });
+        check.expect(sum.load() == 4950, "usable after an error");
+
+        // A nested call on the same pool would deadlock, so it throws; another pool is fine
+        check.expect_throws<std::logic_error>([&] {
+            pool.parallel_for(4, 1, [&](std::size_t, std::size_t, unsigned) {
+                pool.parallel_for(2, 1, [](std::size_t, std::size_t, unsigned) {});
+            });
+        }, "nested parallel_for on the same pool");
+        ThreadPool inner(2);
+        std::atomic<int> inner_items = 0;
+        pool.parallel_for(4, 1, [&](std::size_t, std::size_t, unsigned) {
+            inner.parallel_for(3, 1, [&](std::size_t begin, std::size_t end, unsigned) {
+                inner_items.fetch_add(static_cast<int>(end - begin));
+            });
+        });
+        check.expect(inner_items.load() == 12, "parallel_for on another pool from a worker");
+        report(check);
+    }
+
+    return report.finish();
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/schedulefile.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/tests/checker.h"
+
+// Schedule file checks: schedules written through the streaming writer read back field for field from the map (across
+// block boundaries, with a trade larger than a block and an empty one), and damaged files are refused
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+    using test::same;
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== Schedule file ===\n";
+
+    Report report;
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string path = (dir / "fixedincomelib_testschedulefile.sched").string();
+
+    // Monthly to annual, 1Y to 30Y, fixing in advance and in arrears with offsets; trade 7 has no rows and the
+    // 30Y monthly ones (360 rows) don't fit a 200-row block
+    std::vector<std::vector<ScheduleRow>> schedules;
+    std::vector<std::string> ids;
+    for (int i = 0; i < 120; ++i) {
+        const int months = i % 4 == 0 ? 1 : i % 4 == 1 ? 3 : i % 4 == 2 ? 6 : 12;
+        const bool arrears = i % 3 == 0;
+        schedules.push_back(i == 7 ? std::vector<ScheduleRow>{}
+                                   : make_schedule(Date("17-03-2025"),
+                                                   Date(QuantLib::Date(17, QuantLib::March, 2026 + i % 30)),
+                                                   QuantLib::Period(months, QuantLib::Months),
+                                                   conventions().calendar("USGS"), QuantLib::ModifiedFollowing,
+                                                   conventions().day_counter("ACT/360"), "BACKWARD", false, arrears,
+                                                   QuantLib::Period(arrears ? -2 : -5, QuantLib::Days),
+                                                   QuantLib::Period(2, QuantLib::Days)));
+        ids.push_back(i % 5 == 0 ? "" : "TRADE-" + std::to_string(1000 + i));
+    }
+
+    {
+        Checker check{"Round trip"};
+        std::size_t rows = 0;
+        {
+            ScheduleFileWriter writer(path, 200);
+            for (std::size_t t = 0; t < schedules.size(); ++t) {
+                writer.append(ids[t], schedules[t]);
+                rows += schedules[t].size();
+            }
+            check.expect(writer.trade_count() == schedules.size() && writer.row_count() == rows, "writer counts");
+            writer.close();
+            check.expect_throws<std::logic_error>([&] { writer.append("late", schedules[0]); }, "append after close");
+        }
+
+        const ScheduleFile file(path);
+        check.expect(file.trade_count() == schedules.size() && file.row_count() == rows, "reader counts");
+        check.expect(file.block_count() > 1, "several blocks");
+        // Backwards, so nothing depends on reading in order
+        for (std::size_t t = schedules.size(); t-- > 0;) {
+            const std::string tag = "trade " + std::to_string(t);
+            check.expect(file.trade_id(t) == ids[t], tag + " id");
+            const ScheduleColumns c = file.trade(t);
+            bool equal = c.size() == schedules[t].size();
+            for (std::size_t i = 0; equal && i < c.size(); ++i) equal = same(c.row(i), schedules[t][i]);
+            check.expect(equal, tag + " rows");
+            check.expect(c.size() == 0 || c.payment_dates[0] == schedules[t][0].paymentDate.serialNumber(),
+                         tag + " payment column");
+            const std::vector<ScheduleRow> copied = file.trade_rows(t);
+            check.expect(copied.size() == schedules[t].size() &&
+                             (copied.empty() || same(copied.back(), schedules[t].back())),
+                         tag + " trade_rows");
+        }
+        check.expect_throws<std::out_of_range>([&] { file.trade(schedules.size()); }, "trade past the end");
+
+        // An empty file still opens, and the destructor closes a writer that wasn't closed
+        const std::string empty = (dir / "fixedincomelib_testschedulefile_empty.sched").string();
+        { ScheduleFileWriter writer(empty); }
+        check.expect(ScheduleFile(empty).trade_count() == 0, "empty file");
+        std::filesystem::remove(empty);
+        report(check);
+    }
+
+    {
+        Checker check{"Damaged files"};
+        const std::string bad = (dir / "fixedincomelib_testschedulefile_bad.sched").string();
+        const auto size = std::filesystem::file_size(path);
+        std::filesystem::copy_file(path, bad, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(bad, size - 10);
+        check.expect_throws<std::runtime_error>([&] { ScheduleFile file(bad); }, "truncated file");
+
+        std::filesystem::copy_file(path, bad, std::filesystem::copy_options::overwrite_existing);
+        {
+            std::fstream f(bad, std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp(8);
+            f.put(2);
+        }
+        check.expect_throws<std::runtime_error>([&] { ScheduleFile file(bad); }, "another version");
+
+        std::ofstream(bad, std::ios::binary | std::ios::trunc) << "StartDate,EndDate,FixingDate,PaymentDate,Accrued\n";
+        check.expect_throws<std::runtime_error>([&] { ScheduleFile file(bad); }, "a CSV file");
+        check.expect_throws<std::invalid_argument>([&] { ScheduleFileWriter writer(bad, 0); }, "zero block size");
+        std::filesystem::remove(bad);
+        report(check);
+    }
+    std::filesystem::remove(path);
+
+    return report.finish();
+}
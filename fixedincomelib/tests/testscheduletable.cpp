@@ -0,0 +1,138 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/scheduleengine.h"
+#include "fixedincomelib/Date/scheduletable.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/registry.h"
+#include "fixedincomelib/tests/checker.h"
+
+// ScheduleTable checks: schedules read back row for row and column by column, generate_table agrees with generate,
+// dates outside the 16-bit range are refused without touching the table, and the columns take at most half the
+// memory of per-trade row vectors
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+    using test::same;
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== ScheduleTable ===\n";
+
+    Report report;
+
+    // Monthly to annual, 1Y to 30Y, with fixing and payment offsets
+    std::vector<ScheduleSpec> specs;
+    for (int i = 0; i < 200; ++i) {
+        ScheduleSpec s;
+        const int months = i % 4 == 0 ? 1 : i % 4 == 1 ? 3 : i % 4 == 2 ? 6 : 12;
+        s.start_date = Date(QuantLib::Date(1 + i % 28, QuantLib::Month(1 + i % 12), 2020 + i % 8));
+        s.end_date = Date(s.start_date.get_date() + QuantLib::Period(1 + i % 30, QuantLib::Years));
+        s.accrual_period = QuantLib::Period(months, QuantLib::Months);
+        s.holiday_convention = i % 2 == 0 ? "USGS" : "LON";
+        s.business_day_convention = "MF";
+        s.accrual_basis = "ACT/360";
+        s.fix_in_arrear = i % 3 == 0;
+        s.fixing_offset = QuantLib::Period(-2, QuantLib::Days);
+        s.payment_offset = QuantLib::Period(2, QuantLib::Days);
+        specs.push_back(s);
+    }
+    ScheduleEngine engine(1);
+    const std::vector<std::vector<ScheduleRow>> schedules = engine.generate(specs);
+    std::size_t rows = 0;
+    for (const auto& s : schedules) rows += s.size();
+
+    {
+        Checker check{"Round trip"};
+        ScheduleTable table;
+        for (const auto& s : schedules) table.append(s);
+        check.expect(table.trade_count() == schedules.size() && table.row_count() == rows, "counts");
+        check.expect(table.trade_offsets().size() == schedules.size() + 1 && table.trade_offsets().front() == 0 &&
+                         table.trade_offsets().back() == rows,
+                     "trade offsets");
+
+        std::vector<serial_type> payments(rows);
+        table.decode(table.payment_dates(), payments);
+        std::vector<serial_type> short_buffer(rows - 1);
+        check.expect_throws([&] { table.decode(table.payment_dates(), short_buffer); }, "decode into a short buffer");
+        for (std::size_t t = 0; t < schedules.size(); ++t) {
+            check.expect(same(table.trade_rows(t), schedules[t]), "trade " + std::to_string(t) + " rows");
+            for (std::size_t i = 0; i < schedules[t].size(); ++i) {
+                const std::size_t r = table.trade_begin(t) + i;
+                check.expect(payments[r] == schedules[t][i].paymentDate.serialNumber() &&
+                                 table.accrued()[r] == schedules[t][i].accrued &&
+                                 table.to_date(table.start_dates()[r]) == schedules[t][i].startDate,
+                             "trade " + std::to_string(t) + " columns");
+            }
+        }
+
+        const ScheduleTable generated = engine.generate_table(specs);
+        bool equal = generated.trade_count() == schedules.size();
+        for (std::size_t t = 0; equal && t < schedules.size(); ++t) equal = same(generated.trade_rows(t), schedules[t]);
+        check.expect(equal, "generate_table agrees with generate");
+
+        table.clear();
+        check.expect(table.trade_count() == 0 && table.row_count() == 0, "clear");
+        report(check);
+    }
+
+    {
+        Checker check{"Encoding range"};
+        // A recent epoch so both ends of the 16-bit range are easy to reach
+        const QuantLib::Date epoch(1, QuantLib::January, 2020);
+        ScheduleTable table(epoch);
+        table.append(schedules[1]);
+        const std::size_t before = table.row_count();
+
+        const QuantLib::Date last = epoch + 65535;
+        std::vector<ScheduleRow> edge = {ScheduleRow{epoch, last, epoch, last, 1.0}};
+        table.append(edge);
+        check.expect(table.row(before).startDate == epoch && table.row(before).paymentDate == last, "both ends fit");
+
+        // The bad date is in the last row, after earlier rows of the same trade were already appended
+        std::vector<ScheduleRow> late = schedules[2];
+        late.back().paymentDate = last + 1;
+        check.expect_throws<std::out_of_range>([&] { table.append(late); }, "a date past the range");
+        std::vector<ScheduleRow> early = schedules[3];
+        early.front().fixingDate = epoch - 1;
+        check.expect_throws<std::out_of_range>([&] { table.append(early); }, "a date before the epoch");
+
+        check.expect(table.trade_count() == 2 && table.row_count() == before + 1, "failed appends leave no rows");
+        check.expect(table.start_dates().size() == table.row_count() &&
+                         table.payment_dates().size() == table.row_count() &&
+                         table.accrued().size() == table.row_count(),
+                     "columns cut back");
+        table.append(schedules[4]);
+        check.expect(table.trade_count() == 3 && same(table.trade_rows(2), schedules[4]), "usable afterwards");
+        table.append({});
+        check.expect(table.trade_count() == 4 && table.trade_begin(3) == table.trade_end(3), "empty trade");
+        report(check);
+    }
+
+    {
+        Checker check{"Footprint"};
+        // Sized exactly, so capacity is the footprint of the representation itself
+        ScheduleTable table;
+        table.reserve(schedules.size(), rows);
+        for (const auto& s : schedules) table.append(s);
+        std::size_t aos_bytes = schedules.size() * sizeof(std::vector<ScheduleRow>);
+        for (const auto& s : schedules) aos_bytes += s.size() * sizeof(ScheduleRow);
+        check.expect(table.memory_bytes() == rows * ScheduleTable::bytes_per_row + (schedules.size() + 1) * 4,
+                     "16 bytes a row plus 4 a trade");
+        check.expect(2 * table.memory_bytes() <= aos_bytes,
+                     "at least 2x smaller: " + std::to_string(table.memory_bytes()) + " against " +
+                         std::to_string(aos_bytes) + " bytes");
+        report(check);
+    }
+
+    return report.finish();
+}
@@ -0,0 +1,237 @@
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/Model/scenarioengine.h"
+#include "fixedincomelib/Model/swappricer.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+#include "fixedincomelib/utils/threadpool.h"
+#include "fixedincomelib/tests/checker.h"
+
+// Swap pricing checks: legs against hand-summed cashflows, the single-curve float leg telescoping to
+// DF(start) - DF(end), the par rate zeroing the swap, the batch portfolio agreeing exactly with leg-by-leg pricing,
+// and the scenario engine agreeing with the portfolio repriced scenario by scenario
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+
+    const QuantLib::Date reference(15, QuantLib::January, 2025);
+
+    YieldCurve flat_ish_curve(double level, double slope) {
+        std::vector<serial_type> pillars;
+        std::vector<double> dfs;
+        for (int m : {1, 3, 6, 12, 24, 36, 60, 84, 120, 180, 240, 360}) {
+            const QuantLib::Date d = reference + QuantLib::Period(m, QuantLib::Months);
+            pillars.push_back(d.serialNumber());
+            dfs.push_back(std::exp(-(level + slope * m / 12.0) * (d - reference) / 365.0));
+        }
+        return YieldCurve(reference, pillars, dfs, CurveInterpolation::MonotoneConvex);
+    }
+
+    std::vector<ScheduleRow> schedule(const char* start, const char* end, int months,
+                                      const QuantLib::Period& payment_offset = QuantLib::Period(0, QuantLib::Days)) {
+        return make_schedule(Date(start), Date(end), QuantLib::Period(months, QuantLib::Months),
+                             calendar_from_string("USGS"), QuantLib::ModifiedFollowing,
+                             accrualbasis_from_string("ACT/360"), "BACKWARD", false, false,
+                             QuantLib::Period(0, QuantLib::Days), payment_offset);
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== Swap pricing ===\n";
+
+    Report report;
+
+    const YieldCurve ois = flat_ish_curve(0.040, 0.0004);
+    const YieldCurve libor = flat_ish_curve(0.043, 0.0005);
+    const QuantLib::Period two_days(2, QuantLib::Days);
+    const std::vector<ScheduleRow> annual = schedule("17-01-2025", "17-01-2035", 12, two_days);
+    const std::vector<ScheduleRow> quarterly = schedule("17-01-2025", "17-01-2035", 3, two_days);
+
+    {
+        Checker check{"Legs"};
+        const SwapLeg fixed{SwapLeg::Type::Fixed, annual, 1e7, 0.041};
+        double want_pv = 0.0, want_annuity = 0.0;
+        for (const ScheduleRow& row : annual) {
+            want_pv += 1e7 * 0.041 * row.accrued * ois.discount(row.paymentDate);
+            want_annuity += 1e7 * row.accrued * ois.discount(row.paymentDate);
+        }
+        const LegValue v = price_leg(fixed, ois);
+        check.expect_near(v.pv, want_pv, 1e-8, "fixed leg PV");
+        check.expect_near(v.annuity, want_annuity, 1e-7, "fixed leg annuity");
+
+        const SwapLeg floating{SwapLeg::Type::Float, quarterly, -1e7, 0.0015};
+        double want_float = 0.0;
+        for (const ScheduleRow& row : quarterly) {
+            const double forward = (libor.discount(row.startDate) / libor.discount(row.endDate) - 1.0) / row.accrued;
+            want_float += -1e7 * (forward + 0.0015) * row.accrued * ois.discount(row.paymentDate);
+        }
+        check.expect_near(price_leg(floating, ois, &libor).pv, want_float, 1e-7, "float leg PV");
+
+        // One curve, paid on the accrual end dates: the float leg is worth DF(first start) - DF(last end)
+        const std::vector<ScheduleRow> no_lag = schedule("17-01-2025", "17-01-2035", 3);
+        const SwapLeg single{SwapLeg::Type::Float, no_lag, 1.0, 0.0};
+        check.expect_near(price_leg(single, ois, &ois).pv,
+                          ois.discount(no_lag.front().startDate) - ois.discount(no_lag.back().endDate), 1e-14,
+                          "single-curve float leg telescopes");
+
+        check.expect_throws([&] { price_leg(floating, ois); }, "float leg without a projection curve");
+        report(check);
+    }
+
+    {
+        Checker check{"Swaps"};
+        const SwapLeg floating{SwapLeg::Type::Float, quarterly, -1e7, 0.0};
+        const SwapValue off_market =
+            price_swap(SwapLeg{SwapLeg::Type::Fixed, annual, 1e7, 0.03}, floating, ois, libor);
+        const SwapValue at_par =
+            price_swap(SwapLeg{SwapLeg::Type::Fixed, annual, 1e7, off_market.par_rate}, floating, ois, libor);
+        check.expect_near(at_par.pv, 0.0, 1e-7, "PV at the par rate");
+        check.expect_near(at_par.par_rate, off_market.par_rate, 1e-16, "par rate doesn't depend on the fixed rate");
+        check.expect(off_market.pv < 0.0, "receiving 3% below par is worth less than nothing");
+        check.expect(off_market.par_rate > 0.043 && off_market.par_rate < 0.05, "par rate in a sensible range");
+        check.expect_throws([&] { price_swap(floating, floating, ois, libor); }, "two float legs");
+        report(check);
+    }
+
+    {
+        Checker check{"LegPortfolio"};
+        // Curves 0 (OIS) and 1 (3M); fixed legs group by discount curve only, float legs by both
+        const std::vector<ScheduleRow> semi = schedule("20-03-2025", "20-03-2032", 6);
+        const std::vector<ScheduleRow> monthly = schedule("20-03-2025", "20-03-2027", 1);
+        std::vector<SwapLeg> legs;
+        std::vector<std::pair<std::size_t, std::size_t>> curve_ids;
+        for (int i = 0; i < 40; ++i) {
+            const std::vector<ScheduleRow>& rows = i % 3 == 0 ? annual : i % 3 == 1 ? semi : quarterly;
+            const bool floating = i % 2 == 1;
+            legs.push_back(SwapLeg{floating ? SwapLeg::Type::Float : SwapLeg::Type::Fixed, rows,
+                                   (i % 4 < 2 ? 1.0 : -1.0) * 1e6 * (1 + i), floating ? 0.001 * (i % 5) : 0.035});
+            curve_ids.emplace_back(0, floating ? (i % 4 == 1 ? 1 : 0) : 1);
+        }
+        legs.push_back(SwapLeg{SwapLeg::Type::Float, monthly, 5e6, 0.0});
+        curve_ids.emplace_back(0, 0);
+
+        LegPortfolio portfolio;
+        std::size_t cashflows = 0;
+        for (std::size_t i = 0; i < legs.size(); ++i) {
+            check.expect(portfolio.add(legs[i], curve_ids[i].first, curve_ids[i].second) == i, "leg index");
+            cashflows += legs[i].rows.size();
+        }
+        check.expect(portfolio.size() == legs.size() && portfolio.cashflow_count() == cashflows, "sizes");
+        check.expect(portfolio.group_count() == 3, "groups: fixed on OIS, float on 3M, float on OIS");
+
+        const YieldCurve* curves[] = {&ois, &libor};
+        std::vector<LegValue> values(portfolio.size());
+        portfolio.price(curves, values);
+        for (std::size_t i = 0; i < legs.size(); ++i) {
+            const LegValue want = price_leg(legs[i], ois, curve_ids[i].second == 1 ? &libor : &ois);
+            check.expect(values[i].pv == want.pv && values[i].annuity == want.annuity,
+                         "leg " + std::to_string(i) + " same as price_leg");
+        }
+
+        // The same book on other curves without rebuilding it
+        const YieldCurve bumped = flat_ish_curve(0.041, 0.0004);
+        const YieldCurve* bumped_curves[] = {&bumped, &libor};
+        portfolio.price(bumped_curves, values);
+        check.expect(values[0].pv == price_leg(legs[0], bumped).pv, "repriced on a new discount curve");
+
+        check.expect_throws([&] { portfolio.price(std::span<const YieldCurve* const>(curves, 1), values); },
+                            "missing curve");
+        check.expect_throws([&] { portfolio.price(curves, std::span<LegValue>(values).first(3)); }, "short output");
+        check.expect_throws([&] { portfolio.add(legs[1], 0); }, "float leg without a projection curve");
+        report(check);
+    }
+
+    {
+        Checker check{"ScenarioEngine"};
+        // Swaps and single legs on OIS and 3M; trade 5 never gets a leg
+        ScenarioEngine engine;
+        const std::vector<ScheduleRow> semi = schedule("20-03-2025", "20-03-2032", 6);
+        for (std::size_t t = 0; t < 30; ++t) {
+            if (t == 5) continue;
+            const double notional = (t % 2 == 0 ? 1.0 : -1.0) * 1e6 * static_cast<double>(t + 1);
+            if (t % 3 != 2) engine.add(t, SwapLeg{SwapLeg::Type::Fixed, t % 2 ? annual : semi, notional, 0.04}, 0);
+            if (t % 3 != 1)
+                engine.add(t, SwapLeg{SwapLeg::Type::Float, quarterly, -notional, 0.0005 * (t % 4)}, 0, t % 4 ? 1 : 0);
+        }
+        check.expect(engine.trade_count() == 30, "trade count");
+
+        // 37 scenarios of parallel and twist moves, so blocks come out uneven
+        std::vector<YieldCurve> scenario_curves;
+        for (int s = 0; s < 37; ++s) {
+            const double shift = 0.0005 * (s - 18);
+            scenario_curves.push_back(flat_ish_curve(0.040 + shift, 0.0004 - shift / 20));
+            scenario_curves.push_back(flat_ish_curve(0.043 + shift, 0.0005 + shift / 20));
+        }
+        std::vector<const YieldCurve*> curve_sets;
+        for (const YieldCurve& c : scenario_curves) curve_sets.push_back(&c);
+
+        std::vector<LegValue> values(engine.legs().size());
+        std::vector<std::vector<double>> want(37, std::vector<double>(30, 0.0));
+        std::vector<std::size_t> leg_trade;
+        for (std::size_t t = 0; t < 30; ++t) {
+            if (t == 5) continue;
+            if (t % 3 != 2) leg_trade.push_back(t);
+            if (t % 3 != 1) leg_trade.push_back(t);
+        }
+        for (std::size_t s = 0; s < 37; ++s) {
+            engine.legs().price(std::span<const YieldCurve* const>(curve_sets).subspan(2 * s, 2), values);
+            for (std::size_t i = 0; i < values.size(); ++i) want[s][leg_trade[i]] += values[i].pv;
+        }
+
+        for (unsigned threads : {1u, 3u}) {
+            ThreadPool pool(threads);
+            const ScenarioPvs pvs = engine.price(curve_sets, 2, pool);
+            check.expect(pvs.scenarios == 37 && pvs.trades == 30, "matrix shape");
+            for (std::size_t s = 0; s < 37; ++s)
+                for (std::size_t t = 0; t < 30; ++t)
+                    check.expect_near(pvs(s, t), want[s][t], 1e-6,
+                                      std::to_string(threads) + " threads, scenario " + std::to_string(s) +
+                                          " trade " + std::to_string(t));
+            check.expect(pvs(0, 5) == 0.0 && pvs.scenario(36).size() == 30, "trade without legs");
+        }
+
+        ThreadPool pool(2);
+        check.expect_throws([&] { engine.price(std::span<const YieldCurve* const>(curve_sets).first(5), 2, pool); },
+                            "partial curve set");
+        check.expect_throws([&] { engine.price(curve_sets, 1, pool); }, "curve id past the set");
+        curve_sets[2 * 20 + 1] = nullptr;
+        check.expect_throws([&] { engine.price(curve_sets, 2, pool); }, "null scenario curve");
+
+        // A projection curve that starts after the discount curve's payment dates is only read at its own legs' dates
+        ScenarioEngine late;
+        const std::vector<ScheduleRow> forward = schedule("17-01-2027", "17-01-2032", 3);
+        late.add(0, SwapLeg{SwapLeg::Type::Fixed, annual, 1e6, 0.04}, 0);
+        late.add(1, SwapLeg{SwapLeg::Type::Float, forward, -1e6, 0.0}, 0, 1);
+        const QuantLib::Date later = reference + QuantLib::Period(2, QuantLib::Years);
+        std::vector<serial_type> pillars;
+        std::vector<double> dfs;
+        for (int y = 1; y <= 10; ++y) {
+            pillars.push_back((later + QuantLib::Period(y, QuantLib::Years)).serialNumber());
+            dfs.push_back(std::exp(-0.045 * y));
+        }
+        const YieldCurve forward_curve(later, pillars, dfs, CurveInterpolation::MonotoneConvex);
+        const std::vector<const YieldCurve*> late_curves = {&ois, &forward_curve};
+        const ScenarioPvs late_pvs = late.price(late_curves, 2, pool);
+        std::vector<LegValue> late_values(2);
+        late.legs().price(late_curves, late_values);
+        check.expect_near(late_pvs(0, 0), late_values[0].pv, 1e-6, "curve starting later, fixed leg");
+        check.expect_near(late_pvs(0, 1), late_values[1].pv, 1e-6, "curve starting later, float leg");
+        late.add(2, SwapLeg{SwapLeg::Type::Float, quarterly, 1e6, 0.0}, 0, 1);
+        check.expect_throws([&] { late.price(late_curves, 2, pool); }, "a leg before its projection curve starts");
+        report(check);
+    }
+
+    return report.finish();
+}
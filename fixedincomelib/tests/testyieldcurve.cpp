@@ -0,0 +1,357 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <ql/time/date.hpp>
+#include <ql/time/period.hpp>
+
+#include "fixedincomelib/Date/scheduletable.h"
+#include "fixedincomelib/Date/utilities.h"
+#include "fixedincomelib/market/basics.h"
+#include "fixedincomelib/Model/bootstrap.h"
+#include "fixedincomelib/Model/curvesensitivity.h"
+#include "fixedincomelib/Model/yieldcurve.h"
+#include "fixedincomelib/tests/checker.h"
+
+// YieldCurve checks: pillars are hit exactly, the batch queries agree with the scalar ones whatever order the dates
+// come in, and each interpolation has the shape it promises (flat forwards for log-linear, continuous forwards for
+// monotone convex). CurveBootstrapper checks: every instrument reprices, and a tick only moves the pillars from the
+// ticked one on, to the same curve a full bootstrap gives. Adjoint checks: the tape on a small function, and bucketed
+// DV01 by AAD against central differences on both interpolations.
+
+namespace {
+    using namespace fixedincomelib;
+    using test::Checker;
+    using test::Report;
+
+    const QuantLib::Date reference(15, QuantLib::January, 2025);
+
+    // A humped curve: forwards rise, fall back and rise again, which is where interpolations misbehave
+    YieldCurve make_curve(CurveInterpolation interpolation) {
+        const int months[] = {1, 3, 6, 12, 24, 36, 60, 84, 120, 180, 240, 360};
+        const double zeros[] = {0.043, 0.044, 0.045, 0.043, 0.040, 0.0385, 0.0395, 0.041, 0.042, 0.0435, 0.044, 0.043};
+        std::vector<serial_type> pillars;
+        std::vector<double> dfs;
+        for (std::size_t i = 0; i < std::size(months); ++i) {
+            const QuantLib::Date d = reference + QuantLib::Period(months[i], QuantLib::Months);
+            pillars.push_back(d.serialNumber());
+            dfs.push_back(std::exp(-zeros[i] * (d - reference) / 365.0));
+        }
+        return YieldCurve(reference, pillars, dfs, interpolation, accrualbasis_from_string("ACT/360"));
+    }
+
+    void check_curve(Checker& check, const YieldCurve& curve) {
+        // On the pillars
+        const auto pillars = curve.pillars();
+        const auto log_dfs = curve.log_discount_factors();
+        for (std::size_t i = 0; i < pillars.size(); ++i)
+            check.expect_near(std::log(curve.discount(pillars[i])), log_dfs[i], 1e-14, "pillar " + std::to_string(i));
+        check.expect_near(curve.discount(reference), 1.0, 0.0, "reference date");
+
+        // Batch against scalar, sorted and shuffled, reaching past the last pillar
+        std::vector<serial_type> dates;
+        for (serial_type s = reference.serialNumber(); s < pillars.back() + 2000; s += 7) dates.push_back(s);
+        std::vector<serial_type> shuffled = dates;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+        for (const auto* column : {&dates, &shuffled}) {
+            std::vector<double> batch(column->size());
+            curve.discount(*column, batch);
+            for (std::size_t i = 0; i < column->size(); ++i)
+                check.expect(batch[i] == curve.discount((*column)[i]), "batch discount at " + std::to_string(i));
+        }
+
+        // Positive forwards, so discount factors only go down
+        std::vector<double> dfs(dates.size());
+        curve.discount(dates, dfs);
+        for (std::size_t i = 1; i < dfs.size(); ++i)
+            check.expect(dfs[i] < dfs[i - 1], "discount factors decrease at " + std::to_string(i));
+
+        // Forwards against the discount factors they come from
+        std::vector<serial_type> start, end;
+        for (std::size_t i = 0; i + 13 < dates.size(); i += 5) {
+            start.push_back(dates[i]);
+            end.push_back(dates[i + 13]);
+        }
+        std::vector<double> fwd(start.size());
+        curve.forward(start, end, fwd);
+        for (std::size_t i = 0; i < start.size(); ++i) {
+            const double tau = curve.forward_basis().yearFraction(QuantLib::Date(start[i]), QuantLib::Date(end[i]));
+            const double want = (curve.discount(start[i]) / curve.discount(end[i]) - 1.0) / tau;
+            check.expect_near(fwd[i], want, 1e-12, "forward " + std::to_string(i));
+            check.expect(curve.forward(start[i], end[i]) == fwd[i], "scalar forward " + std::to_string(i));
+        }
+
+        // A leg's payment dates, as rows and through a ScheduleTable
+        const auto leg = make_schedule(Date("20-03-2025"), Date("20-03-2040"), QuantLib::Period(3, QuantLib::Months),
+                                       calendar_from_string("USGS"), QuantLib::ModifiedFollowing,
+                                       accrualbasis_from_string("ACT/360"), "BACKWARD", false, false,
+                                       QuantLib::Period(0, QuantLib::Days), QuantLib::Period(2, QuantLib::Days));
+        std::vector<double> leg_dfs(leg.size());
+        curve.discount_payments(leg, leg_dfs);
+        ScheduleTable table;
+        table.append(leg);
+        table.append(leg);
+        std::vector<double> table_dfs(table.row_count());
+        curve.discount_payments(table, table_dfs);
+        for (std::size_t i = 0; i < leg.size(); ++i) {
+            const double want = curve.discount(leg[i].paymentDate);
+            check.expect(leg_dfs[i] == want, "leg payment " + std::to_string(i));
+            check.expect(table_dfs[i] == want && table_dfs[leg.size() + i] == want,
+                         "table payment " + std::to_string(i));
+        }
+
+        check.expect_throws([&] { curve.discount(reference - 1); }, "date before the reference date");
+        check.expect_throws([&] { curve.forward(dates[3], dates[3]); }, "empty forward period");
+    }
+
+    // Instantaneous forward -d(log DF)/dt at s from the left and from the right: one-day forwards centred half a day
+    // and a day and a half away, extrapolated linearly to s
+    double one_day_forward(const YieldCurve& curve, serial_type s) {
+        return std::log(curve.discount(s) / curve.discount(s + 1)) * 365.0;
+    }
+
+    double left_forward(const YieldCurve& curve, serial_type s) {
+        return 1.5 * one_day_forward(curve, s - 1) - 0.5 * one_day_forward(curve, s - 2);
+    }
+
+    double right_forward(const YieldCurve& curve, serial_type s) {
+        return 1.5 * one_day_forward(curve, s) - 0.5 * one_day_forward(curve, s + 1);
+    }
+
+    std::vector<CurveInstrument> usd_instruments() {
+        std::vector<CurveInstrument> out;
+        for (auto [n, unit, quote] : {std::tuple{1, QuantLib::Months, 0.0431}, {3, QuantLib::Months, 0.0433},
+                                      {6, QuantLib::Months, 0.0428}}) {
+            CurveInstrument d;
+            d.kind = CurveInstrument::Kind::Deposit;
+            d.tenor = QuantLib::Period(n, unit);
+            d.quote = quote;
+            out.push_back(d);
+        }
+        for (auto [years, quote] : {std::pair{1, 0.0415}, {2, 0.0398}, {3, 0.0390}, {5, 0.0388}, {7, 0.0392},
+                                    {10, 0.0401}, {15, 0.0412}, {20, 0.0418}, {30, 0.0410}}) {
+            CurveInstrument s;
+            s.tenor = QuantLib::Period(years, QuantLib::Years);
+            s.quote = quote;
+            out.push_back(s);
+        }
+        return out;
+    }
+
+    // PV per unit notional of instrument i on the curve, zero at its quote when the curve reprices it
+    double instrument_pv(const CurveInstrument& inst, const QuantLib::Date& spot, const YieldCurve& curve) {
+        const QuantLib::Calendar cal = calendar_from_string(inst.calendar);
+        const QuantLib::DayCounter dc = accrualbasis_from_string(inst.accrual_basis);
+        const QuantLib::BusinessDayConvention bdc = bdc_from_string(inst.business_day_convention);
+        if (inst.kind == CurveInstrument::Kind::Deposit) {
+            const QuantLib::Date end = cal.advance(spot, inst.tenor, bdc);
+            return -curve.discount(spot) + (1.0 + inst.quote * dc.yearFraction(spot, end)) * curve.discount(end);
+        }
+        const auto rows = make_schedule(Date(spot), Date(spot + inst.tenor), inst.fixed_frequency, cal, bdc, dc,
+                                        "BACKWARD", false, false, QuantLib::Period(0, QuantLib::Days),
+                                        QuantLib::Period(0, QuantLib::Days), bdc, cal);
+        std::vector<double> dfs(rows.size());
+        curve.discount_payments(rows, dfs);
+        double pv = -curve.discount(spot) + dfs.back();
+        for (std::size_t i = 0; i < rows.size(); ++i) pv += inst.quote * rows[i].accrued * dfs[i];
+        return pv;
+    }
+}
+
+int main() {
+    using namespace fixedincomelib;
+
+    std::cout << "=== YieldCurve ===\n";
+
+    Report report;
+
+    {
+        Checker check{"ModelType"};
+        check.expect(ModelType("yield_curve").value() == ModelType::YIELD_CURVE, "ModelType('yield_curve')");
+        check.expect(make_curve(CurveInterpolation::LogLinearDiscount).model_type() == ModelType::YIELD_CURVE,
+                     "YieldCurve::model_type");
+        report(check);
+    }
+
+    {
+        Checker check{"LogLinearDiscount"};
+        const YieldCurve curve = make_curve(CurveInterpolation::LogLinearDiscount);
+        check_curve(check, curve);
+
+        // Flat forwards between pillars: the discount factor half way is the geometric mean of the two
+        const auto p = curve.pillars();
+        for (std::size_t i = 0; i + 1 < p.size(); ++i) {
+            if ((p[i + 1] - p[i]) % 2 != 0) continue;
+            const double mid = curve.discount(p[i] + (p[i + 1] - p[i]) / 2);
+            check.expect_near(mid, std::sqrt(curve.discount(p[i]) * curve.discount(p[i + 1])), 1e-15,
+                              "geometric mean in segment " + std::to_string(i));
+        }
+        report(check);
+    }
+
+    {
+        Checker check{"MonotoneConvex"};
+        const YieldCurve curve = make_curve(CurveInterpolation::MonotoneConvex);
+        check_curve(check, curve);
+
+        // Continuous forwards across each pillar
+        for (serial_type s : curve.pillars().first(curve.pillars().size() - 1))
+            check.expect_near(left_forward(curve, s), right_forward(curve, s), 1e-5,
+                              "forward continuity at " + Date(QuantLib::Date(s)).get_date_str());
+        report(check);
+    }
+
+    {
+        Checker check{"CurveBootstrapper"};
+        const QuantLib::Date spot(17, QuantLib::January, 2025);
+        CurveBootstrapper bootstrapper(reference, usd_instruments(), spot);
+
+        int notified = 0;
+        bootstrapper.subscribe([&] { ++notified; });
+
+        auto reprices = [&](const std::string& when) {
+            const YieldCurve& curve = bootstrapper.curve();
+            for (std::size_t i = 0; i < bootstrapper.size(); ++i)
+                check.expect_near(instrument_pv(bootstrapper.instrument(i), spot, curve), 0.0, 1e-13,
+                                  when + ": instrument " + std::to_string(i) + " reprices");
+        };
+        reprices("initial");
+        const std::vector<double> before(bootstrapper.curve().log_discount_factors().begin(),
+                                         bootstrapper.curve().log_discount_factors().end());
+        const std::uint64_t version = bootstrapper.version();
+
+        // Two ticks on the 5Y swap before anyone looks: one notification, one re-solve of pillars 6 onwards
+        bootstrapper.set_quote(6, 0.0391);
+        bootstrapper.set_quote(6, 0.0393);
+        check.expect(notified == 1, "one stale notification for two ticks, got " + std::to_string(notified));
+        check.expect(bootstrapper.stale(), "stale after a tick");
+        const std::uint64_t pillars_before = bootstrapper.stats().pillars_solved;
+        reprices("after ticks");
+        check.expect(bootstrapper.version() == version + 1, "one new version");
+        check.expect(bootstrapper.stats().pillars_solved - pillars_before == bootstrapper.size() - 6,
+                     "only pillars from the ticked one on are re-solved");
+
+        const auto after = bootstrapper.curve().log_discount_factors();
+        for (std::size_t i = 0; i < 6; ++i)
+            check.expect(after[i] == before[i], "pillar " + std::to_string(i) + " before the tick is unchanged");
+        check.expect(after[6] < before[6], "higher 5Y rate, lower 5Y discount factor");
+
+        // Same as bootstrapping the ticked quotes from scratch
+        std::vector<CurveInstrument> ticked = usd_instruments();
+        ticked[6].quote = 0.0393;
+        CurveBootstrapper fresh(reference, ticked, spot);
+        const auto full = fresh.curve().log_discount_factors();
+        for (std::size_t i = 0; i < full.size(); ++i)
+            check.expect_near(after[i], full[i], 1e-14, "pillar " + std::to_string(i) + " against a full bootstrap");
+
+        check.expect(bootstrapper.stats().iterations_per_pillar() < 5.0, "warm-started Newton converges quickly");
+        check.expect_throws([&] {
+            std::vector<CurveInstrument> unordered = usd_instruments();
+            std::swap(unordered[4], unordered[5]);
+            CurveBootstrapper bad(reference, unordered, spot);
+        }, "instruments out of maturity order");
+        report(check);
+    }
+
+    {
+        Checker check{"AAD tape"};
+        aad::Tape tape;
+        aad::Tape::Recording recording(tape);
+        const aad::Active x = tape.input(1.5), y = tape.input(0.25);
+        // f = x e^y + log(x) / y - sqrt(x) y + 3 / x
+        const aad::Active f = x * exp(y) + log(x) / y - sqrt(x) * y + 3.0 / x;
+        const double xv = 1.5, yv = 0.25;
+        check.expect_near(f.value(), xv * std::exp(yv) + std::log(xv) / yv - std::sqrt(xv) * yv + 3.0 / xv, 1e-15,
+                          "value");
+        tape.seed(f);
+        tape.propagate();
+        check.expect_near(x.adjoint(), std::exp(yv) + 1.0 / (xv * yv) - 0.5 * yv / std::sqrt(xv) - 3.0 / (xv * xv),
+                          1e-14, "df/dx");
+        check.expect_near(y.adjoint(), xv * std::exp(yv) - std::log(xv) / (yv * yv) - std::sqrt(xv), 1e-14, "df/dy");
+
+        // Rewinding keeps the memory, constants leave nothing on the tape
+        const std::size_t capacity = tape.capacity();
+        tape.clear();
+        const aad::Active c = aad::Active(2.0) * 3.0 + 1.0;
+        check.expect(tape.size() == 0 && c.value() == 7.0 && c.is_constant(), "constants aren't recorded");
+        check.expect(tape.capacity() == capacity, "rewind keeps the blocks");
+        report(check);
+    }
+
+    {
+        // A small book: fixed legs of different tenors, frequencies and notionals, two with the notional exchanged,
+        // one running past the last pillar
+        const auto& cal = calendar_from_string("USGS");
+        const auto& dc = accrualbasis_from_string("ACT/360");
+        std::vector<std::vector<ScheduleRow>> schedules;
+        for (const auto& [end, months] : std::vector<std::pair<const char*, int>>{
+                 {"20-03-2027", 3}, {"20-06-2035", 6}, {"20-03-2045", 12}, {"15-01-2057", 12}, {"20-09-2030", 1}})
+            schedules.push_back(make_schedule(Date("20-03-2025"), Date(end), QuantLib::Period(months, QuantLib::Months),
+                                              cal, QuantLib::ModifiedFollowing, dc));
+        std::vector<DiscountedLeg> legs;
+        for (std::size_t i = 0; i < schedules.size(); ++i)
+            legs.push_back(
+                DiscountedLeg{schedules[i], 1e6 * static_cast<double>(i + 1), 0.035 + 0.002 * i, i % 2 == 0});
+
+        for (CurveInterpolation interpolation : {CurveInterpolation::LogLinearDiscount,
+                                                 CurveInterpolation::MonotoneConvex}) {
+            Checker check{interpolation == CurveInterpolation::MonotoneConvex ? "Adjoint DV01 (monotone convex)"
+                                                                              : "Adjoint DV01 (log-linear)"};
+            const YieldCurve curve = make_curve(interpolation);
+            aad::Tape tape;
+            const PillarSensitivities adjoint = adjoint_dv01(curve, legs, tape);
+            const double pv = present_value(curve, legs);
+            check.expect_near(adjoint.pv, pv, 1e-12 * pv, "PV on the tape");
+
+            // Central differences out of the bumping reference, tiny bumps so convexity doesn't show (monotone
+            // convex curves a lot: its one-sided 1bp differences are tens of percent out on some pillars)
+            const PillarSensitivities up = bumped_dv01(curve, legs, 1e-7), down = bumped_dv01(curve, legs, -1e-7);
+            double largest = 0.0;
+            for (double d : up.dv01) largest = std::max(largest, std::abs(d));
+            check.expect(adjoint.dv01.size() == curve.pillars().size(), "one DV01 per pillar");
+            for (std::size_t k = 0; k < adjoint.dv01.size(); ++k)
+                check.expect_near(adjoint.dv01[k], 0.5 * (up.dv01[k] + down.dv01[k]), 1e-6 * largest,
+                                  "pillar " + std::to_string(k));
+
+            // On log-linear, 1bp bumps only differ by convexity, well under a percent of the largest bucket
+            const PillarSensitivities bumped = bumped_dv01(curve, legs);
+            if (interpolation == CurveInterpolation::LogLinearDiscount)
+                for (std::size_t k = 0; k < adjoint.dv01.size(); ++k)
+                    check.expect_near(adjoint.dv01[k], bumped.dv01[k], 1e-2 * largest,
+                                      "1bp bump at " + std::to_string(k));
+            check.expect(bumped.valuations == curve.pillars().size() + 1 && adjoint.valuations == 1, "valuations");
+
+            // Checkpointing: the tape holds the curve and one leg at a time, never the whole book
+            std::size_t one_leg_peak = 0;
+            for (const DiscountedLeg& leg : legs)
+                one_leg_peak = std::max(one_leg_peak, adjoint_dv01(curve, std::span(&leg, 1), tape).tape_peak);
+            check.expect(adjoint.tape_peak == one_leg_peak, "tape peak " + std::to_string(adjoint.tape_peak) +
+                                                                " against " + std::to_string(one_leg_peak));
+            report(check);
+        }
+    }
+
+    {
+        Checker check{"Invalid curves"};
+        const serial_type r = reference.serialNumber();
+        const std::vector<double> dfs = {0.99, 0.98};
+        check.expect_throws([&] { YieldCurve(reference, std::vector<serial_type>{r + 90, r + 30}, dfs); },
+                            "unsorted pillars");
+        check.expect_throws([&] { YieldCurve(reference, std::vector<serial_type>{r, r + 30}, dfs); },
+                            "pillar on the reference date");
+        check.expect_throws([&] { YieldCurve(reference, std::vector<serial_type>{r + 30, r + 90},
+                                             std::vector<double>{0.99, 0.0}); },
+                            "zero discount factor");
+        check.expect_throws([&] { YieldCurve(reference, std::vector<serial_type>{r + 30}, dfs); },
+                            "pillar and discount factor counts differ");
+        report(check);
+    }
+
+    return report.finish();
+}
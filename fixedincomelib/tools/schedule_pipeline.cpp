@@ -0,0 +1,56 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+
+#include "fixedincomelib/Date/schedulepipeline.h"
+
+// Trade file in, schedule rows out, e.g. for the overnight cashflow job
+//
+//   schedule_pipeline trades.csv schedules.csv [--threads=N] [--block=N] [--queue=N] [--skip-invalid] [--cache]
+//
+// See Date/tradefile.h for the input columns and Date/schedulepipeline.h for the output.
+
+int main(int argc, char** argv) {
+    using namespace fixedincomelib;
+
+    try {
+        std::string input, output;
+        SchedulePipelineOptions options;
+        bool use_cache = false;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if (arg.starts_with("--threads=")) options.threads = std::stoul(std::string(arg.substr(10)));
+            else if (arg.starts_with("--block=")) options.trades_per_block = std::stoul(std::string(arg.substr(8)));
+            else if (arg.starts_with("--queue=")) options.queue_blocks = std::stoul(std::string(arg.substr(8)));
+            else if (arg == "--skip-invalid") options.skip_invalid = true;
+            else if (arg == "--cache") use_cache = true;
+            else if (!arg.starts_with("--") && input.empty()) input = arg;
+            else if (!arg.starts_with("--") && output.empty()) output = arg;
+            else throw std::invalid_argument("Unexpected argument: " + std::string(arg));
+        }
+        if (input.empty() || output.empty()) {
+            std::cerr << "usage: schedule_pipeline <trades.csv> <schedules.csv> [--threads=N] [--block=N] "
+                         "[--queue=N] [--skip-invalid] [--cache]\n";
+            return 2;
+        }
+        if (use_cache) options.cache = &schedule_cache();
+
+        SchedulePipeline pipeline(options);
+        const SchedulePipelineStats stats = pipeline.run(input, output);
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "trades   " << stats.trades << " (" << stats.invalid << " invalid lines skipped)\n";
+        std::cout << "rows     " << stats.rows << "\n";
+        std::cout << "input    " << static_cast<double>(stats.input_bytes) / (1024.0 * 1024.0) << " MB\n";
+        std::cout << "output   " << static_cast<double>(stats.output_bytes) / (1024.0 * 1024.0) << " MB\n";
+        std::cout << "time     " << stats.seconds << " s\n";
+        std::cout << "rate     " << stats.trades_per_second() << " trades/s, " << stats.input_mb_per_second()
+                  << " MB/s in\n";
+        return 0;
+
+    } catch (const std::exception& ex) {
+        std::cerr << "ERROR: " << ex.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace fixedincomelib {
+
+    // Blocking FIFO with a fixed capacity, for handing work from one pipeline stage to the next
+    // push() waits while the queue is full, which is how a slow consumer slows the producer down (backpressure)
+    // instead of letting the queue grow. close() wakes everybody: pushes are then dropped, pops drain what is left
+    // and return nullopt once the queue is empty.
+    template <class T>
+    class BoundedQueue {
+        public:
+            explicit BoundedQueue(std::size_t capacity): capacity_(capacity == 0 ? 1 : capacity) {}
+
+            // Returns false (and drops the item) if the queue was closed
+            bool push(T item) {
+                std::unique_lock lock(mutex_);
+                not_full_.wait(lock, [&] { return closed_ || items_.size() < capacity_; });
+                if (closed_) return false;
+                items_.push_back(std::move(item));
+                not_empty_.notify_one();
+                return true;
+            }
+
+            // Waits for an item, nullopt once the queue is closed and empty
+            std::optional<T> pop() {
+                std::unique_lock lock(mutex_);
+                not_empty_.wait(lock, [&] { return closed_ || !items_.empty(); });
+                if (items_.empty()) return std::nullopt;
+                T item = std::move(items_.front());
+                items_.pop_front();
+                not_full_.notify_one();
+                return item;
+            }
+
+            void close() {
+                std::lock_guard lock(mutex_);
+                closed_ = true;
+                not_full_.notify_all();
+                not_empty_.notify_all();
+            }
+
+            std::size_t capacity() const { return capacity_; }
+
+        private:
+            const std::size_t capacity_;
+            std::mutex mutex_;
+            std::condition_variable not_full_, not_empty_;
+            std::deque<T> items_;
+            bool closed_ = false;
+    };
+
+}
@@ -0,0 +1,225 @@
+#include "fixedincomelib/utils/instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+namespace fixedincomelib::instrumentation {
+    namespace {
+        constexpr const char* names[probe_count] = {
+            "qfAddPeriod",
+            "qfAccrued",
+            "qfMoveToBusinessDay",
+            "qfIsBusinessDay",
+            "qfIsHoliday",
+            "qfIsEndOfMonth",
+            "qfEndOfMonth",
+            "qfMakeSchedule",
+            "stage/parse",
+            "stage/conventions",
+            "stage/quantlib",
+            "stage/format",
+            "make_schedule",
+            "currency_from_string",
+            "bdc_from_string",
+            "calendar_from_string",
+            "accrualbasis_from_string",
+            "bootstrap/resolve",
+        };
+
+        std::vector<ProbeStats> empty_totals() {
+            std::vector<ProbeStats> totals(probe_count);
+            for (std::size_t i = 0; i < probe_count; ++i) totals[i].name = names[i];
+            return totals;
+        }
+
+#if FIXEDINCOMELIB_INSTRUMENTATION
+        // Plain thread_local so operator new can bump it without running any initialisation of its own
+        thread_local std::uint64_t allocations_in_thread = 0;
+
+        // Only the owning thread writes, so a relaxed load + store is enough and avoids a locked add
+        // snapshot() reads them from other threads, hence the atomics
+        void bump(std::atomic<std::uint64_t>& counter, std::uint64_t by) {
+            counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+        }
+
+        struct Counters {
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> total_ns{0};
+            std::atomic<std::uint64_t> allocations{0};
+            std::array<std::atomic<std::uint64_t>, histogram_buckets> histogram{};
+        };
+
+        struct ThreadCounters;
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<const ThreadCounters*> live;
+            std::vector<ProbeStats> retired = empty_totals();    // threads that have exited
+            std::vector<ProbeStats> baseline = empty_totals();   // totals at the last reset()
+        };
+
+        // Never destroyed, threads still running during static destruction may exit after it would have been
+        Registry& registry() {
+            static Registry* r = new Registry();
+            return *r;
+        }
+
+        struct ThreadCounters {
+            std::array<Counters, probe_count> probes;
+
+            ThreadCounters() {
+                Registry& r = registry();
+                std::lock_guard lock(r.mutex);
+                r.live.push_back(this);
+            }
+
+            ~ThreadCounters() {
+                Registry& r = registry();
+                std::lock_guard lock(r.mutex);
+                add_to(r.retired);
+                r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+            }
+
+            void add_to(std::vector<ProbeStats>& totals) const {
+                for (std::size_t i = 0; i < probe_count; ++i) {
+                    const Counters& c = probes[i];
+                    totals[i].calls += c.calls.load(std::memory_order_relaxed);
+                    totals[i].total_ns += c.total_ns.load(std::memory_order_relaxed);
+                    totals[i].allocations += c.allocations.load(std::memory_order_relaxed);
+                    for (std::size_t b = 0; b < histogram_buckets; ++b)
+                        totals[i].histogram[b] += c.histogram[b].load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        ThreadCounters& thread_counters() {
+            thread_local ThreadCounters counters;
+            return counters;
+        }
+
+        // Everything recorded since the process started, caller holds the registry mutex
+        std::vector<ProbeStats> lifetime_totals(const Registry& r) {
+            std::vector<ProbeStats> totals = r.retired;
+            for (const ThreadCounters* t : r.live) t->add_to(totals);
+            return totals;
+        }
+#endif
+    }
+
+    const char* probe_name(Probe p) {
+        return names[static_cast<std::size_t>(p)];
+    }
+
+    double ProbeStats::mean_ns() const {
+        return calls == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(calls);
+    }
+
+    double ProbeStats::percentile_ns(double q) const {
+        if (calls == 0) return 0.0;
+        const auto target = static_cast<std::uint64_t>(std::max(1.0, std::ceil(q * static_cast<double>(calls))));
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < histogram_buckets; ++b) {
+            seen += histogram[b];
+            if (seen >= target) return std::ldexp(1.0, static_cast<int>(b));
+        }
+        return std::ldexp(1.0, static_cast<int>(histogram_buckets));
+    }
+
+#if FIXEDINCOMELIB_INSTRUMENTATION
+    void record(Probe p, std::uint64_t ns, std::uint64_t allocations) {
+        Counters& c = thread_counters().probes[static_cast<std::size_t>(p)];
+        bump(c.calls, 1);
+        bump(c.total_ns, ns);
+        bump(c.allocations, allocations);
+        bump(c.histogram[std::min<std::size_t>(std::bit_width(ns), histogram_buckets - 1)], 1);
+    }
+
+    std::uint64_t thread_allocations() {
+        return allocations_in_thread;
+    }
+
+    Snapshot snapshot() {
+        Registry& r = registry();
+        std::lock_guard lock(r.mutex);
+        Snapshot s{lifetime_totals(r)};
+        for (std::size_t i = 0; i < probe_count; ++i) {
+            ProbeStats& p = s.probes[i];
+            const ProbeStats& base = r.baseline[i];
+            p.calls -= base.calls;
+            p.total_ns -= base.total_ns;
+            p.allocations -= base.allocations;
+            for (std::size_t b = 0; b < histogram_buckets; ++b) p.histogram[b] -= base.histogram[b];
+        }
+        return s;
+    }
+
+    void reset() {
+        Registry& r = registry();
+        std::lock_guard lock(r.mutex);
+        r.baseline = lifetime_totals(r);
+    }
+#else
+    std::uint64_t thread_allocations() { return 0; }
+    Snapshot snapshot() { return Snapshot{empty_totals()}; }
+    void reset() {}
+#endif
+
+    std::string to_text(const Snapshot& s) {
+        std::ostringstream out;
+        out << std::left << std::setw(26) << "probe" << std::right << std::setw(12) << "calls" << std::setw(12)
+            << "total_ms" << std::setw(12) << "mean_ns" << std::setw(12) << "p50_ns" << std::setw(12) << "p99_ns"
+            << std::setw(14) << "allocs/call" << "\n";
+        out << std::fixed;
+        for (const ProbeStats& p : s.probes) {
+            if (p.calls == 0) continue;
+            out << std::left << std::setw(26) << p.name << std::right << std::setw(12) << p.calls
+                << std::setprecision(3) << std::setw(12) << static_cast<double>(p.total_ns) * 1e-6
+                << std::setprecision(1) << std::setw(12) << p.mean_ns() << std::setw(12) << p.percentile_ns(0.50)
+                << std::setw(12) << p.percentile_ns(0.99) << std::setprecision(2) << std::setw(14)
+                << static_cast<double>(p.allocations) / static_cast<double>(p.calls) << "\n";
+        }
+        return out.str();
+    }
+
+    std::string to_json(const Snapshot& s) {
+        std::ostringstream out;
+        out << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"probes\":[";
+        for (std::size_t i = 0; i < s.probes.size(); ++i) {
+            const ProbeStats& p = s.probes[i];
+            out << (i == 0 ? "" : ",") << "{\"name\":\"" << p.name << "\",\"calls\":" << p.calls
+                << ",\"total_ns\":" << p.total_ns << ",\"allocations\":" << p.allocations
+                << ",\"mean_ns\":" << p.mean_ns() << ",\"p50_ns\":" << p.percentile_ns(0.50)
+                << ",\"p99_ns\":" << p.percentile_ns(0.99) << ",\"histogram\":[";
+            for (std::size_t b = 0; b < histogram_buckets; ++b) out << (b == 0 ? "" : ",") << p.histogram[b];
+            out << "]}";
+        }
+        out << "]}";
+        return out.str();
+    }
+}
+
+#if FIXEDINCOMELIB_INSTRUMENTATION
+// Global operator new replacement feeding the per-thread allocation counts the probes report
+// Only compiled in with instrumentation, the benchmark harness has its own for the uninstrumented build
+namespace {
+    void* counted_alloc(std::size_t n) {
+        ++fixedincomelib::instrumentation::allocations_in_thread;
+        if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
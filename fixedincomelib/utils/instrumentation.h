@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Opt-in probes on the hot paths of the API layer: call counts, latency histograms and heap allocations per function
+// Configure with -DFIXEDINCOMELIB_INSTRUMENTATION=ON to compile them in. Without it FIXEDINCOMELIB_PROBE and
+// FIXEDINCOMELIB_STAGE expand to nothing, so the library pays nothing, and snapshot() comes back all zeros.
+//
+// Every thread records into its own counters (no locks, no shared cache lines on the hot path). snapshot() sums over
+// the threads, and reset() only moves the baseline later snapshots are taken against, so neither stalls the writers.
+//
+//   FIXEDINCOMELIB_PROBE(qfAddPeriod);      // times the enclosing scope
+//   FIXEDINCOMELIB_STAGE(parse);            // from here to the next stage (or the end of the scope) is parsing
+//   ...
+//   std::cout << instrumentation::to_text(instrumentation::snapshot());
+
+#ifndef FIXEDINCOMELIB_INSTRUMENTATION
+#define FIXEDINCOMELIB_INSTRUMENTATION 0
+#endif
+
+namespace fixedincomelib::instrumentation {
+
+    enum class Probe : std::uint8_t {
+        // qf* wrappers in apis/date.h
+        qfAddPeriod,
+        qfAccrued,
+        qfMoveToBusinessDay,
+        qfIsBusinessDay,
+        qfIsHoliday,
+        qfIsEndOfMonth,
+        qfEndOfMonth,
+        qfMakeSchedule,
+        // Where the time inside the qf* wrappers goes, summed over all of them
+        stage_parse,          // dates, tenors and output formats given as strings
+        stage_conventions,    // ConventionRegistry lookups (and construction on a miss)
+        stage_quantlib,       // calendar / day counter / schedule calls
+        stage_format,         // results back to strings
+        make_schedule,
+        // market/basics.cpp parsers, i.e. convention construction
+        currency_from_string,
+        bdc_from_string,
+        calendar_from_string,
+        accrualbasis_from_string,
+        // Model/bootstrap.h, the re-solve inside CurveBootstrapper::curve()
+        bootstrap_resolve,
+        count
+    };
+
+    inline constexpr std::size_t probe_count = static_cast<std::size_t>(Probe::count);
+
+    // Bucket b counts calls that took [2^(b-1), 2^b) ns, bucket 0 the ones under 1ns
+    inline constexpr std::size_t histogram_buckets = 64;
+
+    // "qfAddPeriod", "stage/parse", "calendar_from_string", ...
+    const char* probe_name(Probe p);
+
+    constexpr bool enabled() { return FIXEDINCOMELIB_INSTRUMENTATION != 0; }
+
+    struct ProbeStats {
+        std::string name;
+        std::uint64_t calls = 0;
+        std::uint64_t total_ns = 0;
+        std::uint64_t allocations = 0;
+        std::array<std::uint64_t, histogram_buckets> histogram{};
+
+        double mean_ns() const;
+        // Upper edge of the histogram bucket holding the q-quantile, so within a factor of 2 of the exact value
+        double percentile_ns(double q) const;
+    };
+
+    struct Snapshot {
+        std::vector<ProbeStats> probes;   // indexed by Probe
+        const ProbeStats& operator[](Probe p) const { return probes[static_cast<std::size_t>(p)]; }
+    };
+
+    // Totals since the last reset(), over live threads and the ones that have exited
+    Snapshot snapshot();
+    void reset();
+
+    // Table of the probes that were hit / one JSON object with a "probes" array
+    std::string to_text(const Snapshot& s);
+    std::string to_json(const Snapshot& s);
+
+    // Heap allocations made by the calling thread so far (counted by the operator new in instrumentation.cpp, so
+    // always 0 when instrumentation is compiled out)
+    std::uint64_t thread_allocations();
+
+#if FIXEDINCOMELIB_INSTRUMENTATION
+    void record(Probe p, std::uint64_t ns, std::uint64_t allocations);
+
+    inline std::uint64_t now_ns() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Records the enclosing scope under its probe, and optionally splits it into consecutive stages
+    class ScopedProbe {
+        public:
+            explicit ScopedProbe(Probe probe)
+                : probe_(probe), start_ns_(now_ns()), start_allocations_(thread_allocations()) {}
+
+            ~ScopedProbe() {
+                const std::uint64_t t = now_ns(), a = thread_allocations();
+                close_stage(t, a);
+                record(probe_, t - start_ns_, a - start_allocations_);
+            }
+
+            ScopedProbe(const ScopedProbe&) = delete;
+            ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+            // Ends the current stage (if any) and starts the next one
+            void stage(Probe next) {
+                const std::uint64_t t = now_ns(), a = thread_allocations();
+                close_stage(t, a);
+                stage_ = next;
+                stage_ns_ = t;
+                stage_allocations_ = a;
+            }
+
+        private:
+            void close_stage(std::uint64_t t, std::uint64_t a) {
+                if (stage_ != Probe::count) record(stage_, t - stage_ns_, a - stage_allocations_);
+            }
+
+            Probe probe_;
+            std::uint64_t start_ns_, start_allocations_;
+            Probe stage_ = Probe::count;
+            std::uint64_t stage_ns_ = 0, stage_allocations_ = 0;
+    };
+#endif
+}
+
+#if FIXEDINCOMELIB_INSTRUMENTATION
+#define FIXEDINCOMELIB_PROBE(name) \
+    ::fixedincomelib::instrumentation::ScopedProbe fixedincomelib_probe_(::fixedincomelib::instrumentation::Probe::name)
+#define FIXEDINCOMELIB_STAGE(name) \
+    fixedincomelib_probe_.stage(::fixedincomelib::instrumentation::Probe::stage_##name)
+#else
+#define FIXEDINCOMELIB_PROBE(name) static_cast<void>(0)
+#define FIXEDINCOMELIB_STAGE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,129 @@
+#include "fixedincomelib/utils/mappedfile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace fixedincomelib {
+
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& path) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Cannot open " + path);
+        file_ = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            unmap();
+            throw std::runtime_error("Cannot read the size of " + path);
+        }
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        if (size_ == 0) return;   // nothing to map, a zero-length mapping is an error on Windows
+
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            unmap();
+            throw std::runtime_error("Cannot map " + path);
+        }
+        data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr) {
+            unmap();
+            throw std::runtime_error("Cannot map " + path);
+        }
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+        if (file_) CloseHandle(static_cast<HANDLE>(file_));
+        data_ = nullptr;
+        mapping_ = file_ = nullptr;
+        size_ = 0;
+    }
+
+    // Windows has no "drop these clean pages" hint for a file view, the working set trimmer takes care of them
+    void MappedFile::release(std::size_t, std::size_t) {}
+#else
+    MappedFile::MappedFile(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            const int err = errno;
+            unmap();
+            throw std::runtime_error("Cannot read the size of " + path + ": " + std::strerror(err));
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ == 0) return;   // mmap rejects a zero length
+
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) {
+            const int err = errno;
+            unmap();
+            throw std::runtime_error("Cannot map " + path + ": " + std::strerror(err));
+        }
+        data_ = static_cast<const char*>(p);
+        // Readers go front to back, so ask for aggressive read-ahead
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+        data_ = nullptr;
+        fd_ = -1;
+        size_ = 0;
+    }
+
+    void MappedFile::release(std::size_t begin, std::size_t end) {
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        end = std::min(end, size_);
+        // Round inwards to whole pages, a page straddling the range may still be in use on the other side
+        const std::size_t first = (begin + page - 1) / page * page;
+        const std::size_t last = end / page * page;
+        if (data_ && first < last)
+            ::madvise(const_cast<char*>(data_) + first, last - first, MADV_DONTNEED);
+    }
+#endif
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+#ifdef _WIN32
+            std::swap(file_, other.file_);
+            std::swap(mapping_, other.mapping_);
+#else
+            std::swap(fd_, other.fd_);
+#endif
+        }
+        return *this;
+    }
+}
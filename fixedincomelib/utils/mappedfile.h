@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace fixedincomelib {
+
+    // Read-only memory map of a whole file (mmap on POSIX, a file mapping view on Windows)
+    // The pages are only read in as they are touched, so parsing a multi-GB file through view() costs address space
+    // rather than memory, and release() lets the OS drop what a sequential reader has already gone past.
+    class MappedFile {
+        public:
+            // Throws std::runtime_error if the file can't be opened or mapped
+            explicit MappedFile(const std::string& path);
+            ~MappedFile();
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const char* data() const { return data_; }
+            std::size_t size() const { return size_; }
+            std::string_view view() const { return {data_, size_}; }
+
+            // Tells the OS that bytes [begin, end) won't be read again, so their pages can leave the process' resident
+            // set (only whole pages inside the range are dropped). Views into the range stay valid, reading them just
+            // faults the pages back in. A no-op where the platform has no such hint.
+            void release(std::size_t begin, std::size_t end);
+
+        private:
+            void unmap() noexcept;
+
+            const char* data_ = nullptr;
+            std::size_t size_ = 0;
+#ifdef _WIN32
+            void* file_ = nullptr;      // HANDLE
+            void* mapping_ = nullptr;   // HANDLE
+#else
+            int fd_ = -1;
+#endif
+    };
+
+}
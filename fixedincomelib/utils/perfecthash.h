@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace fixedincomelib {
+
+    constexpr char ascii_upper(char c) {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    constexpr bool iequals_ascii(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (ascii_upper(a[i]) != ascii_upper(b[i])) return false;
+        return true;
+    }
+
+    // FNV-1a over the uppercased bytes, so 'usgs' and 'USGS' hash the same
+    constexpr std::uint32_t folded_hash(std::string_view s, std::uint32_t seed) {
+        std::uint32_t h = 2166136261u ^ seed;
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(ascii_upper(c));
+            h *= 16777619u;
+        }
+        return h ^ (h >> 16);
+    }
+
+    // Fixed set of ASCII codes mapped to IDs through a perfect hash found at compile time
+    // The constructor searches for a seed that puts every code in its own slot of a power-of-two table, so find() is
+    // one hash over the input, one slot and one case-insensitive compare: no allocation, no probing and no loop over
+    // the codes. A set of codes no seed separates is a compile error (the consteval constructor throws).
+    template <class Id, std::size_t N>
+    class PerfectHashTable {
+        public:
+            using Entry = std::pair<std::string_view, Id>;
+
+            // Four slots a code keeps the seed search short, the tables stay well under a few hundred bytes
+            static constexpr std::size_t slot_count = std::bit_ceil(N * 4);
+
+            consteval explicit PerfectHashTable(const std::array<Entry, N>& entries) {
+                for (std::uint32_t seed = 0; seed < 1u << 16; ++seed) {
+                    std::array<bool, slot_count> taken{};
+                    bool separated = true;
+                    for (const Entry& e : entries) {
+                        bool& t = taken[folded_hash(e.first, seed) & (slot_count - 1)];
+                        separated = separated && !t;
+                        t = true;
+                    }
+                    if (!separated) continue;
+
+                    seed_ = seed;
+                    for (const Entry& e : entries) {
+                        Slot& slot = slots_[folded_hash(e.first, seed) & (slot_count - 1)];
+                        slot.code = e.first;
+                        slot.id = e.second;
+                    }
+                    return;
+                }
+                throw std::logic_error("No perfect hash seed for this set of codes");
+            }
+
+            constexpr std::optional<Id> find(std::string_view s) const {
+                const Slot& slot = slots_[folded_hash(s, seed_) & (slot_count - 1)];
+                // Empty slots have an empty code, which no lookup of a non-empty string can match
+                if (!s.empty() && iequals_ascii(slot.code, s)) return slot.id;
+                return std::nullopt;
+            }
+
+        private:
+            struct Slot {
+                std::string_view code;
+                Id id{};
+            };
+
+            std::uint32_t seed_ = 0;
+            std::array<Slot, slot_count> slots_{};
+    };
+
+}
@@ -0,0 +1,46 @@
+#include "fixedincomelib/utils/tape.h"
+
+namespace fixedincomelib::aad {
+
+    Tape::Recording::Recording(Tape& tape) : previous_(tape_detail::current) {
+        tape_detail::current = &tape;
+    }
+
+    Tape::Recording::~Recording() {
+        tape_detail::current = previous_;
+    }
+
+    Active Tape::input(double value) {
+        return Active(value, push(0));
+    }
+
+    void Tape::rewind(Mark mark) {
+        if (mark > size_) throw std::invalid_argument("aad::Tape: rewinding past the end of the tape");
+        size_ = mark;
+    }
+
+    void Tape::seed(const Active& output, double weight) {
+        if (output.node()) output.node()->adjoint += weight;
+    }
+
+    void Tape::propagate(Mark to) {
+        if (to > size_) throw std::invalid_argument("aad::Tape: propagating to past the end of the tape");
+        for (std::size_t i = size_; i-- > to;) {
+            const Node& n = at(i);
+            const double a = n.adjoint;
+            if (a == 0.0) continue;
+            for (std::uint32_t j = 0; j < n.arg_count; ++j)
+                n.arg[j]->adjoint += n.partial[j] * a;
+        }
+    }
+
+    void Tape::reset_adjoints() {
+        for (std::size_t i = 0; i < size_; ++i)
+            at(i).adjoint = 0.0;
+    }
+
+    void Tape::grow() {
+        blocks_.push_back(std::make_unique_for_overwrite<Node[]>(block_size));
+    }
+
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Reverse-mode automatic differentiation on a tape
+// Arithmetic on Active numbers records one node per operation on the tape of the current thread (set with
+// Tape::Recording): the operation's partial derivatives with respect to its (at most two) arguments. A backward sweep
+// then pushes adjoints from the outputs to the inputs, so the gradient of one output with respect to every input
+// costs a small constant multiple of the function itself, however many inputs there are.
+//
+// Nodes live in fixed-size blocks that are never freed or moved while the tape lives, so recording doesn't go through
+// the allocator once the tape has grown to its working size, and rewinding just moves the end back.
+//
+// Checkpointing, for a portfolio on a shared curve:
+//   record the curve from its inputs, mark = tape.mark()
+//   per trade: record its PV, seed its adjoint, propagate(mark), rewind(mark)
+//   propagate(0) once at the end, then read the inputs' adjoints
+// The curve's nodes collect every trade's adjoints, and the tape never holds more than the curve and one trade.
+//
+//   aad::Tape tape;
+//   aad::Tape::Recording recording(tape);
+//   aad::Active x = tape.input(2.0);
+//   aad::Active y = x * exp(x);
+//   tape.seed(y);
+//   tape.propagate();
+//   x.adjoint();   // (1 + x) e^x
+
+namespace fixedincomelib::aad {
+
+    struct Node {
+        double adjoint;
+        std::uint32_t arg_count;
+        double partial[2];
+        Node* arg[2];
+    };
+
+    class Active;
+
+    class Tape {
+        public:
+            using Mark = std::size_t;
+
+            Tape() = default;
+            Tape(const Tape&) = delete;
+            Tape& operator=(const Tape&) = delete;
+
+            // Makes a tape the current thread's for as long as the guard lives (restoring the previous one after)
+            class Recording {
+                public:
+                    explicit Recording(Tape& tape);
+                    ~Recording();
+                    Recording(const Recording&) = delete;
+                    Recording& operator=(const Recording&) = delete;
+
+                private:
+                    Tape* previous_;
+            };
+
+            // Tape recording on this thread, nullptr if none
+            static Tape* current();
+
+            // A new independent variable, on this tape whether it's the current one or not
+            Active input(double value);
+
+            Mark mark() const { return size_; }
+            std::size_t size() const { return size_; }
+            std::size_t capacity() const { return blocks_.size() * block_size; }
+
+            // Drops the nodes recorded after the mark, keeping their memory
+            void rewind(Mark mark);
+            void clear() { rewind(0); }
+
+            // Adds 1 (or weight) to an output's adjoint; constants have no node and are ignored
+            void seed(const Active& output, double weight = 1.0);
+
+            // Backward sweep over the nodes recorded after `to`, last first. Adjoints accumulate, so several sweeps
+            // over disjoint parts of the tape (see checkpointing above) add up.
+            void propagate(Mark to = 0);
+
+            // Zeroes every adjoint on the tape
+            void reset_adjoints();
+
+            // Appends a node, for Active's operators
+            Node* push(std::uint32_t arg_count) {
+                if (size_ == capacity()) grow();
+                Node* n = &blocks_[size_ >> block_shift][size_ & (block_size - 1)];
+                ++size_;
+                n->adjoint = 0.0;
+                n->arg_count = arg_count;
+                return n;
+            }
+
+        private:
+            static constexpr std::size_t block_shift = 14;
+            static constexpr std::size_t block_size = std::size_t{1} << block_shift;
+
+            Node& at(std::size_t i) { return blocks_[i >> block_shift][i & (block_size - 1)]; }
+            void grow();
+
+            std::vector<std::unique_ptr<Node[]>> blocks_;
+            std::size_t size_ = 0;
+    };
+
+    namespace tape_detail {
+        inline thread_local Tape* current = nullptr;
+
+        inline Tape& recording() {
+            if (!current) throw std::logic_error("aad: arithmetic on an active number with no tape recording");
+            return *current;
+        }
+    }
+
+    inline Tape* Tape::current() { return tape_detail::current; }
+
+    // A double with a node on the tape, or a constant (no node) when built from a plain double
+    class Active {
+        public:
+            Active(double value = 0.0) : value_(value) {}
+            Active(double value, Node* node) : value_(value), node_(node) {}
+
+            double value() const { return value_; }
+            Node* node() const { return node_; }
+            bool is_constant() const { return node_ == nullptr; }
+            // After a backward sweep, d output / d this; 0 for constants
+            double adjoint() const { return node_ ? node_->adjoint : 0.0; }
+
+            Active& operator+=(const Active& b);
+            Active& operator-=(const Active& b);
+            Active& operator*=(const Active& b);
+            Active& operator/=(const Active& b);
+
+        private:
+            double value_;
+            Node* node_ = nullptr;
+    };
+
+    inline double value(const Active& a) { return a.value(); }
+
+    namespace tape_detail {
+        // Result of an operation with partials da, db to its arguments, constants don't get an edge
+        inline Active record(double v, const Active& a, double da) {
+            if (a.is_constant()) return Active(v);
+            Node* n = recording().push(1);
+            n->partial[0] = da;
+            n->arg[0] = a.node();
+            return Active(v, n);
+        }
+
+        inline Active record(double v, const Active& a, double da, const Active& b, double db) {
+            if (a.is_constant()) return record(v, b, db);
+            if (b.is_constant()) return record(v, a, da);
+            Node* n = recording().push(2);
+            n->partial[0] = da;
+            n->arg[0] = a.node();
+            n->partial[1] = db;
+            n->arg[1] = b.node();
+            return Active(v, n);
+        }
+    }
+
+    inline Active operator+(const Active& a, const Active& b) {
+        return tape_detail::record(a.value() + b.value(), a, 1.0, b, 1.0);
+    }
+    inline Active operator-(const Active& a, const Active& b) {
+        return tape_detail::record(a.value() - b.value(), a, 1.0, b, -1.0);
+    }
+    inline Active operator*(const Active& a, const Active& b) {
+        return tape_detail::record(a.value() * b.value(), a, b.value(), b, a.value());
+    }
+    inline Active operator/(const Active& a, const Active& b) {
+        const double inv = 1.0 / b.value();
+        const double q = a.value() * inv;
+        return tape_detail::record(q, a, inv, b, -q * inv);
+    }
+    inline Active operator-(const Active& a) { return tape_detail::record(-a.value(), a, -1.0); }
+
+    // With a plain double on one side, one edge and no conversion through a constant Active
+    inline Active operator+(const Active& a, double b) { return tape_detail::record(a.value() + b, a, 1.0); }
+    inline Active operator+(double a, const Active& b) { return tape_detail::record(a + b.value(), b, 1.0); }
+    inline Active operator-(const Active& a, double b) { return tape_detail::record(a.value() - b, a, 1.0); }
+    inline Active operator-(double a, const Active& b) { return tape_detail::record(a - b.value(), b, -1.0); }
+    inline Active operator*(const Active& a, double b) { return tape_detail::record(a.value() * b, a, b); }
+    inline Active operator*(double a, const Active& b) { return tape_detail::record(a * b.value(), b, a); }
+    inline Active operator/(const Active& a, double b) { return tape_detail::record(a.value() / b, a, 1.0 / b); }
+    inline Active operator/(double a, const Active& b) {
+        const double inv = 1.0 / b.value();
+        return tape_detail::record(a * inv, b, -a * inv * inv);
+    }
+
+    inline Active& Active::operator+=(const Active& b) { return *this = *this + b; }
+    inline Active& Active::operator-=(const Active& b) { return *this = *this - b; }
+    inline Active& Active::operator*=(const Active& b) { return *this = *this * b; }
+    inline Active& Active::operator/=(const Active& b) { return *this = *this / b; }
+
+    inline Active exp(const Active& a) {
+        const double e = std::exp(a.value());
+        return tape_detail::record(e, a, e);
+    }
+    inline Active log(const Active& a) { return tape_detail::record(std::log(a.value()), a, 1.0 / a.value()); }
+    inline Active sqrt(const Active& a) {
+        const double s = std::sqrt(a.value());
+        return tape_detail::record(s, a, 0.5 / s);
+    }
+
+}
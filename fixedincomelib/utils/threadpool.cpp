@@ -0,0 +1,120 @@
+#include "fixedincomelib/utils/threadpool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace fixedincomelib {
+    namespace {
+        // The pool whose worker_loop the current thread is running, if any
+        thread_local const ThreadPool* current_pool = nullptr;
+    }
+
+    ThreadPool::ThreadPool(unsigned threads) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        queues_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& w : workers_)
+            w.join();
+    }
+
+    void ThreadPool::parallel_for(std::size_t n, std::size_t grain, const Body& body) {
+        if (current_pool == this)
+            throw std::logic_error("ThreadPool::parallel_for called from one of the pool's own workers");
+        if (n == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+
+        std::lock_guard submit(submit_mutex_);
+
+        // Deal the chunks out in contiguous runs, worker w gets roughly [w * n / size, (w + 1) * n / size)
+        const std::size_t chunks = (n + grain - 1) / grain;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const std::size_t owner = c * queues_.size() / chunks;
+            std::lock_guard lock(queues_[owner]->mutex);
+            queues_[owner]->tasks.emplace_back(c * grain, std::min(n, (c + 1) * grain));
+        }
+
+        std::unique_lock lock(mutex_);
+        body_ = &body;
+        error_ = nullptr;
+        busy_ = workers_.size();
+        ++generation_;
+        wake_.notify_all();
+
+        // Wait for every worker to leave this generation, not just for the chunks to finish, so none of them can
+        // still be looking at body_ when we return
+        done_.wait(lock, [this] { return busy_ == 0; });
+        body_ = nullptr;
+
+        if (error_) {
+            std::exception_ptr e = error_;
+            error_ = nullptr;
+            lock.unlock();
+            std::rethrow_exception(e);
+        }
+    }
+
+    bool ThreadPool::pop(unsigned id, Range& task) {
+        Queue& q = *queues_[id];
+        std::lock_guard lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        return true;
+    }
+
+    bool ThreadPool::steal(unsigned id, Range& task) {
+        // Start with our right-hand neighbour so thieves spread out over the victims
+        for (std::size_t k = 1; k < queues_.size(); ++k) {
+            Queue& q = *queues_[(id + k) % queues_.size()];
+            std::lock_guard lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = q.tasks.back();
+            q.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void ThreadPool::worker_loop(unsigned id) {
+        current_pool = this;
+        std::size_t seen = 0;
+        for (;;) {
+            const Body* body = nullptr;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                body = body_;
+            }
+
+            // All chunks are queued before the generation starts, so once neither our queue nor anybody else's has
+            // work left there is nothing more for us to do in this generation
+            Range task;
+            while (pop(id, task) || steal(id, task)) {
+                try {
+                    (*body)(task.first, task.second, id);
+                } catch (...) {
+                    std::lock_guard lock(mutex_);
+                    if (!error_) error_ = std::current_exception();
+                }
+            }
+
+            std::lock_guard lock(mutex_);
+            if (--busy_ == 0)
+                done_.notify_all();
+        }
+    }
+}
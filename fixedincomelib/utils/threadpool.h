@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fixedincomelib {
+
+    // Fixed-size pool of worker threads with per-worker task queues and work stealing
+    // parallel_for cuts [0, n) into chunks of `grain` items and deals them out to the workers in contiguous runs (so
+    // each worker starts on neighbouring items). A worker that runs out takes chunks from the back of another
+    // worker's queue, which keeps every core busy when item costs vary a lot (e.g. 2Y vs 50Y swaps).
+    //
+    // The body gets the index of the worker running it, so callers can keep per-worker state without locking.
+    class ThreadPool {
+        public:
+            using Body = std::function<void(std::size_t begin, std::size_t end, unsigned worker)>;
+
+            // threads = 0 uses one worker per hardware thread
+            explicit ThreadPool(unsigned threads = 0);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+            // Blocks until every chunk has run, then rethrows the first exception a chunk threw (if any)
+            // Calls from several threads are serialised, one parallel_for runs at a time. A call from one of this
+            // pool's own workers (a body starting a nested parallel_for) would wait on itself forever, so it throws
+            // std::logic_error instead.
+            void parallel_for(std::size_t n, std::size_t grain, const Body& body);
+
+        private:
+            using Range = std::pair<std::size_t, std::size_t>;
+
+            struct Queue {
+                std::mutex mutex;
+                std::deque<Range> tasks;
+            };
+
+            void worker_loop(unsigned id);
+            bool pop(unsigned id, Range& task);    // front of our own queue
+            bool steal(unsigned id, Range& task);  // back of someone else's
+
+            std::vector<std::unique_ptr<Queue>> queues_;
+            std::vector<std::thread> workers_;
+
+            std::mutex submit_mutex_;              // one parallel_for at a time
+            std::mutex mutex_;                     // guards everything below
+            std::condition_variable wake_;
+            std::condition_variable done_;
+            const Body* body_ = nullptr;
+            std::size_t generation_ = 0;
+            std::size_t busy_ = 0;                 // workers still inside the current generation
+            std::exception_ptr error_;
+            bool stop_ = false;
+    };
+
+}